@@ -36,6 +36,31 @@ static bool getSkipCheckAdmin(Command command)
     case LIST_UPATH_COMMAND:
     case ANALYZE_COMMAND:
     case GET_DEFAULT_STATE_COMMAND:
+    case BOARD_COMMAND:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* These commands are executed by the server which authorizes the administrator group itself */
+static bool isServerCommand(Command command, bool force)
+{
+    switch (command) {
+    case REBOOT_COMMAND:
+    case POWEROFF_COMMAND:
+    case HALT_COMMAND:
+    case KEXEC_COMMAND:
+        /* Forcing, the client reboots the system itself */
+        return !force;
+    case STOP_COMMAND:
+    case START_COMMAND:
+    case RESTART_COMMAND:
+    case DISABLE_COMMAND:
+    case ENABLE_COMMAND:
+    case RE_ENABLE_COMMAND:
+    case SET_DEFAULT_STATE_COMMAND:
+    case SESSION_COMMAND:
         return true;
     default:
         return false;
@@ -50,12 +75,12 @@ static void showUsage()
             !USER_INSTANCE ? "system" : "user");
     fprintf(stdout,
             WHITE_UNDERLINE_COLOR"COMMAND\n"DEFAULT_COLOR
-            "enable             Enable the unit\n"
-            "re-enable          Re-enable the unit\n"
+            "enable             Enable the unit(s)\n"
+            "re-enable          Re-enable the unit(s)\n"
             "disable            Disable the unit\n"
-            "restart            Restart the unit\n"
-            "start              Start the unit\n"
-            "stop               Stop the unit\n"
+            "restart            Restart the unit(s)\n"
+            "start              Start the unit(s)\n"
+            "stop               Stop the unit(s)\n"
             "status             Get the unit status\n"
             "list-requires      List the unit dependencies\n"
             "list-conflicts     List the unit conflicts\n"
@@ -73,6 +98,8 @@ static void showUsage()
             "list-restarted     List the restarted units\n"
             "list-timers        List the timers\n"
             "list-paths         List the path units\n"
+            "session            Send the commands read from stdin over a single connection\n"
+            "board              Show the units status reading the status board\n"
     );
     fprintf(stdout,
             "analyze            Analyze the %s boot process\n",
@@ -121,6 +148,7 @@ int main(int argc, char **argv)
     Command command = NO_COMMAND;
     const char *commandName = NULL, *arg = NULL;
     SockMessageOut *sockMessageOut = NULL;
+    Array *unitNames = NULL;
     const struct option longopts[] = { { "help", no_argument, NULL, 'h' },
                                        { "run", optional_argument, NULL, 'r' },
                                        { "no-wtmp", optional_argument, NULL, 'n' },
@@ -201,7 +229,9 @@ int main(int argc, char **argv)
         else
             skipCheckAdmin = getSkipCheckAdmin(command);
 
-        if (userId != 0 && !skipCheckAdmin) {
+        /* The members of the administrator group don't need to be authenticated */
+        if (userId != 0 && !skipCheckAdmin &&
+            !(isServerCommand(command, force) && isAdministrator(userId, getgid()))) {
             rv = checkAdministrator(argv);
             goto out;
         }
@@ -211,6 +241,28 @@ int main(int argc, char **argv)
         if ((rv = setUserData(userId, &userInfo)) != 0)
             goto out;
     }
+    /* More units (batch request) */
+    if (argc - optind > 2) {
+        switch (command) {
+        case START_COMMAND:
+        case RESTART_COMMAND:
+        case STOP_COMMAND:
+        case ENABLE_COMMAND:
+        case RE_ENABLE_COMMAND:
+            if (command == STOP_COMMAND && (force || run || reset)) {
+                showUsage();
+                rv = 1;
+                goto out;
+            }
+            unitNames = arrayNew(objectRelease);
+            for (int i = optind + 1; i < argc; i++)
+                arrayAdd(unitNames, stringNew(argv[i]));
+            rv = showBatchData(command, &sockMessageOut, unitNames, force, run, reset);
+            goto out;
+        default:
+            break;
+        }
+    }
     switch (command) {
     case NO_COMMAND:
         if (argc > 4 || (argc > 1 && !DEBUG && !onlyWtmp && !USER_INSTANCE)) {
@@ -360,9 +412,26 @@ int main(int argc, char **argv)
         }
         rv = catEditUnit(command, arg);
         break;
+    case SESSION_COMMAND:
+        if (argc > 4 || (argc > 2 && !DEBUG && !USER_INSTANCE)) {
+            showUsage();
+            rv = 1;
+            goto out;
+        }
+        rv = showSession();
+        break;
+    case BOARD_COMMAND:
+        if (argc > 4 || (argc > 2 && !DEBUG && !USER_INSTANCE)) {
+            showUsage();
+            rv = 1;
+            goto out;
+        }
+        rv = showUnitsBoard();
+        break;
     }
 
 out:
+    arrayRelease(&unitNames);
     userDataRelease();
 
     return rv;
@@ -133,31 +133,18 @@ int main(int argc, char **argv) {
         /* Welcome msg */
         logInfo(CONSOLE, "%sWelcome to %s!%s\n", WHITE_COLOR, OS_NAME, DEFAULT_COLOR);
         /* Detecting virtualization environment */
-        Array *envVars = arrayNew(objectRelease);
-        addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-        arrayAdd(envVars, NULL);
-        rv = execUScript(&envVars, "virtualization");
-        arrayRelease(&envVars);
-        if (rv == 0 || rv == 1) {
-            if (rv == 1)
-                addEnvVar(&UNITD_ENV_VARS, "VIRTUALIZATION", "1");
-            addEnvVar(&UNITD_ENV_VARS, "PATH", PATH_ENV_VAR);
-            addEnvVar(&UNITD_ENV_VARS, "UNITS_PATH", UNITS_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "UNITS_USER_PATH", UNITS_USER_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "UNITS_ENAB_PATH", UNITS_ENAB_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "UNITD_DATA_PATH", UNITD_DATA_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "UNITD_CONF_PATH", UNITD_CONF_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "UNITD_TIMER_DATA_PATH", UNITD_TIMER_DATA_PATH);
-            addEnvVar(&UNITD_ENV_VARS, "OUR_UTMP_FILE", OUR_UTMP_FILE);
-            addEnvVar(&UNITD_ENV_VARS, "OUR_WTMP_FILE", OUR_WTMP_FILE);
-            arrayAdd(UNITD_ENV_VARS, NULL);
-        }
-        else {
-            logError(ALL, "src/bin/unitd/main.c", "main", rv,
-                          strerror(rv), "An error has occurred in virtualization.sh");
-            showEmergencyShell = hasError = true;
-            goto out;
-        }
+        if (isVirtualization())
+            addEnvVar(&UNITD_ENV_VARS, "VIRTUALIZATION", "1");
+        addEnvVar(&UNITD_ENV_VARS, "PATH", PATH_ENV_VAR);
+        addEnvVar(&UNITD_ENV_VARS, "UNITS_PATH", UNITS_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "UNITS_USER_PATH", UNITS_USER_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "UNITS_ENAB_PATH", UNITS_ENAB_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "UNITD_DATA_PATH", UNITD_DATA_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "UNITD_CONF_PATH", UNITD_CONF_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "UNITD_TIMER_DATA_PATH", UNITD_TIMER_DATA_PATH);
+        addEnvVar(&UNITD_ENV_VARS, "OUR_UTMP_FILE", OUR_UTMP_FILE);
+        addEnvVar(&UNITD_ENV_VARS, "OUR_WTMP_FILE", OUR_WTMP_FILE);
+        arrayAdd(UNITD_ENV_VARS, NULL);
     }
     else {
         struct passwd *userInfo = NULL;
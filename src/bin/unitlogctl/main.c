@@ -27,6 +27,14 @@ static void showUsage()
         WHITE_UNDERLINE_COLOR"\nOPTIONS\n"DEFAULT_COLOR
         "-f, --follow       Follow the log\n"
         "-p, --pager        Enable the pager\n"
+        "-S, --since=time   Show the log lines since the time\n"
+        "-U, --until=time   Show the log lines until the time\n"
+        "                   The time can be 'now', relative (-30s, -10m, -2h, -1d),\n"
+        "                   'dd-mm-yyyy [HH:MM[:SS]]' or 'HH:MM[:SS]' (today)\n"
+        "-P, --priority=pri Show the log lines up to the priority or in the range (crit..warn)\n"
+        "-F, --facility=fac Show the log lines of the facilities (daemon,auth)\n"
+        "-I, --ident=ident  Show the log lines of the ident (program name)\n"
+        "-n, --pid=pid      Show the log lines of the pid\n"
         "-d, --debug        Enable the debug\n"
         "-v, --version      Show the version\n"
         "-h, --help         Show usage\n\n"
@@ -36,12 +44,15 @@ static void showUsage()
 
 int main(int argc, char **argv)
 {
-    int c = 0, rv = 0, userId = -1;
-    const char *shortopts = "fphdv", *commandName = NULL, *arg = NULL;
+    int c = 0, rv = 0, userId = -1, filterArgs = 0;
+    const char *shortopts = "fphdvS:U:P:F:I:n:", *commandName = NULL, *arg = NULL;
     const struct option longopts[] = {
         { "follow", optional_argument, NULL, 'f' },  { "pager", optional_argument, NULL, 'p' },
         { "help", no_argument, NULL, 'h' },          { "debug", optional_argument, NULL, 'd' },
-        { "version", optional_argument, NULL, 'v' }, { 0, 0, 0, 0 }
+        { "version", optional_argument, NULL, 'v' }, { "since", required_argument, NULL, 'S' },
+        { "until", required_argument, NULL, 'U' },   { "priority", required_argument, NULL, 'P' },
+        { "facility", required_argument, NULL, 'F' }, { "ident", required_argument, NULL, 'I' },
+        { "pid", required_argument, NULL, 'n' },     { 0, 0, 0, 0 }
     };
     UlCommand ulCommand = NO_UL_COMMAND;
     bool pager = false, follow = false;
@@ -57,6 +68,17 @@ int main(int argc, char **argv)
         case 'd':
             DEBUG = true;
             break;
+        case 'S':
+        case 'U':
+        case 'P':
+        case 'F':
+        case 'I':
+        case 'n':
+            if ((rv = setLogFilter(c, optarg)) != 0)
+                goto out;
+            /* The option and its value could be separate arguments */
+            filterArgs += optarg == argv[optind - 1] ? 2 : 1;
+            break;
         case 'h':
             showUsage();
             rv = 0;
@@ -83,6 +105,16 @@ int main(int argc, char **argv)
     }
     if (ulCommand == NO_UL_COMMAND)
         ulCommand = SHOW_LOG;
+    /* The filters only work with the show commands, the follow mode has not an until time */
+    if (filterArgs > 0) {
+        if ((follow && LOG_FILTER.until > 0) ||
+            (ulCommand != SHOW_LOG && ulCommand != SHOW_BOOT && ulCommand != SHOW_CURRENT)) {
+            showUsage();
+            rv = 1;
+            goto out;
+        }
+        argc -= filterArgs;
+    }
     userId = getuid();
     if (userId != 0) {
         if (!getSkipCheckAdmin(ulCommand)) {
@@ -113,7 +145,8 @@ int main(int argc, char **argv)
             rv = 1;
             goto out;
         }
-        arg = argv[argc - 1];
+        /* The arguments follow the options (getopt permutes them) */
+        arg = argv[optind + 1];
         rv = showBoot(pager, follow, arg);
         break;
     case INDEX_REPAIR:
@@ -141,7 +174,7 @@ int main(int argc, char **argv)
             rv = 1;
             goto out;
         }
-        printLogSizeInfo(-1, -1, getFileSize(UNITLOGD_LOG_PATH));
+        printLogSizeInfo(-1, -1, getLogSize());
         break;
     case SHOW_CURRENT:
         if (argc < 2 || argc > 5 || (argc > 2 && !DEBUG && !pager && !follow)) {
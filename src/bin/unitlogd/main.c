@@ -27,6 +27,8 @@ static void usage()
             WHITE_UNDERLINE_COLOR"OPTIONS\n"DEFAULT_COLOR
             "-l, --log          Log the system messages\n"
             "-k, --kernel       Enable the kernel messages forward\n"
+            "-f, --flush=ms     Collect the log lines for 'ms' milliseconds before writing them\n"
+            "-s, --sync=policy  Sync the log file 'never', on 'error' (default) or 'always'\n"
             "-d, --debug        Enable the debug\n"
             "-v, --version      Show the version\n"
             "-h, --help         Show usage\n\n"
@@ -66,12 +68,13 @@ static int createResources()
 
 int main(int argc, char **argv)
 {
-    int c = 0, rv = 0, input = 0;
-    const char *shortopts = "lkhdv";
+    int c = 0, rv = 0, input = 0, sync = -1;
+    const char *shortopts = "lkf:s:hdv";
     bool log = false, kernel = false;
     Array *socketThreads = arrayNew(socketThreadRelease);
     const struct option longopts[] = {
         { "log", no_argument, NULL, 'l' },         { "kernel", no_argument, NULL, 'k' },
+        { "flush", required_argument, NULL, 'f' }, { "sync", required_argument, NULL, 's' },
         { "debug", optional_argument, NULL, 'd' }, { "version", no_argument, NULL, 'v' },
         { "help", no_argument, NULL, 'h' },        { 0, 0, 0, 0 }
     };
@@ -84,6 +87,22 @@ int main(int argc, char **argv)
         case 'k':
             kernel = true;
             break;
+        case 'f':
+            if (!isValidNumber(optarg, false)) {
+                usage();
+                rv = 1;
+                goto out;
+            }
+            WRITER_FLUSH_INTERVAL = atoi(optarg);
+            break;
+        case 's':
+            if ((sync = getWriterSync(optarg)) == -1) {
+                usage();
+                rv = 1;
+                goto out;
+            }
+            WRITER_SYNC = sync;
+            break;
         case 'd':
             DEBUG = true;
             break;
@@ -166,6 +185,7 @@ out:
     close(SELF_PIPE[0]);
     close(SELF_PIPE[1]);
     objectRelease(&BOOT_ID_STR);
+    objectRelease(&SEGMENT_PATH);
     arrayRelease(&socketThreads);
     if (DEBUG)
         logInfo(CONSOLE, "Unitlogd exited with rv = %d.\n", rv);
@@ -0,0 +1,144 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitd_impl.h"
+
+/* ARENA
+
+The arena backs the request parsing and the response buffer of a socket request: the arg,
+the options, the unit names and the marshalled buffer.
+The units which a request loads or copies (unitNew with their processData, history and errors)
+are not allocated in the arena, they are heap objects released by unitRelease() because they
+can outlive the request (see loadUnits()).
+The memory is taken from large blocks and it is released in one step
+together with the arena thus the single objects must never be released.
+The last allocated string can grow in place so building a buffer doesn't
+require a reallocation for each appended token.
+
+*/
+
+static size_t arenaAlign(size_t size)
+{
+    return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+/* Makes sure that the current block has at least 'size' free bytes */
+static ArenaBlock *arenaReserve(Arena *arena, size_t size)
+{
+    ArenaBlock *block = arena->block;
+
+    if (!block || block->used + size > block->size) {
+        if (size < ARENA_BLOCK_SIZE)
+            size = ARENA_BLOCK_SIZE;
+        block = malloc(sizeof(ArenaBlock) + size);
+        assert(block);
+        block->next = arena->block;
+        block->size = size;
+        block->used = 0;
+        arena->block = block;
+        arena->lastStr = NULL;
+    }
+
+    return block;
+}
+
+Arena *arenaNew()
+{
+    Arena *arena = calloc(1, sizeof(Arena));
+    assert(arena);
+    arena->block = NULL;
+    arena->lastStr = NULL;
+
+    return arena;
+}
+
+void arenaRelease(Arena **arena)
+{
+    ArenaBlock *block = NULL, *next = NULL;
+
+    if (*arena) {
+        block = (*arena)->block;
+        while (block) {
+            next = block->next;
+            free(block);
+            block = next;
+        }
+        objectRelease(arena);
+    }
+}
+
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    ArenaBlock *block = NULL;
+    void *ptr = NULL;
+
+    assert(arena);
+
+    size = arenaAlign(size);
+    block = arenaReserve(arena, size);
+    ptr = block->data + block->used;
+    block->used += size;
+    arena->lastStr = NULL;
+
+    return ptr;
+}
+
+char *arenaStringNewN(Arena *arena, const char *str, size_t len)
+{
+    char *ret = arenaAlloc(arena, len + 1);
+
+    memcpy(ret, str, len);
+    ret[len] = '\0';
+    arena->lastStr = ret;
+    arena->lastStrLen = len;
+
+    return ret;
+}
+
+char *arenaStringNew(Arena *arena, const char *str)
+{
+    assert(str);
+    return arenaStringNewN(arena, str, strlen(str));
+}
+
+void arenaStringAppendStr(Arena *arena, char **str, const char *toAppend)
+{
+    ArenaBlock *block = NULL;
+    size_t len = 0, strLen = 0, offset = 0;
+    char *newStr = NULL;
+
+    assert(arena);
+    assert(toAppend);
+
+    if (!(*str)) {
+        *str = arenaStringNew(arena, toAppend);
+        return;
+    }
+    len = strlen(toAppend);
+    if (*str == arena->lastStr) {
+        /* The string is the last allocation of the current block thus it can grow in place */
+        block = arena->block;
+        strLen = arena->lastStrLen;
+        offset = *str - block->data;
+        if (offset + strLen + len + 1 <= block->size) {
+            memcpy(*str + strLen, toAppend, len + 1);
+            arena->lastStrLen += len;
+            block->used = arenaAlign(offset + arena->lastStrLen + 1);
+            return;
+        }
+    } else
+        strLen = strlen(*str);
+    /* We reserve the double of the space so that the next appends will be in place */
+    arenaReserve(arena, 2 * (strLen + len + 1));
+    newStr = arenaAlloc(arena, strLen + len + 1);
+    memcpy(newStr, *str, strLen);
+    memcpy(newStr + strLen, toAppend, len + 1);
+    arena->lastStr = newStr;
+    arena->lastStrLen = strLen + len;
+    *str = newStr;
+}
@@ -0,0 +1,32 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#define ARENA_BLOCK_SIZE 8192
+#define ARENA_ALIGN sizeof(void *)
+
+typedef struct ArenaBlock ArenaBlock;
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+struct Arena {
+    ArenaBlock *block;
+    char *lastStr;
+    size_t lastStrLen;
+};
+
+Arena *arenaNew();
+void arenaRelease(Arena **);
+void *arenaAlloc(Arena *, size_t);
+char *arenaStringNew(Arena *, const char *);
+char *arenaStringNewN(Arena *, const char *, size_t);
+void arenaStringAppendStr(Arena *, char **, const char *);
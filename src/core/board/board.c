@@ -0,0 +1,285 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitd_impl.h"
+
+/* STATUS BOARD
+
+The status board is a file which unitd maps in shared memory.
+It contains a fixed-layout table with an entry for each unit which has been started.
+The clients map it read only and they don't need to connect to the socket.
+Each entry is protected by a seqlock:
+- the writer makes the sequence number odd, updates the entry and makes it even again.
+- the reader copies the entry and retries if the sequence number was odd or it has changed.
+The entries are only appended (the name of an entry never changes) so the readers can
+scan the table without locks.
+
+*/
+
+char *BOARD_USER_PATH = NULL;
+
+static UnitsBoard *UNITS_BOARD = NULL;
+static size_t BOARD_SIZE = 0;
+static bool BOARD_FULL = false;
+static pthread_mutex_t BOARD_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+/* Set by the signal handler when it can't write an entry because it has
+ * interrupted the writer. The interrupted writer will rewrite the entry.
+*/
+static uint32_t BOARD_DIRTY[BOARD_MAX_UNITS];
+
+static int getBoardIdx(UnitsBoard *unitsBoard, const char *unitName)
+{
+    uint32_t count = __atomic_load_n(&unitsBoard->count, __ATOMIC_ACQUIRE);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (strncmp(unitsBoard->entries[i].name, unitName, UNIT_BOARD_NAME_LEN - 1) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+static int addBoardEntry(UnitsBoard *unitsBoard, const char *unitName)
+{
+    int rv = -1;
+    uint32_t count = 0;
+
+    handleMutex(&BOARD_MUTEX, true);
+    /* Another thread could have added it meanwhile */
+    if ((rv = getBoardIdx(unitsBoard, unitName)) != -1)
+        goto out;
+    count = unitsBoard->count;
+    if (count == unitsBoard->capacity) {
+        if (!BOARD_FULL) {
+            BOARD_FULL = true;
+            logError(SYSTEM, "src/core/board/board.c", "addBoardEntry", ENOSPC, strerror(ENOSPC),
+                     "The status board is full. Unable to add the %s unit", unitName);
+        }
+        goto out;
+    }
+    strncpy(unitsBoard->entries[count].name, unitName, UNIT_BOARD_NAME_LEN - 1);
+    /* Publish the new entry */
+    __atomic_store_n(&unitsBoard->count, count + 1, __ATOMIC_RELEASE);
+    rv = count;
+
+out:
+    handleMutex(&BOARD_MUTEX, false);
+    return rv;
+}
+
+static bool lockBoardEntry(UnitBoardEntry *entry)
+{
+    uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_RELAXED);
+
+    if ((seq & 1) || !__atomic_compare_exchange_n(&entry->seq, &seq, seq + 1, false,
+                                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return true;
+}
+
+static void unlockBoardEntry(UnitBoardEntry *entry)
+{
+    __atomic_store_n(&entry->seq, entry->seq + 1, __ATOMIC_RELEASE);
+}
+
+static void writeBoardEntry(UnitBoardEntry *entry, Unit *unit)
+{
+    ProcessData *pData = unit->processData;
+    Time *timeStart = pData->timeStart, *timeStop = pData->timeStop;
+
+    entry->type = unit->type;
+    entry->pState = pData->pStateData->pState;
+    entry->finalStatus = *pData->finalStatus;
+    entry->pid = *pData->pid;
+    entry->exitCode = *pData->exitCode;
+    entry->signalNum = *pData->signalNum;
+    entry->restartNum = unit->restartNum;
+    entry->enabled = unit->enabled;
+    entry->timeStart = (timeStart && timeStart->sec ? *timeStart->sec : 0);
+    entry->timeStop = (timeStop && timeStop->sec ? *timeStop->sec : 0);
+    entry->timeChanged = time(NULL);
+}
+
+int openUnitsBoard()
+{
+    int rv = 0, fd = -1;
+    const char *boardPath = !USER_INSTANCE ? BOARD_PATH : BOARD_USER_PATH;
+    size_t size = sizeof(UnitsBoard) + BOARD_MAX_UNITS * sizeof(UnitBoardEntry);
+    UnitsBoard *unitsBoard = MAP_FAILED;
+
+    assert(boardPath);
+
+    /* The clients which have mapped the previous board keep their copy */
+    unlink(boardPath);
+    if ((fd = open(boardPath, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "openUnitsBoard", rv, strerror(rv),
+                 "Unable to create the status board %s", boardPath);
+        goto out;
+    }
+    if (ftruncate(fd, size) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "openUnitsBoard", rv, strerror(rv),
+                 "Unable to resize the status board %s", boardPath);
+        goto out;
+    }
+    if ((unitsBoard = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) ==
+        MAP_FAILED) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "openUnitsBoard", rv, strerror(rv),
+                 "Unable to map the status board %s", boardPath);
+        goto out;
+    }
+    unitsBoard->version = BOARD_VERSION;
+    unitsBoard->capacity = BOARD_MAX_UNITS;
+    unitsBoard->entrySize = sizeof(UnitBoardEntry);
+    unitsBoard->count = 0;
+    unitsBoard->pid = UNITD_PID;
+    /* The magic number is the last one because it marks the board as ready */
+    __atomic_store_n(&unitsBoard->magic, BOARD_MAGIC, __ATOMIC_RELEASE);
+    BOARD_SIZE = size;
+    __atomic_store_n(&UNITS_BOARD, unitsBoard, __ATOMIC_RELEASE);
+
+out:
+    if (fd != -1) {
+        close(fd);
+        if (rv != 0)
+            unlink(boardPath);
+    }
+    return rv;
+}
+
+void updateUnitsBoard(Unit *unit, bool canAdd)
+{
+    UnitsBoard *unitsBoard = __atomic_load_n(&UNITS_BOARD, __ATOMIC_ACQUIRE);
+    UnitBoardEntry *entry = NULL;
+    int idx = -1;
+
+    /* If canAdd is false then this function is async-signal-safe */
+    if (!unitsBoard || !unit)
+        return;
+    if ((idx = getBoardIdx(unitsBoard, unit->name)) == -1) {
+        if (!canAdd || (idx = addBoardEntry(unitsBoard, unit->name)) == -1)
+            return;
+    }
+    entry = &unitsBoard->entries[idx];
+    if (!canAdd) {
+        /* We can't wait for the writer which we could have interrupted */
+        if (!lockBoardEntry(entry)) {
+            __atomic_store_n(&BOARD_DIRTY[idx], 1, __ATOMIC_RELEASE);
+            return;
+        }
+        writeBoardEntry(entry, unit);
+        unlockBoardEntry(entry);
+        return;
+    }
+    do {
+        while (!lockBoardEntry(entry))
+            sched_yield();
+        writeBoardEntry(entry, unit);
+        unlockBoardEntry(entry);
+    } while (__atomic_exchange_n(&BOARD_DIRTY[idx], 0, __ATOMIC_ACQ_REL));
+}
+
+void closeUnitsBoard()
+{
+    UnitsBoard *unitsBoard = __atomic_exchange_n(&UNITS_BOARD, NULL, __ATOMIC_ACQ_REL);
+
+    if (unitsBoard) {
+        unlink(!USER_INSTANCE ? BOARD_PATH : BOARD_USER_PATH);
+        if (munmap(unitsBoard, BOARD_SIZE) == -1)
+            logError(CONSOLE | SYSTEM, "src/core/board/board.c", "closeUnitsBoard", errno,
+                     strerror(errno), "Unable to unmap the status board");
+    }
+}
+
+int getUnitsBoard(Array **unitsBoard)
+{
+    int rv = 0, fd = -1, retries = 0;
+    const char *boardPath = !USER_INSTANCE ? BOARD_PATH : BOARD_USER_PATH;
+    struct stat sb;
+    UnitsBoard *board = MAP_FAILED;
+    UnitBoardEntry *entry = NULL, *entryCopy = NULL;
+    uint32_t count = 0, seq = 0;
+
+    assert(unitsBoard);
+    assert(boardPath);
+
+    if ((fd = open(boardPath, O_RDONLY | O_CLOEXEC)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv, strerror(rv),
+                 "Unable to open the status board %s", boardPath);
+        goto out;
+    }
+    if (fstat(fd, &sb) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv, strerror(rv),
+                 "Unable to stat the status board %s", boardPath);
+        goto out;
+    }
+    if ((size_t)sb.st_size < sizeof(UnitsBoard)) {
+        rv = EPROTO;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv, strerror(rv),
+                 "The status board %s is not valid", boardPath);
+        goto out;
+    }
+    if ((board = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv, strerror(rv),
+                 "Unable to map the status board %s", boardPath);
+        goto out;
+    }
+    if (__atomic_load_n(&board->magic, __ATOMIC_ACQUIRE) != BOARD_MAGIC ||
+        board->version != BOARD_VERSION || board->entrySize != sizeof(UnitBoardEntry) ||
+        sizeof(UnitsBoard) + (size_t)board->capacity * board->entrySize > (size_t)sb.st_size) {
+        rv = EPROTO;
+        logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv, strerror(rv),
+                 "The status board %s is not valid", boardPath);
+        goto out;
+    }
+    if (!(*unitsBoard))
+        *unitsBoard = arrayNew(objectRelease);
+    count = __atomic_load_n(&board->count, __ATOMIC_ACQUIRE);
+    if (count > board->capacity)
+        count = board->capacity;
+    for (uint32_t i = 0; i < count; i++) {
+        entry = &board->entries[i];
+        entryCopy = calloc(1, sizeof(UnitBoardEntry));
+        assert(entryCopy);
+        for (retries = 0;; retries++) {
+            seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+            if (!(seq & 1)) {
+                memcpy(entryCopy, entry, sizeof(UnitBoardEntry));
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&entry->seq, __ATOMIC_RELAXED) == seq)
+                    break;
+            }
+            /* Unitd could have died while it was writing this entry */
+            if (retries == BOARD_MAX_READ_RETRIES) {
+                rv = EAGAIN;
+                logError(CONSOLE | SYSTEM, "src/core/board/board.c", "getUnitsBoard", rv,
+                         strerror(rv), "Unable to read the entry %u of the status board", i);
+                objectRelease(&entryCopy);
+                goto out;
+            }
+            sched_yield();
+        }
+        entryCopy->name[UNIT_BOARD_NAME_LEN - 1] = '\0';
+        arrayAdd(*unitsBoard, entryCopy);
+        entryCopy = NULL;
+    }
+
+out:
+    if (board != MAP_FAILED)
+        munmap(board, sb.st_size);
+    if (fd != -1)
+        close(fd);
+    return rv;
+}
@@ -0,0 +1,29 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#define BOARD_PATH "/run/unitd.board"
+#define BOARD_MAGIC 0x554e4244
+#define BOARD_VERSION 1
+#define BOARD_MAX_UNITS 512
+#define BOARD_MAX_READ_RETRIES 1000
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t entrySize;
+    uint32_t count;
+    int32_t pid;
+    UnitBoardEntry entries[];
+} UnitsBoard;
+
+extern char *BOARD_USER_PATH;
+
+int openUnitsBoard();
+void updateUnitsBoard(Unit *, bool);
+void closeUnitsBoard();
@@ -124,6 +124,8 @@ int execProcess(const char *command, char **argv, Unit **unit)
         }
         break;
     case ONESHOT:
+        /* We could wait until the timeout holding the unit mutex, so we publish the pid */
+        publishUnitSnapshot(*unit);
         millisec = 0;
         /* Timeout */
         while (millisec <= TIMEOUT_MS) {
@@ -460,10 +462,6 @@ int execUScript(Array **envVars, const char *operation)
     arrayAdd(scriptParams, stringNew(operation)); //1
     arrayAdd(scriptParams, NULL);
     rv = execScript(UNITD_DATA_PATH, "/scripts/unitd.sh", scriptParams->arr, (*envVars)->arr);
-    /* We exclude the following test for "virtualization" operation */
-    if (stringEquals(operation, "virtualization") && rv != 0 && rv != 1)
-        logError(CONSOLE | SYSTEM, "src/core/commands/commands.c", "execUScript", rv, strerror(rv),
-                 "ExecScript error for the '%s' operation", operation);
 
     arrayRelease(&scriptParams);
     return rv;
@@ -122,12 +122,7 @@ int setNewDefaultStateSyml(State newDefaultState, Array **messages, Array **erro
     to = stringNew(UNITS_ENAB_PATH);
     stringAppendChr(&to, '/');
     stringAppendStr(&to, DEF_STATE_SYML_NAME);
-    Array *envVars = arrayNew(objectRelease);
-    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-    addEnvVar(&envVars, "FROM", from);
-    addEnvVar(&envVars, "TO", to);
-    arrayAdd(envVars, NULL);
-    rv = execUScript(&envVars, "default-syml");
+    rv = handleSymlink(SYML_ADD_OP, from, to);
     if (rv != 0) {
         arrayAdd(*errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_GENERIC_ERR].desc));
         arrayAdd(*messages, getMsg(-1, UNITD_MESSAGES_ITEMS[UNITD_SYSTEM_LOG_MSG].desc));
@@ -136,10 +131,111 @@ int setNewDefaultStateSyml(State newDefaultState, Array **messages, Array **erro
 
     objectRelease(&from);
     objectRelease(&to);
-    arrayRelease(&envVars);
     return rv;
 }
 
+/* Create (add) or remove the symlink without running a shell.
+ * The new symlink replaces the old one atomically by rename().
+*/
+int handleSymlink(const char *operation, const char *from, const char *to)
+{
+    char *tmpPath = NULL;
+    int rv = 0;
+
+    assert(operation);
+    assert(to);
+
+    if (stringEquals(operation, SYML_REMOVE_OP)) {
+        if (unlink(to) == -1 && errno != ENOENT)
+            rv = errno;
+    } else if (stringEquals(operation, SYML_ADD_OP)) {
+        assert(from);
+        tmpPath = stringNew(to);
+        stringAppendStr(&tmpPath, ".tmp");
+        unlink(tmpPath);
+        if (symlink(from, tmpPath) == -1 || rename(tmpPath, to) == -1) {
+            rv = errno;
+            unlink(tmpPath);
+        }
+    }
+    if (rv != 0) {
+        logError(SYSTEM, "src/core/common/common.c", "handleSymlink", rv, strerror(rv),
+                 "Unable to %s the '%s' symlink", operation, to);
+    }
+
+    objectRelease(&tmpPath);
+    return rv;
+}
+
+/* The suggested size of the buffer could be too small for an entry (e.g. a big group) */
+static char *growNssBuffer(char *buffer, size_t *size)
+{
+    *size *= 2;
+    buffer = realloc(buffer, *size);
+    assert(buffer);
+
+    return buffer;
+}
+
+/* Returns true if the user is root or a member of the administrator group */
+bool isAdministrator(uid_t userId, gid_t groupId)
+{
+    struct group group, *groupResult = NULL;
+    struct passwd passwd, *passwdResult = NULL;
+    char *buffer = NULL;
+    size_t size = 0;
+    long maxSize = 0;
+    gid_t *groups = NULL, adminGroupId = 0;
+    int rv = 0, numGroups = ADMIN_GROUPS_SIZE, len = 0;
+    bool isAdmin = false;
+
+    if (userId == 0)
+        return true;
+    if ((maxSize = sysconf(_SC_GETGR_R_SIZE_MAX)) > 0)
+        size = maxSize;
+    if ((maxSize = sysconf(_SC_GETPW_R_SIZE_MAX)) > 0 && (size_t)maxSize > size)
+        size = maxSize;
+    if (size == 0)
+        size = NSS_BUFFER_SIZE;
+    buffer = malloc(size);
+    assert(buffer);
+    while ((rv = getgrnam_r(UNITD_ADMIN_GROUP, &group, buffer, size, &groupResult)) == ERANGE)
+        buffer = growNssBuffer(buffer, &size);
+    if (rv != 0 || !groupResult)
+        goto out;
+    if ((isAdmin = (adminGroupId = group.gr_gid) == groupId))
+        goto out;
+    /* Supplementary groups */
+    while ((rv = getpwuid_r(userId, &passwd, buffer, size, &passwdResult)) == ERANGE)
+        buffer = growNssBuffer(buffer, &size);
+    if (rv != 0 || !passwdResult)
+        goto out;
+    len = numGroups;
+    groups = calloc(len, sizeof(gid_t));
+    assert(groups);
+    /* If the array is too small, numGroups is set to the number of the groups */
+    while (getgrouplist(passwd.pw_name, passwd.pw_gid, groups, &numGroups) == -1) {
+        len = numGroups > len ? numGroups : len * 2;
+        groups = realloc(groups, len * sizeof(gid_t));
+        assert(groups);
+        numGroups = len;
+    }
+    for (int i = 0; i < numGroups && !isAdmin; i++)
+        isAdmin = groups[i] == adminGroupId;
+
+out:
+    objectRelease(&buffer);
+    objectRelease(&groups);
+    return isAdmin;
+}
+
+/* Detect the containers (LXC, docker, podman ...) */
+bool isVirtualization()
+{
+    return getenv("container") || access("/.dockerenv", F_OK) == 0 ||
+           access("/run/.containerenv", F_OK) == 0;
+}
+
 void arrayPrint(int options, Array **array, bool hasStrings)
 {
     int len = (*array ? (*array)->size : 0);
@@ -233,46 +329,99 @@ int writeWtmp(bool isBooting)
     return rv;
 }
 
+/* Create the folder and its parents (mkdir -p) */
+static int makeDir(const char *path)
+{
+    char *dir = stringNew(path);
+    int rv = 0;
+
+    for (char *ptr = dir + 1; *ptr; ptr++) {
+        if (*ptr != '/')
+            continue;
+        *ptr = '\0';
+        if (mkdir(dir, 0755) == -1 && errno != EEXIST) {
+            rv = errno;
+            goto out;
+        }
+        *ptr = '/';
+    }
+    if (mkdir(dir, 0755) == -1 && errno != EEXIST)
+        rv = errno;
+
+out:
+    if (rv != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/common/common.c", "makeDir", rv, strerror(rv),
+                 "Unable to create the '%s' folder", dir);
+    }
+    objectRelease(&dir);
+    return rv;
+}
+
+/* Count the unitd processes which have the user as real and effective user (pgrep -x -u -U).
+ * Please note that if we run the instance under valgrind supervision then this count fails!!
+*/
+static int countUserInstances(uid_t userId)
+{
+    DIR *dir = NULL;
+    struct dirent *dirEntry = NULL;
+    FILE *fp = NULL;
+    char path[PATH_MAX] = { 0 }, name[16] = { 0 }, *line = NULL;
+    size_t len = 0;
+    unsigned int realUid = 0, effectiveUid = 0;
+    int count = 0;
+    bool isUnitd = false;
+
+    if (!(dir = opendir("/proc")))
+        return 0;
+    while ((dirEntry = readdir(dir))) {
+        if (!isdigit(dirEntry->d_name[0]))
+            continue;
+        snprintf(path, PATH_MAX, "/proc/%s/status", dirEntry->d_name);
+        /* The process could be exited meanwhile */
+        if (!(fp = fopen(path, "r")))
+            continue;
+        isUnitd = false;
+        while (getline(&line, &len, fp) != -1) {
+            if (sscanf(line, "Name:\t%15s", name) == 1)
+                isUnitd = stringEquals(name, "unitd");
+            else if (sscanf(line, "Uid:\t%u\t%u", &realUid, &effectiveUid) == 2) {
+                if (isUnitd && realUid == userId && effectiveUid == userId)
+                    count++;
+                break;
+            }
+        }
+        fclose(fp);
+    }
+
+    objectRelease(&line);
+    closedir(dir);
+    return count;
+}
+
 int unitdUserCheck(const char *userIdStr, const char *userName)
 {
+    char *unitsUserEnabPath = NULL;
     int rv = 0;
-    char euirun[5] = { 0 };
 
     assert(userIdStr);
     assert(userName);
-    assert(EUIRUN);
-
-    sprintf(euirun, "%d", EUIRUN);
-    Array *envVars = arrayNew(objectRelease);
-    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-    addEnvVar(&envVars, "EUIRUN", euirun);
-    arrayAdd(envVars, NULL);
-    char *cmd = stringNew(UNITD_DATA_PATH);
-    stringAppendStr(&cmd, "/scripts/unitd-user-check.sh");
-    Array *scriptParams = arrayNew(objectRelease);
-    arrayAdd(scriptParams, cmd); //0
-    arrayAdd(scriptParams, stringNew(UNITS_USER_LOCAL_PATH)); //1
-    arrayAdd(scriptParams, stringNew(UNITS_USER_ENAB_PATH)); //2
-    arrayAdd(scriptParams, stringNew(UNITD_USER_TIMER_DATA_PATH)); //3
-    arrayAdd(scriptParams, stringNew(userIdStr)); //4
-    arrayAdd(scriptParams, stringNew(userName)); //5
-    arrayAdd(scriptParams, NULL); //6
-    rv = execScript(UNITD_DATA_PATH, "/scripts/unitd-user-check.sh", scriptParams->arr,
-                    envVars->arr);
-    if (rv != 0) {
-        /* If rv == EUIRUN then the instance is already running */
-        if (rv == EUIRUN) {
-            logErrorStr(CONSOLE | SYSTEM, "Unitd instance is already running for %s user!",
-                        userName);
-            printf("\n");
-        } else {
-            logError(CONSOLE | SYSTEM, "src/core/common/common.c", "unitdUserCheck", rv,
-                     strerror(rv), "ExecScript error");
-        }
+
+    unitsUserEnabPath = stringNew(UNITS_USER_ENAB_PATH);
+    stringAppendChr(&unitsUserEnabPath, '/');
+    stringAppendStr(&unitsUserEnabPath, STATE_DATA_ITEMS[USER].desc);
+    stringAppendStr(&unitsUserEnabPath, ".state");
+    if ((rv = makeDir(UNITS_USER_LOCAL_PATH)) != 0 || (rv = makeDir(unitsUserEnabPath)) != 0 ||
+        (rv = makeDir(UNITD_USER_TIMER_DATA_PATH)) != 0)
+        goto out;
+    /* Check the instance is not already running for the user */
+    if (countUserInstances(atoi(userIdStr)) > 1) {
+        rv = EUIRUN;
+        logErrorStr(CONSOLE | SYSTEM, "Unitd instance is already running for %s user!", userName);
+        printf("\n");
     }
 
-    arrayRelease(&envVars);
-    arrayRelease(&scriptParams);
+out:
+    objectRelease(&unitsUserEnabPath);
     return rv;
 }
 
@@ -300,6 +449,16 @@ int parseProcCmdLine()
             if (stringEquals(value, PROC_CMDLINE_UNITD_DEBUG)) {
                 DEBUG = true;
                 continue;
+            } else if (stringStartsWithStr(value, PROC_CMDLINE_UNITD_CATCHUP_MAX)) {
+                value += strlen(PROC_CMDLINE_UNITD_CATCHUP_MAX);
+                if (isValidNumber(value, false) && atoi(value) > 0)
+                    TIMERS_CATCHUP_MAX = atoi(value);
+                continue;
+            } else if (stringStartsWithStr(value, PROC_CMDLINE_UNITD_CATCHUP_SPREAD)) {
+                value += strlen(PROC_CMDLINE_UNITD_CATCHUP_SPREAD);
+                if (isValidNumber(value, false))
+                    TIMERS_CATCHUP_SPREAD = atoi(value);
+                continue;
             } else if (stringEquals(value, "single") ||
                        stringEquals(value, STATE_DATA_ITEMS[SINGLE_USER].desc)) {
                 STATE_CMDLINE = SINGLE_USER;
@@ -387,12 +546,16 @@ int setUserData(int userId, struct passwd **userInfo)
     SOCKET_USER_PATH = stringNew(xdgRunTimeDir);
     stringAppendStr(&SOCKET_USER_PATH, "/unitd.sock");
     assert(SOCKET_USER_PATH);
+    BOARD_USER_PATH = stringNew(xdgRunTimeDir);
+    stringAppendStr(&BOARD_USER_PATH, "/unitd.board");
+    assert(BOARD_USER_PATH);
     if (DEBUG) {
         logInfo(CONSOLE, "Units user path = %s\n", UNITS_USER_PATH);
         logInfo(CONSOLE, "Units user local path = %s\n", UNITS_USER_LOCAL_PATH);
         logInfo(CONSOLE, "Units user conf path = %s\n", UNITD_USER_CONF_PATH);
         logInfo(CONSOLE, "Units user enab path = %s\n", UNITS_USER_ENAB_PATH);
         logInfo(CONSOLE, "socket user path = %s\n", SOCKET_USER_PATH);
+        logInfo(CONSOLE, "board user path = %s\n", BOARD_USER_PATH);
     }
 
 out:
@@ -406,6 +569,7 @@ void userDataRelease()
     objectRelease(&UNITD_USER_TIMER_DATA_PATH);
     objectRelease(&UNITS_USER_ENAB_PATH);
     objectRelease(&SOCKET_USER_PATH);
+    objectRelease(&BOARD_USER_PATH);
 }
 
 void *handleMutexThread(void *arg)
@@ -7,6 +7,8 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 */
 
 #define EUIRUN 114
+#define NSS_BUFFER_SIZE 1024
+#define ADMIN_GROUPS_SIZE 32
 
 typedef enum {
     NO_FUNC = -1,
@@ -27,6 +29,9 @@ void addEnvVar(Array **, const char *, const char *);
 State getStateByStr(char *);
 int getDefaultStateStr(char **);
 int setNewDefaultStateSyml(State, Array **, Array **);
+int handleSymlink(const char *, const char *, const char *);
+bool isAdministrator(uid_t, gid_t);
+bool isVirtualization();
 void arrayPrint(int options, Array **, bool);
 bool isKexecLoaded();
 int writeWtmp(bool);
@@ -8,7 +8,19 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 
 #include "../unitd_impl.h"
 
+/* CLEANER
+
+The cleaner thread reaps the pending child processes and it publishes the status snapshots of
+the units which have been changed by the threads which can't lock them (i.e. the signal handler).
+refreshUnitSnapshot() marks the unit as stale and it only writes into the pipe if the cleaner
+has not been woken up yet, so it is async-signal-safe and the pipe never fills up.
+The cleaner doesn't wait for a busy unit: its owner publishes it at the end of the operation
+otherwise the cleaner retries at the next timeout.
+
+*/
+
 Cleaner *CLEANER;
+static bool CLEANER_PUBLISH_PENDING;
 
 Cleaner *cleanerNew()
 {
@@ -27,6 +39,37 @@ void cleanerRelease(Cleaner **cleaner)
     }
 }
 
+static void publishStaleSnapshots()
+{
+    Array *units = UNITD_DATA->units;
+    Unit *unit = NULL;
+    int len = (units ? units->size : 0);
+
+    __atomic_store_n(&CLEANER_PUBLISH_PENDING, false, __ATOMIC_RELEASE);
+    for (int i = 0; i < len; i++) {
+        unit = arrayGet(units, i);
+        if (!__atomic_load_n(&unit->isSnapshotStale, __ATOMIC_ACQUIRE) ||
+            pthread_mutex_trylock(unit->mutex) != 0)
+            continue;
+        publishUnitSnapshot(unit);
+        handleMutex(unit->mutex, false);
+    }
+}
+
+void refreshUnitSnapshot(Unit *unit)
+{
+    Cleaner *cleaner = __atomic_load_n(&CLEANER, __ATOMIC_ACQUIRE);
+    int output = CLEANER_PUBLISH;
+
+    assert(unit);
+
+    __atomic_store_n(&unit->isSnapshotStale, true, __ATOMIC_RELEASE);
+    if (cleaner && !__atomic_exchange_n(&CLEANER_PUBLISH_PENDING, true, __ATOMIC_ACQ_REL)) {
+        if (uWrite(cleaner->pipe->fds[1], &output, sizeof(int)) == -1)
+            __atomic_store_n(&CLEANER_PUBLISH_PENDING, false, __ATOMIC_RELEASE);
+    }
+}
+
 void *startCleanerThread(void *arg UNUSED)
 {
     int rv, input, fd;
@@ -66,9 +109,13 @@ void *startCleanerThread(void *arg UNUSED)
             }
             if (input == THREAD_EXIT)
                 goto out;
+            if (input == CLEANER_PUBLISH)
+                publishStaleSnapshots();
         } else {
             /* Reap all pending child processes */
             reapPendingChild();
+            /* Retry the units which were busy */
+            publishStaleSnapshots();
         }
     }
 
@@ -89,7 +136,7 @@ void startCleaner()
     int rv = 0;
 
     assert(!CLEANER);
-    CLEANER = cleanerNew();
+    __atomic_store_n(&CLEANER, cleanerNew(), __ATOMIC_RELEASE);
     if ((rv = pthread_attr_init(&attr)) != 0) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/cleaner.c", "startCleaner", errno,
                  strerror(errno), "pthread_attr_init returned bad exit code %d", rv);
@@ -7,6 +7,7 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 */
 
 #define CLEANER_TIMEOUT 10
+#define CLEANER_PUBLISH 1
 
 typedef struct {
     Pipe *pipe;
@@ -19,3 +20,4 @@ void cleanerRelease(Cleaner **);
 void startCleaner();
 void *startCleanerThread(void *);
 void stopCleaner();
+void refreshUnitSnapshot(Unit *);
@@ -11,100 +11,473 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #define EVENT_SIZE (sizeof(struct inotify_event))
 #define EVENT_BUF_LEN (1024 * (EVENT_SIZE + 16))
 
+/* NOTIFIER
+
+A single inotify instance and a single thread handle the unitd watchers and all the path units.
+The thread waits for the inotify and the pipe file descriptors by epoll.
+The same path can be watched by more path units but inotify returns the same watch descriptor
+for it, thus the watchers are kept into a hash table by watch descriptor.
+The mask of a watch is the union of the masks of its watchers (IN_MASK_ADD) so every watcher
+checks its own mask. The mask is not reduced when a watcher is removed.
+The units are executed by a detached thread to not block the events of the other path units.
+The notifier thread only marks the unit as pending and never waits for it, so all the events
+of a burst collapse into the pending flag and the unit is executed once more at most.
+Before executing the unit, the thread waits for TriggerQuietSec seconds without events and
+defers the execution to the next interval if TriggerLimitBurst has been reached.
+The PathExistsGlob and PathDirectoryNotEmpty watchers keep the names of the entries of the
+monitored folder which match the pattern or which are not hidden, backup or swap files.
+The folder is read only when the unit starts and when the inotify queue overflows (IN_Q_OVERFLOW),
+otherwise the names are added by the create and move events and removed by the delete and move
+events. The names are kept into a hash set, so an event doesn't depend on the number of the
+entries. A name is only added once, so a rename over an existing entry doesn't count it twice.
+
+*/
+
 bool USER_INSTANCE;
 Notifier *NOTIFIER;
+static WatchTable *WATCH_TABLE;
+static pthread_mutex_t WATCH_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t WATCH_CV = PTHREAD_COND_INITIALIZER;
 const WatcherData WATCHER_DATA_ITEMS[] = {
     { UNITD_WATCHER, IN_MODIFY | IN_DELETE | IN_MOVED_FROM },
     { PATH_EXISTS_WATCHER, IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB | IN_CREATE },
-    { PATH_EXISTS_GLOB_WATCHER, IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB | IN_CREATE },
+    { PATH_EXISTS_GLOB_WATCHER, IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB | IN_CREATE |
+                                    IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO },
     { PATH_RESOURCE_CHANGED_WATCHER,
       IN_DELETE_SELF | IN_MOVE_SELF | IN_DELETE | IN_CREATE | IN_MOVED_FROM | IN_MOVED_TO },
     { PATH_DIRECTORY_NOT_EMPTY_WATCHER,
       IN_DELETE_SELF | IN_MOVE_SELF | IN_DELETE | IN_CREATE | IN_MOVED_FROM | IN_MOVED_TO }
 };
 
+static void lockWatchTable(bool lock)
+{
+    int rv = 0;
+
+    if (lock) {
+        if ((rv = pthread_mutex_lock(&WATCH_MUTEX)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "lockWatchTable", rv,
+                     strerror(rv), "Unable to acquire the lock of the watch mutex");
+            kill(UNITD_PID, SIGTERM);
+        }
+    } else {
+        if ((rv = pthread_mutex_unlock(&WATCH_MUTEX)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "lockWatchTable", rv,
+                     strerror(rv), "Unable to unlock the watch mutex");
+            kill(UNITD_PID, SIGTERM);
+        }
+    }
+}
+
+static WatchTable *watchTableNew(int size)
+{
+    WatchTable *watchTable = calloc(1, sizeof(WatchTable));
+    assert(watchTable);
+    watchTable->size = size;
+    watchTable->buckets = calloc(size, sizeof(WatchEntry *));
+    assert(watchTable->buckets);
+    watchTable->count = 0;
+
+    return watchTable;
+}
+
+static void watchTableRelease(WatchTable **watchTable)
+{
+    WatchEntry *watchEntry = NULL, *next = NULL;
+
+    if (*watchTable) {
+        for (int i = 0; i < (*watchTable)->size; i++) {
+            for (watchEntry = (*watchTable)->buckets[i]; watchEntry; watchEntry = next) {
+                next = watchEntry->next;
+                arrayRelease(&watchEntry->watchers);
+                objectRelease(&watchEntry);
+            }
+        }
+        objectRelease(&(*watchTable)->buckets);
+        objectRelease(watchTable);
+    }
+}
+
+/* The watch descriptors are small and increasing integers thus the modulo is enough */
+static WatchEntry *getWatchEntry(int wd)
+{
+    WatchEntry *watchEntry = NULL;
+
+    if (!WATCH_TABLE || wd < 0)
+        return NULL;
+    for (watchEntry = WATCH_TABLE->buckets[wd % WATCH_TABLE->size]; watchEntry;
+         watchEntry = watchEntry->next) {
+        if (watchEntry->wd == wd)
+            return watchEntry;
+    }
+
+    return NULL;
+}
+
+static void resizeWatchTable()
+{
+    WatchTable *watchTable = watchTableNew(WATCH_TABLE->size * 2);
+    WatchEntry *watchEntry = NULL, *next = NULL;
+    int idx = 0;
+
+    for (int i = 0; i < WATCH_TABLE->size; i++) {
+        for (watchEntry = WATCH_TABLE->buckets[i]; watchEntry; watchEntry = next) {
+            next = watchEntry->next;
+            idx = watchEntry->wd % watchTable->size;
+            watchEntry->next = watchTable->buckets[idx];
+            watchTable->buckets[idx] = watchEntry;
+        }
+    }
+    watchTable->count = WATCH_TABLE->count;
+    objectRelease(&WATCH_TABLE->buckets);
+    objectRelease(&WATCH_TABLE);
+    WATCH_TABLE = watchTable;
+}
+
+static WatchEntry *addWatchEntry(int wd)
+{
+    WatchEntry *watchEntry = NULL;
+    int idx = 0;
+
+    if (WATCH_TABLE->count >= WATCH_TABLE->size)
+        resizeWatchTable();
+    watchEntry = calloc(1, sizeof(WatchEntry));
+    assert(watchEntry);
+    watchEntry->wd = wd;
+    watchEntry->watchers = arrayNew(NULL);
+    idx = wd % WATCH_TABLE->size;
+    watchEntry->next = WATCH_TABLE->buckets[idx];
+    WATCH_TABLE->buckets[idx] = watchEntry;
+    WATCH_TABLE->count++;
+
+    return watchEntry;
+}
+
+static void removeWatchEntry(int wd)
+{
+    WatchEntry **watchEntry = NULL, *watchEntryTemp = NULL;
+
+    for (watchEntry = &WATCH_TABLE->buckets[wd % WATCH_TABLE->size]; *watchEntry;
+         watchEntry = &(*watchEntry)->next) {
+        if ((*watchEntry)->wd == wd) {
+            watchEntryTemp = *watchEntry;
+            *watchEntry = watchEntryTemp->next;
+            arrayRelease(&watchEntryTemp->watchers);
+            objectRelease(&watchEntryTemp);
+            WATCH_TABLE->count--;
+            break;
+        }
+    }
+}
+
+/* The caller must own the watch mutex */
+/* Returns true if the entry of the monitored folder has to be counted by the watcher */
+static bool isWatcherEntry(Watcher *watcher, const char *name)
+{
+    char *completeName = NULL;
+    bool ret = false;
+
+    if (stringEquals(name, ".") || stringEquals(name, ".."))
+        return false;
+    switch (watcher->watcherData.watcherType) {
+    case PATH_EXISTS_GLOB_WATCHER:
+        completeName = stringNew(watcher->unit->pathExistsGlobMonitor);
+        stringAppendStr(&completeName, name);
+        ret = fnmatch(watcher->unit->pathExistsGlob, completeName, 0) == 0;
+        objectRelease(&completeName);
+        break;
+    case PATH_DIRECTORY_NOT_EMPTY_WATCHER:
+        /* Like the "*" glob pattern, we discard the hidden files.
+         * We discard backup and swap files as well.
+         */
+        ret = name[0] != '.' && !stringEndsWithChr(name, '~') &&
+              !stringEndsWithStr(name, ".swp") && !stringEndsWithStr(name, ".swpx");
+        break;
+    default:
+        break;
+    }
+
+    return ret;
+}
+
+static bool hasWatcherEntries(Watcher *watcher)
+{
+    WatcherType watcherType = watcher->watcherData.watcherType;
+
+    return watcher->unit && (watcherType == PATH_EXISTS_GLOB_WATCHER ||
+                             watcherType == PATH_DIRECTORY_NOT_EMPTY_WATCHER);
+}
+
+static EntrySet *entrySetNew(int size)
+{
+    EntrySet *entrySet = calloc(1, sizeof(EntrySet));
+    assert(entrySet);
+    entrySet->size = size;
+    entrySet->buckets = calloc(size, sizeof(NameEntry *));
+    assert(entrySet->buckets);
+    entrySet->count = 0;
+
+    return entrySet;
+}
+
+static void entrySetRelease(EntrySet **entrySet)
+{
+    NameEntry *nameEntry = NULL, *next = NULL;
+
+    if (*entrySet) {
+        for (int i = 0; i < (*entrySet)->size; i++) {
+            for (nameEntry = (*entrySet)->buckets[i]; nameEntry; nameEntry = next) {
+                next = nameEntry->next;
+                objectRelease(&nameEntry->name);
+                objectRelease(&nameEntry);
+            }
+        }
+        objectRelease(&(*entrySet)->buckets);
+        objectRelease(entrySet);
+    }
+}
+
+/* FNV-1a */
+static unsigned int getNameHash(const char *name)
+{
+    unsigned int hash = 2166136261U;
+
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/* Returns the link which points to the name entry or to the end of its bucket */
+static NameEntry **getNameEntry(EntrySet *entrySet, const char *name)
+{
+    NameEntry **nameEntry = NULL;
+
+    for (nameEntry = &entrySet->buckets[getNameHash(name) % entrySet->size]; *nameEntry;
+         nameEntry = &(*nameEntry)->next) {
+        if (stringEquals((*nameEntry)->name, name))
+            break;
+    }
+
+    return nameEntry;
+}
+
+static void resizeEntrySet(Watcher *watcher)
+{
+    EntrySet *entrySet = entrySetNew(watcher->entries->size * 2);
+    NameEntry *nameEntry = NULL, *next = NULL;
+    int idx = 0;
+
+    for (int i = 0; i < watcher->entries->size; i++) {
+        for (nameEntry = watcher->entries->buckets[i]; nameEntry; nameEntry = next) {
+            next = nameEntry->next;
+            idx = getNameHash(nameEntry->name) % entrySet->size;
+            nameEntry->next = entrySet->buckets[idx];
+            entrySet->buckets[idx] = nameEntry;
+        }
+    }
+    entrySet->count = watcher->entries->count;
+    objectRelease(&watcher->entries->buckets);
+    objectRelease(&watcher->entries);
+    watcher->entries = entrySet;
+}
+
+/* A name is only added once */
+static void addWatcherEntry(Watcher *watcher, const char *name)
+{
+    NameEntry **link = getNameEntry(watcher->entries, name), *nameEntry = NULL;
+
+    if (*link)
+        return;
+    if (watcher->entries->count >= watcher->entries->size) {
+        resizeEntrySet(watcher);
+        link = getNameEntry(watcher->entries, name);
+    }
+    nameEntry = calloc(1, sizeof(NameEntry));
+    assert(nameEntry);
+    nameEntry->name = stringNew(name);
+    *link = nameEntry;
+    watcher->entries->count++;
+}
+
+static void removeWatcherEntry(Watcher *watcher, const char *name)
+{
+    NameEntry **link = getNameEntry(watcher->entries, name), *nameEntry = *link;
+
+    if (nameEntry) {
+        *link = nameEntry->next;
+        objectRelease(&nameEntry->name);
+        objectRelease(&nameEntry);
+        watcher->entries->count--;
+    }
+}
+
+static void clearWatcherEntries(Watcher *watcher)
+{
+    entrySetRelease(&watcher->entries);
+    watcher->entries = entrySetNew(ENTRY_SET_SIZE);
+}
+
+/* Read the monitored folder to collect the entries from scratch */
+static void scanWatcherEntries(Watcher *watcher)
+{
+    DIR *dir = NULL;
+    struct dirent *dirEntry = NULL;
+
+    clearWatcherEntries(watcher);
+    if (!hasWatcherEntries(watcher))
+        return;
+    if (!(dir = opendir(watcher->path))) {
+        logWarning(SYSTEM, "Unable to read '%s' folder: %s", watcher->path, strerror(errno));
+        return;
+    }
+    while ((dirEntry = readdir(dir))) {
+        if (isWatcherEntry(watcher, dirEntry->d_name))
+            addWatcherEntry(watcher, dirEntry->d_name);
+    }
+    closedir(dir);
+}
+
+void updateWatcherEntries(Watcher *watcher, struct inotify_event *event)
+{
+    if (!hasWatcherEntries(watcher))
+        return;
+    if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+        clearWatcherEntries(watcher);
+    else if (event->len && isWatcherEntry(watcher, event->name)) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            addWatcherEntry(watcher, event->name);
+        else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            removeWatcherEntry(watcher, event->name);
+    }
+}
+
+static int addWatcher(Watcher *watcher, Unit *unit)
+{
+    WatchEntry *watchEntry = NULL;
+    int wd = -1;
+
+    assert(watcher);
+    assert(NOTIFIER && WATCH_TABLE);
+
+    if ((wd = inotify_add_watch(*NOTIFIER->fd, watcher->path,
+                                watcher->watcherData.mask | IN_MASK_ADD)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "addWatcher", errno,
+                 strerror(errno), "Inotify_add_watch returned -1 for '%s' path", watcher->path);
+        return 1;
+    }
+    if (!(watchEntry = getWatchEntry(wd)))
+        watchEntry = addWatchEntry(wd);
+    arrayAdd(watchEntry->watchers, watcher);
+    watcher->unit = unit;
+    *watcher->wd = wd;
+    /* The watch is already added thus no entry will be lost */
+    scanWatcherEntries(watcher);
+
+    return 0;
+}
+
+/* The caller must own the watch mutex */
+static void removeWatcher(Watcher *watcher)
+{
+    WatchEntry *watchEntry = NULL;
+    int wd = -1;
+
+    assert(watcher);
+
+    wd = *watcher->wd;
+    *watcher->wd = -1;
+    watcher->unit = NULL;
+    if (!(watchEntry = getWatchEntry(wd)))
+        return;
+    arrayRemove(watchEntry->watchers, watcher);
+    if (watchEntry->watchers->size == 0) {
+        /* The watch could have been already removed by the kernel (IN_IGNORED) */
+        if (inotify_rm_watch(*NOTIFIER->fd, wd) == -1 && errno != EINVAL) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "removeWatcher", errno,
+                     strerror(errno), "Inotify_rm_watch func returned -1 for %s path",
+                     watcher->path);
+        }
+        removeWatchEntry(wd);
+    }
+}
+
 int notifierInit(Notifier *notifier)
 {
     Array *watchers = NULL;
-    Watcher *watcher = NULL;
     int len = 0, rv = 0;
 
     assert(notifier);
+    assert(notifier == NOTIFIER);
 
     watchers = notifier->watchers;
     len = watchers ? watchers->size : 0;
-    if ((*notifier->fd = inotify_init()) == -1) {
-        rv = 1;
+    if ((*notifier->fd = inotify_init1(IN_CLOEXEC)) == -1) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "notifierInit", errno,
-                 strerror(errno), "Inotify_init func returned -1");
+                 strerror(errno), "Inotify_init1 func returned -1");
+        return 1;
     }
+    lockWatchTable(true);
+    WATCH_TABLE = watchTableNew(WATCH_TABLE_SIZE);
     for (int i = 0; i < len; i++) {
-        watcher = arrayGet(watchers, i);
-        if ((*watcher->wd = inotify_add_watch(*notifier->fd, watcher->path,
-                                              watcher->watcherData.mask)) == -1) {
-            rv = 1;
-            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "notifierInit", errno,
-                     strerror(errno), "Inotify_add_watch returned -1 for '%s' path", watcher->path);
+        if ((rv = addWatcher(arrayGet(watchers, i), NULL)) != 0)
             break;
-        }
     }
+    lockWatchTable(false);
 
     return rv;
 }
 
-void notifierClose(Notifier *notifier)
+/* The path unit watchers are added to the inotify instance only when the unit starts.
+ * Here, we just check they can be watched.
+*/
+int checkWatcherPaths(Notifier *notifier)
 {
     Array *watchers = NULL;
     Watcher *watcher = NULL;
-    int len, fd = -1, rv = -1;
+    int len = 0, rv = 0;
 
     assert(notifier);
 
     watchers = notifier->watchers;
-    fd = *notifier->fd;
     len = watchers ? watchers->size : 0;
     for (int i = 0; i < len; i++) {
         watcher = arrayGet(watchers, i);
-        if ((rv = inotify_rm_watch(fd, *watcher->wd)) == -1 && errno != EINVAL) {
-            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "notifierClose", errno,
-                     strerror(errno), "Inotify_rm_watch func returned -1 for %s path",
-                     watcher->path);
+        if (access(watcher->path, R_OK) == -1) {
+            rv = 1;
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "checkWatcherPaths", errno,
+                     strerror(errno), "Unable to watch '%s' path", watcher->path);
+            break;
         }
     }
-    close(fd);
+
+    return rv;
 }
 
-static bool isEmptyFolder(const char *pathFolder)
+void notifierClose(Notifier *notifier)
 {
-    bool ret = true;
+    Array *watchers = NULL;
+    Watcher *watcher = NULL;
+    int len = 0;
 
-    if (pathFolder) {
-        int rv = 0, len = 0;
-        glob_t results;
-        const char *entry = NULL;
-        char *pattern = NULL;
+    assert(notifier);
 
-        pattern = stringNew(pathFolder);
-        stringAppendStr(&pattern, "/*");
-        if ((rv = glob(pattern, 0, NULL, &results)) == 0) {
-            len = results.gl_pathc;
-            for (int i = 0; i < len; i++) {
-                entry = results.gl_pathv[i];
-                /* The files "." and ".." are already discarded by glob.
-                 * We only discard backup and swap files.
-                 */
-                if (!stringEndsWithChr(entry, '~') && !stringEndsWithStr(entry, ".swp") &&
-                    !stringEndsWithStr(entry, ".swpx")) {
-                    ret = false;
-                    break;
-                }
-            }
-        }
-        globfree(&results);
-        objectRelease(&pattern);
+    watchers = notifier->watchers;
+    len = watchers ? watchers->size : 0;
+    lockWatchTable(true);
+    for (int i = 0; i < len; i++) {
+        watcher = arrayGet(watchers, i);
+        if (*watcher->wd != -1)
+            removeWatcher(watcher);
     }
-
-    return ret;
+    /* The unitd notifier owns the inotify instance */
+    if (*notifier->fd != -1) {
+        close(*notifier->fd);
+        *notifier->fd = -1;
+        watchTableRelease(&WATCH_TABLE);
+    }
+    lockWatchTable(false);
 }
 
 static void checkUnitChanging(const char *eventName)
@@ -120,6 +493,7 @@ static void checkUnitChanging(const char *eventName)
                 kill(UNITD_PID, SIGTERM);
             }
             unit->isChanged = true;
+            refreshUnitSnapshot(unit);
             if (DEBUG)
                 syslog(LOG_DAEMON | LOG_DEBUG, "Unit '%s' is changed!!\n", unitName);
             if ((rv = pthread_mutex_unlock(&NOTIFIER_MUTEX)) != 0) {
@@ -132,25 +506,25 @@ static void checkUnitChanging(const char *eventName)
     }
 }
 
-static bool checkUnitExecution(Unit *unit, WatcherType watcherType, const char *eventName)
+bool isUnitTriggered(Watcher *watcher, struct inotify_event *event)
 {
+    Unit *unit = watcher->unit;
+    const char *eventName = event->name;
     char *completeEventName = NULL;
     bool execUnit = false;
 
     assert(unit);
-    assert(watcherType >= 0);
-    assert(eventName);
+    assert(event->len);
 
-    switch (watcherType) {
+    switch (watcher->watcherData.watcherType) {
     case PATH_EXISTS_WATCHER:
         if (access(unit->pathExists, F_OK) == 0)
             execUnit = true;
         break;
     case PATH_EXISTS_GLOB_WATCHER:
-        completeEventName = stringNew(unit->pathExistsGlobMonitor);
-        stringAppendStr(&completeEventName, eventName);
-        if (fnmatch(unit->pathExistsGlob, completeEventName, 0) == 0)
-            execUnit = true;
+        /* The removals are only counted */
+        if (event->mask & (IN_CREATE | IN_MOVED_TO | IN_ATTRIB))
+            execUnit = isWatcherEntry(watcher, eventName);
         break;
     case PATH_RESOURCE_CHANGED_WATCHER:
         completeEventName = stringNew(unit->pathResourceChangedMonitor);
@@ -159,38 +533,246 @@ static bool checkUnitExecution(Unit *unit, WatcherType watcherType, const char *
             execUnit = true;
         break;
     case PATH_DIRECTORY_NOT_EMPTY_WATCHER:
-        execUnit = !isEmptyFolder(unit->pathDirectoryNotEmptyMonitor);
+        execUnit = watcher->entries->count > 0;
         break;
     default:
         break;
     }
-    if (execUnit) {
+
+    objectRelease(&completeEventName);
+    return execUnit;
+}
+
+static long getMonotonicMs()
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/* Wait until the deadline (monotonic milliseconds) is reached.
+ * Returns false if the trigger has been cancelled meanwhile by stopNotifier().
+ * The caller must own the watch mutex.
+*/
+static bool waitTrigger(Notifier *notifier, long deadline)
+{
+    struct timespec timeout = { 0 };
+    long left = 0;
+    int rv = 0;
+
+    while (*notifier->pending && (left = deadline - getMonotonicMs()) > 0) {
+        /* The condition variable uses the realtime clock thus the deadline is checked again */
+        clock_gettime(CLOCK_REALTIME, &timeout);
+        timeout.tv_sec += left / 1000;
+        timeout.tv_nsec += (left % 1000) * 1000000;
+        if (timeout.tv_nsec >= 1000000000) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000;
+        }
+        if ((rv = pthread_cond_timedwait(&WATCH_CV, &WATCH_MUTEX, &timeout)) != 0 &&
+            rv != ETIMEDOUT) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "waitTrigger", rv,
+                     strerror(rv), "Unable to wait for the watch condition variable");
+            kill(UNITD_PID, SIGTERM);
+            break;
+        }
+    }
+
+    return *notifier->pending;
+}
+
+/* Returns true if the unit can be executed now according to the trigger limit.
+ * The caller must own the watch mutex.
+*/
+static bool checkTriggerLimit(Unit *unit)
+{
+    Notifier *notifier = unit->notifier;
+    long now = 0, interval = 0;
+
+    if (!unit->triggerLimitBurst)
+        return true;
+    interval = (unit->triggerLimitIntervalSec ? *unit->triggerLimitIntervalSec : 1) * 1000;
+    now = getMonotonicMs();
+    if (now - *notifier->limitStart >= interval) {
+        *notifier->limitStart = now;
+        *notifier->triggers = 0;
+    }
+    if (*notifier->triggers >= *unit->triggerLimitBurst) {
+        logWarning(SYSTEM, "The '%s' unit hit the trigger limit. Deferring the execution ...",
+                   unit->name);
+        waitTrigger(notifier, *notifier->limitStart + interval);
+        return false;
+    }
+    (*notifier->triggers)++;
+
+    return true;
+}
+
+static void *startExecuteUnitThread(void *arg)
+{
+    Unit *unit = (Unit *)arg;
+    Notifier *notifier = unit->notifier;
+    long lastEvent = 0;
+
+    lockWatchTable(true);
+    while (*notifier->pending) {
+        /* Debounce: a new event restarts the quiet period */
+        if (unit->triggerQuietSec) {
+            do {
+                lastEvent = *notifier->lastEvent;
+            } while (waitTrigger(notifier, lastEvent + *unit->triggerQuietSec * 1000) &&
+                     *notifier->lastEvent != lastEvent);
+            if (!*notifier->pending)
+                break;
+        }
+        if (!checkTriggerLimit(unit))
+            continue;
+        *notifier->pending = false;
+        lockWatchTable(false);
+        /* The unit mutex could be owned by stopNotifier() which waits for us */
         *unit->processData->pStateData = PSTATE_DATA_ITEMS[RESTARTING];
+        refreshUnitSnapshot(unit);
         executeUnit(unit, UPATH);
         *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
+        refreshUnitSnapshot(unit);
+        lockWatchTable(true);
     }
+    *notifier->busy = false;
+    /* Wake up stopNotifier() */
+    pthread_cond_broadcast(&WATCH_CV);
+    lockWatchTable(false);
+    pthread_exit(0);
+}
 
-    objectRelease(&completeEventName);
-    return execUnit;
+/* Never blocks: the unit is marked as pending and executed by its own thread */
+static void triggerUnit(Unit *unit)
+{
+    pthread_t thread;
+    pthread_attr_t attr;
+    Notifier *notifier = unit->notifier;
+    int rv = 0;
+
+    *notifier->lastEvent = getMonotonicMs();
+    *notifier->pending = true;
+    if (*notifier->busy) {
+        /* Restart the quiet period */
+        if (unit->triggerQuietSec)
+            pthread_cond_broadcast(&WATCH_CV);
+        return;
+    }
+    if ((rv = pthread_attr_init(&attr)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "triggerUnit", rv,
+                 strerror(rv), "pthread_attr_init returned %d exit code", rv);
+        kill(UNITD_PID, SIGTERM);
+    }
+    if ((rv = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "triggerUnit", rv,
+                 strerror(rv), "pthread_attr_setdetachstate returned %d exit code", rv);
+        kill(UNITD_PID, SIGTERM);
+    }
+    if ((rv = pthread_create(&thread, &attr, startExecuteUnitThread, unit)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "triggerUnit", rv,
+                 strerror(rv), "Unable to create detached thread for '%s'", unit->name);
+        kill(UNITD_PID, SIGTERM);
+    } else
+        *notifier->busy = true;
+    pthread_attr_destroy(&attr);
+}
+
+static bool isUnitInArray(Array *units, Unit *unit)
+{
+    int len = units ? units->size : 0;
+    for (int i = 0; i < len; i++) {
+        if (arrayGet(units, i) == unit)
+            return true;
+    }
+
+    return false;
 }
 
-static WatcherType getWatcherTypeByWd(Array *watchers, int eventWd)
+/* Evaluating the watchers of the event.
+ * A path unit is triggered at most once for each read.
+ * The caller must own the watch mutex.
+*/
+static void handleEvent(struct inotify_event *event, Array *triggeredUnits)
 {
+    WatchEntry *watchEntry = NULL;
     Watcher *watcher = NULL;
-    int len = watchers ? watchers->size : 0;
+    WatcherType watcherType = -1;
+    Unit *unit = NULL;
+    int len = 0;
+
+    if (!(watchEntry = getWatchEntry(event->wd)))
+        return;
+    len = watchEntry->watchers->size;
     for (int i = 0; i < len; i++) {
-        watcher = arrayGet(watchers, i);
-        if (*watcher->wd == eventWd)
-            return watcher->watcherData.watcherType;
+        watcher = arrayGet(watchEntry->watchers, i);
+        if (!(event->mask & watcher->watcherData.mask))
+            continue;
+        updateWatcherEntries(watcher, event);
+        if (!event->len)
+            continue;
+        watcherType = watcher->watcherData.watcherType;
+        switch (watcherType) {
+        case UNITD_WATCHER:
+            checkUnitChanging(event->name);
+            break;
+        case PATH_EXISTS_WATCHER:
+        case PATH_EXISTS_GLOB_WATCHER:
+        case PATH_RESOURCE_CHANGED_WATCHER:
+        case PATH_DIRECTORY_NOT_EMPTY_WATCHER:
+            unit = watcher->unit;
+            if (!isUnitInArray(triggeredUnits, unit) && isUnitTriggered(watcher, event)) {
+                arrayAdd(triggeredUnits, unit);
+                triggerUnit(unit);
+            }
+            break;
+        default:
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "handleEvent", EPERM,
+                     strerror(EPERM), "No watcher type (%d) found!", watcherType);
+            kill(UNITD_PID, SIGTERM);
+            break;
+        }
     }
+}
+
+/* Some events have been lost thus we count the entries again.
+ * The units whose condition is satisfied are triggered.
+ * The caller must own the watch mutex.
+*/
+static void rescanWatchers(Array *triggeredUnits)
+{
+    WatchEntry *watchEntry = NULL;
+    Watcher *watcher = NULL;
+    int len = 0;
 
-    return -1;
+    logWarning(SYSTEM, "The inotify queue overflowed. Rescanning the watched folders ...");
+    for (int i = 0; i < WATCH_TABLE->size; i++) {
+        for (watchEntry = WATCH_TABLE->buckets[i]; watchEntry; watchEntry = watchEntry->next) {
+            len = watchEntry->watchers->size;
+            for (int j = 0; j < len; j++) {
+                watcher = arrayGet(watchEntry->watchers, j);
+                if (!hasWatcherEntries(watcher))
+                    continue;
+                scanWatcherEntries(watcher);
+                if (watcher->entries->count > 0 &&
+                    !isUnitInArray(triggeredUnits, watcher->unit)) {
+                    arrayAdd(triggeredUnits, watcher->unit);
+                    triggerUnit(watcher->unit);
+                }
+            }
+        }
+    }
 }
 
 Notifier *notifierNew()
 {
     Notifier *notifier = NULL;
     int *fd = NULL;
+    bool *busy = NULL, *pending = NULL;
+    long *lastEvent = NULL, *limitStart = NULL;
+    int *triggers = NULL;
 
     notifier = calloc(1, sizeof(Notifier));
     assert(notifier);
@@ -198,8 +780,22 @@ Notifier *notifierNew()
     assert(fd);
     *fd = -1;
     notifier->fd = fd;
-    notifier->pipe = pipeNew();
     notifier->watchers = arrayNew(watcherRelease);
+    busy = calloc(1, sizeof(bool));
+    assert(busy);
+    notifier->busy = busy;
+    pending = calloc(1, sizeof(bool));
+    assert(pending);
+    notifier->pending = pending;
+    lastEvent = calloc(1, sizeof(long));
+    assert(lastEvent);
+    notifier->lastEvent = lastEvent;
+    limitStart = calloc(1, sizeof(long));
+    assert(limitStart);
+    notifier->limitStart = limitStart;
+    triggers = calloc(1, sizeof(int));
+    assert(triggers);
+    notifier->triggers = triggers;
 
     return notifier;
 }
@@ -211,6 +807,11 @@ void notifierRelease(Notifier **notifier)
         notifierClose(notifierTemp);
         arrayRelease(&notifierTemp->watchers);
         objectRelease(&notifierTemp->fd);
+        objectRelease(&notifierTemp->busy);
+        objectRelease(&notifierTemp->pending);
+        objectRelease(&notifierTemp->lastEvent);
+        objectRelease(&notifierTemp->limitStart);
+        objectRelease(&notifierTemp->triggers);
         pipeRelease(&notifierTemp->pipe);
         objectRelease(notifier);
     }
@@ -232,6 +833,8 @@ Watcher *watcherNew(Notifier *notifier, const char *path, WatcherType watcherTyp
     assert(wd);
     *wd = -1;
     watcher->wd = wd;
+    watcher->unit = NULL;
+    watcher->entries = entrySetNew(ENTRY_SET_SIZE);
 
     return watcher;
 }
@@ -240,31 +843,26 @@ void watcherRelease(Watcher **watcher)
 {
     if (*watcher) {
         objectRelease(&(*watcher)->wd);
+        entrySetRelease(&(*watcher)->entries);
         objectRelease(&(*watcher)->path);
         objectRelease(watcher);
     }
 }
 
-void *startNotifierThread(void *arg)
+void *startNotifierThread(void *arg UNUSED)
 {
-    int rv = 0, length = 0, i = 0, input, maxFd = -1, allEvents = 0, *fd, *fdPipe;
-    char buffer[EVENT_BUF_LEN] = { 0 };
-    fd_set fds;
+    int rv = 0, length = 0, i = 0, input, epollFd = -1, nfds = 0, *fd, *fdPipe;
+    char buffer[EVENT_BUF_LEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct epoll_event epollEvent = { 0 }, epollEvents[2];
+    struct inotify_event *event = NULL;
     Pipe *pipe = NULL;
-    Array *watchers = NULL;
-    Notifier *notifier = NULL;
-    Unit *unit = NULL;
-    bool executedUnit = false;
+    Array *triggeredUnits = NULL;
 
-    unit = (Unit *)arg;
-    notifier = unit ? unit->notifier : NOTIFIER;
-
-    assert(notifier);
+    assert(NOTIFIER);
 
-    pipe = notifier->pipe;
-    fd = notifier->fd;
-    watchers = notifier->watchers;
-    assert(watchers);
+    pipe = NOTIFIER->pipe;
+    fd = NOTIFIER->fd;
+    fdPipe = &pipe->fds[0];
     if ((rv = pthread_mutex_lock(pipe->mutex)) != 0) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", rv,
                  strerror(rv), "Unable to acquire the pipe mutex lock");
@@ -277,82 +875,72 @@ void *startNotifierThread(void *arg)
         msleep(50);
     if (SHUTDOWN_COMMAND != NO_COMMAND)
         goto out;
-    fdPipe = &pipe->fds[0];
-    maxFd = getMaxFileDesc(fd, fdPipe);
-    /* At least one watcher must be here. */
-    if ((length = watchers->size) == 0) {
-        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", rv,
-                 strerror(rv), "No watcher found!");
+    if ((epollFd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", errno,
+                 strerror(errno), "Epoll_create1 func returned -1");
         kill(UNITD_PID, SIGTERM);
         goto out;
     }
-    /* Building and checking the events */
-    for (i = 0; i < length; i++)
-        allEvents |= ((Watcher *)arrayGet(watchers, i))->watcherData.mask;
-    if (allEvents == 0) {
-        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", rv,
-                 strerror(rv), "No event found!");
+    epollEvent.events = EPOLLIN;
+    epollEvent.data.fd = *fdPipe;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, *fdPipe, &epollEvent) == -1 ||
+        (epollEvent.data.fd = *fd, epoll_ctl(epollFd, EPOLL_CTL_ADD, *fd, &epollEvent)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", errno,
+                 strerror(errno), "Epoll_ctl func returned -1");
         kill(UNITD_PID, SIGTERM);
         goto out;
     }
     while (1) {
-        FD_ZERO(&fds);
-        FD_SET(*fdPipe, &fds);
-        FD_SET(*fd, &fds);
-        executedUnit = false;
-        if (select(maxFd, &fds, NULL, NULL, NULL) == -1 && errno == EINTR)
-            continue;
-        if (FD_ISSET(*fdPipe, &fds)) {
-            if ((length = uRead(*fdPipe, &input, sizeof(int))) == -1) {
-                logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread",
-                         errno, strerror(errno), "Unable to read from pipe for the notifier!");
-                kill(UNITD_PID, SIGTERM);
+        if ((nfds = epoll_wait(epollFd, epollEvents, 2, -1)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread",
+                     errno, strerror(errno), "Epoll_wait func returned -1");
+            kill(UNITD_PID, SIGTERM);
+            goto out;
+        }
+        for (int j = 0; j < nfds; j++) {
+            if (epollEvents[j].data.fd == *fdPipe) {
+                if ((length = uRead(*fdPipe, &input, sizeof(int))) == -1) {
+                    logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c",
+                             "startNotifierThread", errno, strerror(errno),
+                             "Unable to read from pipe for the notifier!");
+                    kill(UNITD_PID, SIGTERM);
+                }
+                if (input == THREAD_EXIT)
+                    goto out;
+                continue;
             }
-            if (input == THREAD_EXIT)
-                goto out;
-        } else if (FD_ISSET(*fd, &fds)) {
-            if ((length = uRead(*fd, buffer, EVENT_BUF_LEN)) == -1) {
-                logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread",
-                         errno, strerror(errno),
+            if ((length = read(*fd, buffer, EVENT_BUF_LEN)) == -1) {
+                if (errno == EINTR)
+                    continue;
+                logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c",
+                         "startNotifierThread", errno, strerror(errno),
                          "Unable to read from inotify fd for the notifier!");
                 kill(UNITD_PID, SIGTERM);
+                goto out;
             }
-            /* Evaluating all events defined by watchers. */
-            i = 0;
-            while (i < length) {
-                /* If the unit has been executed then break and restart. */
-                if (executedUnit)
-                    break;
-                struct inotify_event *event = (struct inotify_event *)&buffer[i];
+            /* Evaluating all events */
+            triggeredUnits = arrayNew(NULL);
+            lockWatchTable(true);
+            for (i = 0; i < length; i += EVENT_SIZE + event->len) {
+                event = (struct inotify_event *)&buffer[i];
                 if (DEBUG)
                     logInfo(SYSTEM, "Event: name = %s, length = %d, wd = %d, mask = %d",
-                            event->name, event->len, event->wd, event->mask);
-                if (event->len && (event->mask & allEvents)) {
-                    WatcherType watcherType = getWatcherTypeByWd(watchers, event->wd);
-                    switch (watcherType) {
-                    case UNITD_WATCHER:
-                        checkUnitChanging(event->name);
-                        break;
-                    case PATH_EXISTS_WATCHER:
-                    case PATH_EXISTS_GLOB_WATCHER:
-                    case PATH_RESOURCE_CHANGED_WATCHER:
-                    case PATH_DIRECTORY_NOT_EMPTY_WATCHER:
-                        executedUnit = checkUnitExecution(unit, watcherType, event->name);
-                        break;
-                    default:
-                        logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c",
-                                 "startNotifierThread", EPERM, strerror(EPERM),
-                                 "No watcher type (%d) found!", watcherType);
-                        kill(UNITD_PID, SIGTERM);
-                        break;
-                    }
-                }
-                i += EVENT_SIZE + event->len;
+                            event->len ? event->name : "", event->len, event->wd, event->mask);
+                if (event->mask & IN_Q_OVERFLOW)
+                    rescanWatchers(triggeredUnits);
+                else
+                    handleEvent(event, triggeredUnits);
             }
+            lockWatchTable(false);
+            arrayRelease(&triggeredUnits);
         }
     }
 
 out:
+    if (epollFd != -1)
+        close(epollFd);
     if ((rv = pthread_mutex_unlock(pipe->mutex)) != 0) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifierThread", rv,
                  strerror(rv), "Unable to unlock the pipe mutex");
@@ -367,6 +955,7 @@ void setUnitdNotifier()
     int rv = 0;
     assert(!NOTIFIER);
     NOTIFIER = notifierNew();
+    NOTIFIER->pipe = pipeNew();
     Array *watchers = NOTIFIER->watchers;
     if (!USER_INSTANCE)
         arrayAdd(watchers, watcherNew(NOTIFIER, UNITS_PATH, UNITD_WATCHER));
@@ -379,19 +968,74 @@ void setUnitdNotifier()
         kill(UNITD_PID, SIGTERM);
 }
 
+/* The path unit watchers are added to the unitd inotify instance */
+static int startPathUnitNotifier(Unit *unit)
+{
+    Array *watchers = NULL;
+    int rv = 0, len = 0;
+
+    assert(unit->notifier);
+
+    watchers = unit->notifier->watchers;
+    len = watchers->size;
+    lockWatchTable(true);
+    for (int i = 0; i < len; i++) {
+        if ((rv = addWatcher(arrayGet(watchers, i), unit)) != 0) {
+            for (int j = 0; j < i; j++)
+                removeWatcher(arrayGet(watchers, j));
+            break;
+        }
+    }
+    lockWatchTable(false);
+    if (rv == 0)
+        *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
+
+    return rv;
+}
+
+/* Remove the path unit watchers and wait for its execution */
+static int stopPathUnitNotifier(Unit *unit)
+{
+    Notifier *notifier = unit->notifier;
+    Array *watchers = NULL;
+    Watcher *watcher = NULL;
+    int len = 0, rv = 0;
+
+    if (!notifier)
+        return rv;
+    watchers = notifier->watchers;
+    len = watchers->size;
+    lockWatchTable(true);
+    for (int i = 0; i < len; i++) {
+        watcher = arrayGet(watchers, i);
+        if (*watcher->wd != -1)
+            removeWatcher(watcher);
+    }
+    /* Cancel the pending trigger and wake up a waiting execution */
+    *notifier->pending = false;
+    pthread_cond_broadcast(&WATCH_CV);
+    while (*notifier->busy) {
+        if ((rv = pthread_cond_wait(&WATCH_CV, &WATCH_MUTEX)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "stopPathUnitNotifier",
+                     rv, strerror(rv), "Unable to wait for the watch condition variable");
+            kill(UNITD_PID, SIGTERM);
+            break;
+        }
+    }
+    lockWatchTable(false);
+
+    return rv;
+}
+
 int startNotifier(Unit *unit)
 {
     int rv = 0;
     pthread_t thread;
     pthread_attr_t attr;
-    Notifier *notifier = NULL;
 
-    if (!unit) {
-        setUnitdNotifier();
-        notifier = NOTIFIER;
-    } else
-        notifier = unit->notifier;
-    assert(notifier);
+    if (unit)
+        return startPathUnitNotifier(unit);
+    setUnitdNotifier();
     if ((rv = pthread_attr_init(&attr)) != 0) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifier", errno,
                  strerror(errno), "pthread_attr_init returned %d exit code", rv);
@@ -402,7 +1046,7 @@ int startNotifier(Unit *unit)
                  strerror(errno), "pthread_attr_setdetachstate returned %d exit code", rv);
         kill(UNITD_PID, SIGTERM);
     }
-    if ((rv = pthread_create(&thread, &attr, startNotifierThread, unit)) != 0) {
+    if ((rv = pthread_create(&thread, &attr, startNotifierThread, NULL)) != 0) {
         logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "startNotifier", rv,
                  strerror(rv), "Unable to create detached thread");
         kill(UNITD_PID, SIGTERM);
@@ -411,8 +1055,6 @@ int startNotifier(Unit *unit)
             logInfo(CONSOLE | SYSTEM, "Thread created successfully for the notifier\n");
     }
     pthread_attr_destroy(&attr);
-    if (unit && rv == 0)
-        *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
 
     return rv;
 }
@@ -420,10 +1062,11 @@ int startNotifier(Unit *unit)
 int stopNotifier(Unit *unit)
 {
     int rv = 0, output = THREAD_EXIT;
-    Notifier *notifier = !unit ? NOTIFIER : unit->notifier;
 
-    if (notifier) {
-        Pipe *pipe = notifier->pipe;
+    if (unit)
+        return stopPathUnitNotifier(unit);
+    if (NOTIFIER) {
+        Pipe *pipe = NOTIFIER->pipe;
         if ((rv = uWrite(pipe->fds[1], &output, sizeof(int))) == -1) {
             logError(CONSOLE | SYSTEM, "src/core/handlers/notifier.c", "stopNotifier", errno,
                      strerror(errno), "Unable to write into pipe for the notifier");
@@ -19,22 +19,53 @@ typedef struct {
     int mask;
 } WatcherData;
 
+#define WATCH_TABLE_SIZE 64
+#define ENTRY_SET_SIZE 64
+
+typedef struct NameEntry {
+    char *name;
+    struct NameEntry *next;
+} NameEntry;
+
+typedef struct {
+    NameEntry **buckets;
+    int size;
+    int count;
+} EntrySet;
+
 typedef struct {
     int *wd;
     char *path;
     WatcherData watcherData;
+    Unit *unit;
+    EntrySet *entries;
 } Watcher;
 
+typedef struct WatchEntry {
+    int wd;
+    Array *watchers;
+    struct WatchEntry *next;
+} WatchEntry;
+
+typedef struct {
+    WatchEntry **buckets;
+    int size;
+    int count;
+} WatchTable;
+
 extern const WatcherData WATCHER_DATA_ITEMS[];
 extern Notifier *NOTIFIER;
 extern bool NOTIFIER_WORKING;
 
 Notifier *notifierNew();
 int notifierInit(Notifier *);
+int checkWatcherPaths(Notifier *);
 void notifierRelease(Notifier **);
 void notifierClose(Notifier *);
 Watcher *watcherNew(Notifier *, const char *, WatcherType);
 void watcherRelease(Watcher **);
+void updateWatcherEntries(Watcher *, struct inotify_event *);
+bool isUnitTriggered(Watcher *, struct inotify_event *);
 void setUnitdNotifier();
 int startNotifier(Unit *);
 void *startNotifierThread(void *);
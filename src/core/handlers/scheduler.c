@@ -0,0 +1,856 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitd_impl.h"
+
+/* TIMER SCHEDULER
+
+All the timer units are handled by a single scheduler thread.
+The armed timers are kept into a min-heap ordered by expiration time (CLOCK_BOOTTIME)
+and only the first one arms a timerfd.
+The timers which have to wake the system are kept into a second heap whose timerfd
+uses the CLOCK_BOOTTIME_ALARM clock.
+When a timer expires, the scheduler thread queues a job.
+The jobs are executed by the workers because the execution of a unit can take a long time.
+The workers are created on demand and at most SCHEDULER_MAX_IDLE_WORKERS of them
+wait for the next jobs.
+A timer is handled by one worker at a time (busy flag).
+The expiration of a timer can be delayed up to its accuracy (AccuracySec) to share the wakeups.
+The expiry is the last second of the accuracy window which is a multiple of the largest step
+(hour, minute, ten seconds) so the timers with overlapping windows expire together.
+Moreover, when a wakeup occurs, all the timers whose window is already started expire with it.
+The persistent timers which are expired while the system was down are not executed at once.
+They are armed again with a random delay (TIMERS_CATCHUP_SPREAD) and, when it expires,
+they wait for a free slot because at most TIMERS_CATCHUP_MAX of them are executed concurrently.
+The calendar timers depend on the realtime clock. A CLOCK_REALTIME timerfd which never expires
+is armed with TFD_TIMER_CANCEL_ON_SET so the scheduler is notified when the clock is set
+and the next time of the calendar timers is computed again in the current timezone.
+
+*/
+
+Scheduler *SCHEDULER;
+int TIMERS_CATCHUP_MAX = SCHEDULER_CATCHUP_MAX;
+int TIMERS_CATCHUP_SPREAD = SCHEDULER_CATCHUP_SPREAD;
+
+static void lockScheduler(bool lock)
+{
+    int rv = 0;
+
+    if (lock) {
+        if ((rv = pthread_mutex_lock(SCHEDULER->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "lockScheduler", rv,
+                     strerror(rv), "Unable to acquire the lock of the scheduler mutex");
+            kill(UNITD_PID, SIGTERM);
+        }
+    } else {
+        if ((rv = pthread_mutex_unlock(SCHEDULER->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "lockScheduler", rv,
+                     strerror(rv), "Unable to unlock the scheduler mutex");
+            kill(UNITD_PID, SIGTERM);
+        }
+    }
+}
+
+static void broadcastScheduler()
+{
+    int rv = 0;
+
+    if ((rv = pthread_cond_broadcast(SCHEDULER->cv)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "broadcastScheduler", rv,
+                 strerror(rv), "Unable to send the broadcast signal for the scheduler");
+        kill(UNITD_PID, SIGTERM);
+    }
+}
+
+static void waitScheduler()
+{
+    int rv = 0;
+
+    if ((rv = pthread_cond_wait(SCHEDULER->cv, SCHEDULER->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "waitScheduler", rv,
+                 strerror(rv), "Unable to wait for the scheduler condition variable");
+        kill(UNITD_PID, SIGTERM);
+    }
+}
+
+static TimerHeap *timerHeapNew(clockid_t clockId)
+{
+    TimerHeap *timerHeap = calloc(1, sizeof(TimerHeap));
+    assert(timerHeap);
+    timerHeap->capacity = SCHEDULER_HEAP_SIZE;
+    timerHeap->units = calloc(timerHeap->capacity, sizeof(Unit *));
+    assert(timerHeap->units);
+    timerHeap->size = 0;
+    timerHeap->fd = timerfd_create(clockId, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    return timerHeap;
+}
+
+static void timerHeapRelease(TimerHeap **timerHeap)
+{
+    if (*timerHeap) {
+        if ((*timerHeap)->fd != -1)
+            close((*timerHeap)->fd);
+        objectRelease(&(*timerHeap)->units);
+        objectRelease(timerHeap);
+    }
+}
+
+static bool expiresBefore(Unit *unit, Unit *otherUnit)
+{
+    struct timespec *expiry = unit->timer->expiry, *otherExpiry = otherUnit->timer->expiry;
+
+    return expiry->tv_sec < otherExpiry->tv_sec ||
+           (expiry->tv_sec == otherExpiry->tv_sec && expiry->tv_nsec < otherExpiry->tv_nsec);
+}
+
+static void timerHeapSet(TimerHeap *timerHeap, int idx, Unit *unit)
+{
+    timerHeap->units[idx] = unit;
+    *unit->timer->heapIdx = idx;
+}
+
+static void timerHeapSiftUp(TimerHeap *timerHeap, int idx)
+{
+    Unit *unit = timerHeap->units[idx];
+    int parent = 0;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (!expiresBefore(unit, timerHeap->units[parent]))
+            break;
+        timerHeapSet(timerHeap, idx, timerHeap->units[parent]);
+        idx = parent;
+    }
+    timerHeapSet(timerHeap, idx, unit);
+}
+
+static void timerHeapSiftDown(TimerHeap *timerHeap, int idx)
+{
+    Unit *unit = timerHeap->units[idx];
+    int child = 0;
+
+    while ((child = 2 * idx + 1) < timerHeap->size) {
+        if (child + 1 < timerHeap->size &&
+            expiresBefore(timerHeap->units[child + 1], timerHeap->units[child]))
+            child++;
+        if (!expiresBefore(timerHeap->units[child], unit))
+            break;
+        timerHeapSet(timerHeap, idx, timerHeap->units[child]);
+        idx = child;
+    }
+    timerHeapSet(timerHeap, idx, unit);
+}
+
+static void timerHeapPush(TimerHeap *timerHeap, Unit *unit)
+{
+    if (timerHeap->size == timerHeap->capacity) {
+        timerHeap->capacity *= 2;
+        timerHeap->units = realloc(timerHeap->units, timerHeap->capacity * sizeof(Unit *));
+        assert(timerHeap->units);
+    }
+    timerHeap->units[timerHeap->size++] = unit;
+    timerHeapSiftUp(timerHeap, timerHeap->size - 1);
+}
+
+static void timerHeapRemove(TimerHeap *timerHeap, int idx)
+{
+    Unit *last = NULL;
+
+    assert(idx >= 0 && idx < timerHeap->size);
+
+    *timerHeap->units[idx]->timer->heapIdx = -1;
+    last = timerHeap->units[--timerHeap->size];
+    if (idx < timerHeap->size) {
+        timerHeapSet(timerHeap, idx, last);
+        timerHeapSiftDown(timerHeap, idx);
+        timerHeapSiftUp(timerHeap, *last->timer->heapIdx);
+    }
+}
+
+/* The heap is the same for the whole life of the unit because it only depends on
+ * the WakeSystem property.
+*/
+static TimerHeap *getTimerHeap(Unit *unit)
+{
+    if (unit->wakeSystem && *unit->wakeSystem && SCHEDULER->alarmHeap->fd != -1)
+        return SCHEDULER->alarmHeap;
+
+    return SCHEDULER->heap;
+}
+
+/* Arms the timerfd with the first expiration or disarms it if the heap is empty */
+static void setTimerHeapFd(TimerHeap *timerHeap)
+{
+    struct itimerspec its = { 0 };
+
+    if (timerHeap->fd == -1)
+        return;
+    if (timerHeap->size > 0) {
+        its.it_value = *timerHeap->units[0]->timer->expiry;
+        /* A zero value would disarm the timerfd */
+        if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+            its.it_value.tv_nsec = 1;
+    }
+    if (timerfd_settime(timerHeap->fd, TFD_TIMER_ABSTIME, &its, NULL) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "setTimerHeapFd", errno,
+                 strerror(errno), "Unable to set the timerfd");
+        kill(UNITD_PID, SIGTERM);
+    }
+}
+
+/* Arms the clock timerfd to be notified when the realtime clock is set */
+static void setClockFd(int clockFd)
+{
+    struct itimerspec its = { 0 };
+
+    if (clockFd == -1)
+        return;
+    its.it_value.tv_sec = LONG_MAX;
+    if (timerfd_settime(clockFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL) ==
+        -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "setClockFd", errno,
+                 strerror(errno), "Unable to set the clock timerfd");
+        kill(UNITD_PID, SIGTERM);
+    }
+}
+
+static void removeTimerJobs(Unit *unit)
+{
+    TimerJob *timerJob = NULL;
+
+    for (int i = SCHEDULER->jobs->size - 1; i >= 0; i--) {
+        timerJob = arrayGet(SCHEDULER->jobs, i);
+        if (timerJob->unit == unit) {
+            if (timerJob->type == TIMER_CATCHUP_JOB)
+                SCHEDULER->catchUpJobs--;
+            arrayRemoveAt(SCHEDULER->jobs, i);
+        }
+    }
+}
+
+/* The caller must own the scheduler mutex */
+static void dispatchTimerJobs()
+{
+    pthread_t thread;
+    pthread_attr_t attr;
+    int rv = 0;
+
+    if (!SCHEDULER->running || SCHEDULER->exit || SCHEDULER->jobs->size == 0)
+        return;
+    if (SCHEDULER->idleWorkers < SCHEDULER->jobs->size) {
+        if ((rv = pthread_attr_init(&attr)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "dispatchTimerJobs", rv,
+                     strerror(rv), "pthread_attr_init returned bad exit code %d", rv);
+            kill(UNITD_PID, SIGTERM);
+        }
+        if ((rv = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "dispatchTimerJobs", rv,
+                     strerror(rv), "pthread_attr_setdetachstate returned bad exit code %d", rv);
+            kill(UNITD_PID, SIGTERM);
+        }
+        while (SCHEDULER->idleWorkers < SCHEDULER->jobs->size) {
+            if ((rv = pthread_create(&thread, &attr, startSchedulerWorker, NULL)) != 0) {
+                logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "dispatchTimerJobs",
+                         rv, strerror(rv), "Unable to create the scheduler worker (detached)");
+                kill(UNITD_PID, SIGTERM);
+                break;
+            }
+            /* A new worker is idle until it picks a job */
+            SCHEDULER->numWorkers++;
+            SCHEDULER->idleWorkers++;
+        }
+        pthread_attr_destroy(&attr);
+    }
+    broadcastScheduler();
+}
+
+/* The caller must own the scheduler mutex */
+static void addTimerJob(Unit *unit, TimerJobType type)
+{
+    TimerJob *timerJob = calloc(1, sizeof(TimerJob));
+    assert(timerJob);
+    timerJob->unit = unit;
+    timerJob->type = type;
+    arrayAdd(SCHEDULER->jobs, timerJob);
+    dispatchTimerJobs();
+}
+
+/* Queue the jobs of the expired catch-ups while there are free slots.
+ * The caller must own the scheduler mutex.
+*/
+static void dispatchCatchUps()
+{
+    Unit *unit = NULL;
+
+    while (SCHEDULER->catchUps->size > 0 && SCHEDULER->catchUpJobs < TIMERS_CATCHUP_MAX) {
+        unit = arrayGet(SCHEDULER->catchUps, 0);
+        arrayRemoveAt(SCHEDULER->catchUps, 0);
+        SCHEDULER->catchUpJobs++;
+        addTimerJob(unit, TIMER_CATCHUP_JOB);
+    }
+}
+
+/* Returns the expiry in seconds within the accuracy window */
+static long alignExpiry(long earliest, int accuracy)
+{
+    static const long STEPS[] = { 3600, 60, 10, 1 };
+    long latest = earliest + accuracy, aligned = 0;
+
+    for (int i = 0; i < 4; i++) {
+        aligned = latest - latest % STEPS[i];
+        if (aligned >= earliest)
+            return aligned;
+    }
+
+    return earliest;
+}
+
+/* The first expired timer of a wakeup needs it, the other ones share it. */
+static void addExpiredTimer(Unit *unit, int *expired)
+{
+    if ((*expired)++ > 0)
+        (*unit->wakeupsSaved)++;
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "Scheduler::'%s' timer expired", unit->name);
+    addTimerJob(unit, TIMER_EXPIRED_JOB);
+}
+
+/* Moves the expired timers of the heap into the jobs queue.
+ * The caller must own the scheduler mutex.
+*/
+static void expireTimerHeap(TimerHeap *timerHeap, struct timespec *now, int *expired)
+{
+    Unit *unit = NULL;
+
+    while (timerHeap->size > 0) {
+        unit = timerHeap->units[0];
+        if (unit->timer->expiry->tv_sec > now->tv_sec ||
+            (unit->timer->expiry->tv_sec == now->tv_sec &&
+             unit->timer->expiry->tv_nsec > now->tv_nsec))
+            break;
+        timerHeapRemove(timerHeap, 0);
+        if (*unit->timer->catchUp != -1) {
+            arrayAdd(SCHEDULER->catchUps, unit);
+            continue;
+        }
+        addExpiredTimer(unit, expired);
+    }
+}
+
+/* Expire the timers whose accuracy window is already started.
+ * They are not ordered by the earliest time so we collect them before removing.
+ * The caller must own the scheduler mutex.
+*/
+static void coalesceTimers(struct timespec *now, int *expired)
+{
+    TimerHeap *heaps[2] = { SCHEDULER->heap, SCHEDULER->alarmHeap };
+    Array *coalescedUnits = arrayNew(NULL);
+    Unit *unit = NULL;
+    int len = 0;
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < heaps[i]->size; j++) {
+            unit = heaps[i]->units[j];
+            if (*unit->timer->earliest <= now->tv_sec && *unit->timer->catchUp == -1)
+                arrayAdd(coalescedUnits, unit);
+        }
+    }
+    len = coalescedUnits->size;
+    for (int i = 0; i < len; i++) {
+        unit = arrayGet(coalescedUnits, i);
+        timerHeapRemove(getTimerHeap(unit), *unit->timer->heapIdx);
+        addExpiredTimer(unit, expired);
+    }
+    arrayRelease(&coalescedUnits);
+}
+
+/* The caller must own the scheduler mutex */
+static void expireTimers()
+{
+    struct timespec now = { 0 };
+    int expired = 0;
+
+    if (clock_gettime(CLOCK_BOOTTIME, &now) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "expireTimers", errno,
+                 strerror(errno), "Unable to get the boot time");
+        kill(UNITD_PID, SIGTERM);
+        return;
+    }
+    expireTimerHeap(SCHEDULER->heap, &now, &expired);
+    expireTimerHeap(SCHEDULER->alarmHeap, &now, &expired);
+    if (expired > 0)
+        coalesceTimers(&now, &expired);
+    dispatchCatchUps();
+    setTimerHeapFd(SCHEDULER->heap);
+    setTimerHeapFd(SCHEDULER->alarmHeap);
+}
+
+/* The realtime clock has been set.
+ * The workers compute the next time of the calendar timers again (see rearmTimerUnit()).
+ * The caller must own the scheduler mutex.
+*/
+static void handleClockChange()
+{
+    TimerHeap *heaps[2] = { SCHEDULER->heap, SCHEDULER->alarmHeap };
+    Array *calendarUnits = arrayNew(NULL);
+    Unit *unit = NULL;
+    int len = 0;
+
+    /* The timezone could have been changed as well */
+    tzset();
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < heaps[i]->size; j++) {
+            unit = heaps[i]->units[j];
+            /* The catch-up delay doesn't depend on the realtime clock */
+            if (unit->calendar && *unit->timer->catchUp == -1)
+                arrayAdd(calendarUnits, unit);
+        }
+    }
+    len = calendarUnits->size;
+    for (int i = 0; i < len; i++) {
+        unit = arrayGet(calendarUnits, i);
+        timerHeapRemove(getTimerHeap(unit), *unit->timer->heapIdx);
+        addTimerJob(unit, TIMER_CLOCK_JOB);
+    }
+    setTimerHeapFd(heaps[0]);
+    setTimerHeapFd(heaps[1]);
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "Scheduler::the clock has been set. %d timers rearmed",
+               len);
+    arrayRelease(&calendarUnits);
+}
+
+Scheduler *schedulerNew()
+{
+    Scheduler *scheduler = NULL;
+    pthread_mutex_t *mutex = NULL;
+    pthread_cond_t *cv = NULL;
+    int rv = 0;
+
+    scheduler = calloc(1, sizeof(Scheduler));
+    assert(scheduler);
+    scheduler->heap = timerHeapNew(CLOCK_BOOTTIME);
+    if (scheduler->heap->fd == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerNew", errno,
+                 strerror(errno), "Unable to create the timerfd");
+        kill(UNITD_PID, SIGTERM);
+    }
+    /* Waking the system requires the CAP_WAKE_ALARM capability (user instances).
+     * If it's missing then all the timers will use the first heap.
+    */
+    scheduler->alarmHeap = timerHeapNew(CLOCK_BOOTTIME_ALARM);
+    if (scheduler->alarmHeap->fd == -1 && DEBUG)
+        logWarning(SYSTEM, "Unable to create the alarm timerfd (%s). WakeSystem is ignored.",
+                   strerror(errno));
+    scheduler->clockFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (scheduler->clockFd == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerNew", errno,
+                 strerror(errno), "Unable to create the clock timerfd");
+        kill(UNITD_PID, SIGTERM);
+    }
+    setClockFd(scheduler->clockFd);
+    scheduler->jobs = arrayNew(objectRelease);
+    scheduler->catchUps = arrayNew(NULL);
+    scheduler->seed = time(NULL) ^ getpid();
+    /* Initialize mutex */
+    mutex = calloc(1, sizeof(pthread_mutex_t));
+    assert(mutex);
+    scheduler->mutex = mutex;
+    if ((rv = pthread_mutex_init(mutex, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerNew", rv,
+                 strerror(rv), "Unable to run pthread_mutex_init");
+        kill(UNITD_PID, SIGTERM);
+    }
+    /* Initialize condition variable */
+    cv = calloc(1, sizeof(pthread_cond_t));
+    assert(cv);
+    scheduler->cv = cv;
+    if ((rv = pthread_cond_init(cv, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerNew", rv,
+                 strerror(rv), "Unable to run pthread_cond_init");
+        kill(UNITD_PID, SIGTERM);
+    }
+    scheduler->numWorkers = scheduler->idleWorkers = 0;
+    scheduler->running = scheduler->exit = false;
+    scheduler->pipe = pipeNew();
+
+    return scheduler;
+}
+
+void schedulerRelease(Scheduler **scheduler)
+{
+    Scheduler *schedulerTemp = *scheduler;
+    int rv = 0;
+
+    if (schedulerTemp) {
+        timerHeapRelease(&schedulerTemp->heap);
+        timerHeapRelease(&schedulerTemp->alarmHeap);
+        if (schedulerTemp->clockFd != -1)
+            close(schedulerTemp->clockFd);
+        arrayRelease(&schedulerTemp->jobs);
+        arrayRelease(&schedulerTemp->catchUps);
+        if ((rv = pthread_cond_destroy(schedulerTemp->cv)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerRelease", rv,
+                     strerror(rv), "Unable to run pthread_cond_destroy");
+        }
+        objectRelease(&schedulerTemp->cv);
+        if ((rv = pthread_mutex_destroy(schedulerTemp->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "schedulerRelease", rv,
+                     strerror(rv), "Unable to run pthread_mutex_destroy");
+        }
+        objectRelease(&schedulerTemp->mutex);
+        pipeRelease(&schedulerTemp->pipe);
+        objectRelease(scheduler);
+    }
+}
+
+void *startSchedulerThread(void *arg UNUSED)
+{
+    int rv = 0, input = 0, nfds = 0, clockIdx = -1;
+    uint64_t expirations = 0;
+    struct pollfd fds[4];
+    Pipe *pipe = NULL;
+    TimerHeap *heaps[2];
+
+    pipe = SCHEDULER->pipe;
+    heaps[0] = SCHEDULER->heap;
+    heaps[1] = SCHEDULER->alarmHeap;
+    if ((rv = pthread_mutex_lock(pipe->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startSchedulerThread", rv,
+                 strerror(rv), "Unable to lock the pipe mutex");
+        kill(UNITD_PID, SIGTERM);
+    }
+    /* Before to start, we wait for system is up.
+     * We check if ctrl+alt+del is pressed as well.
+    */
+    while (!LISTEN_SOCK_REQUEST && SHUTDOWN_COMMAND == NO_COMMAND)
+        msleep(50);
+    if (SHUTDOWN_COMMAND != NO_COMMAND)
+        goto out;
+    /* Run the timers which have been started meanwhile */
+    lockScheduler(true);
+    SCHEDULER->running = true;
+    dispatchTimerJobs();
+    lockScheduler(false);
+    while (1) {
+        nfds = 0;
+        fds[nfds].fd = pipe->fds[0];
+        fds[nfds++].events = POLLIN;
+        for (int i = 0; i < 2; i++) {
+            if (heaps[i]->fd != -1) {
+                fds[nfds].fd = heaps[i]->fd;
+                fds[nfds++].events = POLLIN;
+            }
+        }
+        clockIdx = nfds;
+        fds[nfds].fd = SCHEDULER->clockFd;
+        fds[nfds++].events = POLLIN;
+        if (poll(fds, nfds, -1) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startSchedulerThread",
+                     errno, strerror(errno), "Unable to poll the timerfds");
+            kill(UNITD_PID, SIGTERM);
+            goto out;
+        }
+        if (fds[0].revents & POLLIN) {
+            if ((rv = uRead(fds[0].fd, &input, sizeof(int))) == -1) {
+                logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c",
+                         "startSchedulerThread", errno, strerror(errno),
+                         "Unable to read from pipe for the scheduler!");
+                kill(UNITD_PID, SIGTERM);
+                goto out;
+            }
+            if (input == THREAD_EXIT)
+                goto out;
+        }
+        /* Consume the expirations. The timerfds are not blocking. */
+        for (int i = 1; i < clockIdx; i++) {
+            if (fds[i].revents & POLLIN)
+                while (read(fds[i].fd, &expirations, sizeof(uint64_t)) == -1 && errno == EINTR)
+                    ;
+        }
+        lockScheduler(true);
+        /* The read fails with ECANCELED when the clock has been set */
+        if (fds[clockIdx].revents & POLLIN &&
+            read(fds[clockIdx].fd, &expirations, sizeof(uint64_t)) == -1 && errno == ECANCELED) {
+            setClockFd(SCHEDULER->clockFd);
+            handleClockChange();
+        }
+        expireTimers();
+        lockScheduler(false);
+    }
+
+out:
+    if ((rv = pthread_mutex_unlock(pipe->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startSchedulerThread", rv,
+                 strerror(rv), "Unable to unlock the pipe mutex");
+    }
+    if (DEBUG)
+        logInfo(CONSOLE | SYSTEM, "Scheduler thread exited successfully\n");
+    pthread_exit(0);
+}
+
+void *startSchedulerWorker(void *arg UNUSED)
+{
+    TimerJob *timerJob = NULL;
+    TimerJobType type = TIMER_START_JOB;
+    Unit *unit = NULL;
+    struct timespec now = { 0 };
+    long delay = 0;
+
+    lockScheduler(true);
+    while (!SCHEDULER->exit) {
+        /* Get the first job whose timer is not handled by another worker */
+        unit = NULL;
+        for (int i = 0; i < SCHEDULER->jobs->size; i++) {
+            timerJob = arrayGet(SCHEDULER->jobs, i);
+            if (!*timerJob->unit->timer->busy) {
+                unit = timerJob->unit;
+                type = timerJob->type;
+                arrayRemoveAt(SCHEDULER->jobs, i);
+                break;
+            }
+        }
+        if (!unit) {
+            if (SCHEDULER->idleWorkers > SCHEDULER_MAX_IDLE_WORKERS)
+                break;
+            waitScheduler();
+            continue;
+        }
+        SCHEDULER->idleWorkers--;
+        *unit->timer->busy = true;
+        if (type == TIMER_CATCHUP_JOB) {
+            /* The delay is counted from the start of the timer */
+            clock_gettime(CLOCK_BOOTTIME, &now);
+            delay = now.tv_sec - *unit->timer->catchUp;
+            *unit->timer->catchUp = -1;
+        }
+        lockScheduler(false);
+        switch (type) {
+        case TIMER_START_JOB:
+            /* The next time is computed without the unit mutex */
+            initTimerUnit(unit);
+            refreshUnitSnapshot(unit);
+            break;
+        case TIMER_EXPIRED_JOB:
+            expireTimerUnit(unit);
+            break;
+        case TIMER_CLOCK_JOB:
+            rearmTimerUnit(unit);
+            break;
+        case TIMER_CATCHUP_JOB:
+            catchUpTimerUnit(unit, delay);
+            break;
+        }
+        lockScheduler(true);
+        *unit->timer->busy = false;
+        if (type == TIMER_CATCHUP_JOB) {
+            SCHEDULER->catchUpJobs--;
+            dispatchCatchUps();
+        }
+        SCHEDULER->idleWorkers++;
+        /* Wake up the workers which are waiting for this timer and removeTimer() */
+        broadcastScheduler();
+    }
+    SCHEDULER->idleWorkers--;
+    SCHEDULER->numWorkers--;
+    broadcastScheduler();
+    lockScheduler(false);
+    pthread_exit(0);
+}
+
+void startScheduler()
+{
+    pthread_t thread;
+    pthread_attr_t attr;
+    int rv = 0;
+
+    assert(!SCHEDULER);
+    SCHEDULER = schedulerNew();
+    if ((rv = pthread_attr_init(&attr)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startScheduler", errno,
+                 strerror(errno), "pthread_attr_init returned bad exit code %d", rv);
+        kill(UNITD_PID, SIGTERM);
+    }
+    if ((rv = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startScheduler", errno,
+                 strerror(errno), "pthread_attr_setdetachstate returned bad exit code %d", rv);
+        kill(UNITD_PID, SIGTERM);
+    }
+    if ((rv = pthread_create(&thread, &attr, startSchedulerThread, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "startScheduler", rv,
+                 strerror(rv), "Unable to create the scheduler thread (detached)");
+        kill(UNITD_PID, SIGTERM);
+    } else {
+        if (DEBUG)
+            logInfo(CONSOLE | SYSTEM, "Thread created successfully for the scheduler\n");
+    }
+    pthread_attr_destroy(&attr);
+}
+
+void stopScheduler()
+{
+    if (SCHEDULER) {
+        int rv = 0, output = THREAD_EXIT;
+        Pipe *pipe = SCHEDULER->pipe;
+        /* Stop the workers. The running jobs will be completed. */
+        lockScheduler(true);
+        SCHEDULER->exit = true;
+        broadcastScheduler();
+        lockScheduler(false);
+        if ((rv = uWrite(pipe->fds[1], &output, sizeof(int))) == -1) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "stopScheduler", errno,
+                     strerror(errno), "Unable to write into pipe for the scheduler");
+        }
+        if ((rv = pthread_mutex_lock(pipe->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "stopScheduler", rv,
+                     strerror(rv), "Unable to acquire the pipe mutex lock");
+        }
+        if ((rv = pthread_mutex_unlock(pipe->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "stopScheduler", rv,
+                     strerror(rv), "Unable to unlock the pipe mutex");
+        }
+        lockScheduler(true);
+        while (SCHEDULER->numWorkers > 0)
+            waitScheduler();
+        lockScheduler(false);
+    }
+}
+
+int addTimer(Unit *unit)
+{
+    assert(unit);
+    assert(SCHEDULER);
+
+    lockScheduler(true);
+    *unit->timer->active = true;
+    addTimerJob(unit, TIMER_START_JOB);
+    lockScheduler(false);
+
+    return 0;
+}
+
+int removeTimer(Unit *unit)
+{
+    Timer *timer = NULL;
+    TimerHeap *timerHeap = NULL;
+
+    assert(unit);
+
+    if (!SCHEDULER)
+        return 0;
+    timer = unit->timer;
+    lockScheduler(true);
+    *timer->active = false;
+    removeTimerJobs(unit);
+    arrayRemove(SCHEDULER->catchUps, unit);
+    *timer->catchUp = -1;
+    /* Wait for the worker which is handling the timer */
+    while (*timer->busy)
+        waitScheduler();
+    if (*timer->heapIdx != -1) {
+        timerHeap = getTimerHeap(unit);
+        timerHeapRemove(timerHeap, *timer->heapIdx);
+        setTimerHeapFd(timerHeap);
+    }
+    lockScheduler(false);
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "Scheduler::'%s' timer removed", unit->name);
+
+    return 0;
+}
+
+void armTimer(Unit *unit)
+{
+    Timer *timer = NULL;
+    TimerHeap *timerHeap = NULL;
+    struct timespec now = { 0 };
+    int accuracy = 0;
+
+    assert(unit);
+
+    timer = unit->timer;
+    if (clock_gettime(CLOCK_BOOTTIME, &now) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "armTimer", errno,
+                 strerror(errno), "Unable to get the boot time for '%s'", unit->name);
+        kill(UNITD_PID, SIGTERM);
+        return;
+    }
+    lockScheduler(true);
+    /* The timer could have been stopped meanwhile */
+    if (*timer->active) {
+        timerHeap = getTimerHeap(unit);
+        if (*timer->heapIdx != -1)
+            timerHeapRemove(timerHeap, *timer->heapIdx);
+        /* Rounded up to the second so the timer never expires before the next time */
+        *timer->earliest = now.tv_sec + *unit->leftTime + (now.tv_nsec > 0 ? 1 : 0);
+        accuracy = unit->accuracySec ? *unit->accuracySec : 0;
+        timer->expiry->tv_sec = alignExpiry(*timer->earliest, accuracy);
+        timer->expiry->tv_nsec = 0;
+        timerHeapPush(timerHeap, unit);
+        setTimerHeapFd(timerHeap);
+    }
+    lockScheduler(false);
+}
+
+/* The timer is expired while the system was down */
+void catchUpTimer(Unit *unit)
+{
+    Timer *timer = NULL;
+    TimerHeap *timerHeap = NULL;
+    struct timespec now = { 0 };
+    int delay = 0;
+
+    assert(unit);
+
+    timer = unit->timer;
+    if (clock_gettime(CLOCK_BOOTTIME, &now) == -1) {
+        logError(CONSOLE | SYSTEM, "src/core/handlers/scheduler.c", "catchUpTimer", errno,
+                 strerror(errno), "Unable to get the boot time for '%s'", unit->name);
+        kill(UNITD_PID, SIGTERM);
+        return;
+    }
+    lockScheduler(true);
+    if (*timer->active) {
+        timerHeap = getTimerHeap(unit);
+        if (*timer->heapIdx != -1)
+            timerHeapRemove(timerHeap, *timer->heapIdx);
+        /* Spread the catch-ups to not overload the boot */
+        if (TIMERS_CATCHUP_SPREAD > 0)
+            delay = rand_r(&SCHEDULER->seed) % (TIMERS_CATCHUP_SPREAD + 1);
+        *timer->catchUp = now.tv_sec;
+        *timer->earliest = now.tv_sec + delay;
+        timer->expiry->tv_sec = *timer->earliest;
+        timer->expiry->tv_nsec = now.tv_nsec;
+        timerHeapPush(timerHeap, unit);
+        setTimerHeapFd(timerHeap);
+        if (DEBUG)
+            syslog(LOG_DAEMON | LOG_DEBUG, "Scheduler::'%s' catch-up in %d seconds", unit->name,
+                   delay);
+    }
+    lockScheduler(false);
+}
+
+void disarmTimer(Unit *unit)
+{
+    Timer *timer = NULL;
+    TimerHeap *timerHeap = NULL;
+
+    assert(unit);
+
+    timer = unit->timer;
+    lockScheduler(true);
+    if (*timer->heapIdx != -1) {
+        timerHeap = getTimerHeap(unit);
+        timerHeapRemove(timerHeap, *timer->heapIdx);
+        setTimerHeapFd(timerHeap);
+    }
+    lockScheduler(false);
+}
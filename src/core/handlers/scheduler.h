@@ -0,0 +1,64 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#define SCHEDULER_MAX_IDLE_WORKERS 2
+#define SCHEDULER_HEAP_SIZE 16
+#define SCHEDULER_CATCHUP_MAX 2
+#define SCHEDULER_CATCHUP_SPREAD 60
+
+typedef enum {
+    TIMER_START_JOB = 0,
+    TIMER_EXPIRED_JOB = 1,
+    TIMER_CLOCK_JOB = 2,
+    TIMER_CATCHUP_JOB = 3
+} TimerJobType;
+
+typedef struct {
+    Unit *unit;
+    TimerJobType type;
+} TimerJob;
+
+typedef struct {
+    Unit **units;
+    int size;
+    int capacity;
+    int fd;
+} TimerHeap;
+
+typedef struct {
+    TimerHeap *heap;
+    TimerHeap *alarmHeap;
+    int clockFd;
+    Array *jobs;
+    Array *catchUps;
+    int catchUpJobs;
+    unsigned int seed;
+    pthread_mutex_t *mutex;
+    pthread_cond_t *cv;
+    int numWorkers;
+    int idleWorkers;
+    bool running;
+    bool exit;
+    Pipe *pipe;
+} Scheduler;
+
+extern Scheduler *SCHEDULER;
+extern int TIMERS_CATCHUP_MAX;
+extern int TIMERS_CATCHUP_SPREAD;
+
+Scheduler *schedulerNew();
+void schedulerRelease(Scheduler **);
+void startScheduler();
+void *startSchedulerThread(void *);
+void *startSchedulerWorker(void *);
+void stopScheduler();
+int addTimer(Unit *);
+int removeTimer(Unit *);
+void armTimer(Unit *);
+void catchUpTimer(Unit *);
+void disarmTimer(Unit *);
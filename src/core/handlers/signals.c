@@ -128,6 +128,8 @@ int signalsHandler(int signo, siginfo_t *info, void *context UNUSED)
                     break;
                 }
             }
+            updateUnitsBoard(unit, false);
+            refreshUnitSnapshot(unit);
         } else if (!unit && infoCode == CLD_EXITED) {
             /* Try to get the unit by failure pid */
             if ((unit = getUnitByFailurePid(UNITD_DATA->units, infoPid)))
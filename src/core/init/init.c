@@ -47,8 +47,10 @@ CommandData COMMANDS_DATA[] = {
     { LIST_RESTARTED_COMMAND, "list-restarted" },
     { LIST_TIMERS_COMMAND, "list-timers" },
     { LIST_UPATH_COMMAND, "list-paths" },
+    { SESSION_COMMAND, "session" },
+    { BOARD_COMMAND, "board" },
 };
-int COMMANDS_LEN = 30;
+int COMMANDS_LEN = 32;
 
 const ListFilterData LIST_FILTER_DATA[] = {
     { ENABLED_FILTER, "enable" },      { DISABLED_FILTER, "disable" },
@@ -59,9 +61,12 @@ const ListFilterData LIST_FILTER_DATA[] = {
 };
 int LIST_FILTER_LEN = 9;
 
-const UnitdErrorsData UNITD_ERRORS_ITEMS[] = { { UNITD_GENERIC_ERR, "An error has occurred!" },
-                                               { UNITD_SOCKBUF_ERR,
-                                                 "Unable to receive the data!" } };
+const UnitdErrorsData UNITD_ERRORS_ITEMS[] = {
+    { UNITD_GENERIC_ERR, "An error has occurred!" },
+    { UNITD_SOCKBUF_ERR, "Unable to receive the data!" },
+    { UNITD_PERMISSION_ERR, "Permission denied! Please, run this program as administrator or as "
+                            "a member of the '%s' group." }
+};
 const UnitdMessagesData UNITD_MESSAGES_ITEMS[] = {
     { UNITD_SYSTEM_LOG_MSG, "Please, check the system log for details." },
     { UNITD_SOCKBUF_MSG, "Have been requested '%lu' bytes but only '%lu' are available.\n"
@@ -142,7 +147,10 @@ int unitdInit(UnitdData **unitdData, bool isAggregate)
     if (SHUTDOWN_COMMAND == REBOOT_COMMAND)
         goto shutdown;
 #endif
+    openUnitsBoard();
+    openTimerJournal();
     startCleaner();
+    startScheduler();
     startNotifier(NULL);
     //******************* DEFAULT OR CMDLINE STATE ************************
     /* Set the default state variable.
@@ -191,6 +199,7 @@ int unitdInit(UnitdData **unitdData, bool isAggregate)
 shutdown:
     SHUTDOWN_START = timeNew(NULL);
     stopCleaner();
+    stopScheduler();
     stopNotifier(NULL);
     //******************* POWEROFF (HALT) / REBOOT STATE **********************
     logInfo(CONSOLE, "%sSystem is going down ...%s\n", WHITE_COLOR, DEFAULT_COLOR);
@@ -260,7 +269,10 @@ int unitdUserInit(UnitdData **unitdData, bool isAggregate)
         logInfo(CONSOLE, "socket user path = %s\n", SOCKET_USER_PATH);
         logInfo(CONSOLE, "Debug = %s\n", DEBUG ? "True" : "False");
     }
+    openUnitsBoard();
+    openTimerJournal();
     startCleaner();
+    startScheduler();
     startNotifier(NULL);
     if (SHUTDOWN_COMMAND == REBOOT_COMMAND)
         goto shutdown;
@@ -279,6 +291,7 @@ int unitdUserInit(UnitdData **unitdData, bool isAggregate)
 shutdown:
     SHUTDOWN_START = timeNew(NULL);
     stopCleaner();
+    stopScheduler();
     stopNotifier(NULL);
     //********************* STOPPING UNITS **********************************
     closePipes(units, NULL);
@@ -295,9 +308,12 @@ void unitdEnd(UnitdData **unitdData)
     objectRelease(&STATE_CMDLINE_DIR);
     timeRelease(&BOOT_START);
     timeRelease(&BOOT_STOP);
+    closeUnitsBoard();
+    closeTimerJournal();
     userDataRelease();
     notifierRelease(&NOTIFIER);
     cleanerRelease(&CLEANER);
+    schedulerRelease(&SCHEDULER);
     if ((rv = pthread_mutex_destroy(&START_MUTEX)) != 0)
         logError(CONSOLE | SYSTEM, "src/core/init/init.c", "unitdEnd", rv, strerror(rv),
                  "Unable to destroy the start mutex");
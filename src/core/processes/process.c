@@ -42,6 +42,8 @@ void *startProcess(void *arg)
                  "Unable to acquire the lock of the mutex for the %s unit", unitName);
         goto out;
     }
+    /* The unit will be busy until the end of the start */
+    publishUnitSnapshot(unit);
     if (DEBUG)
         logWarning(ALL, "\n[*] STARTING '%s' ... \n", unitName);
     if (unit->errors->size > 0) {
@@ -204,10 +206,8 @@ out:
     case TIMER:
         if (statusThread == 0 && pData->pStateData->pState == RUNNING)
             *finalStatus = FINAL_STATUS_SUCCESS;
-        else {
-            pipeRelease(&unit->pipe);
+        else
             *finalStatus = FINAL_STATUS_FAILURE;
-        }
         break;
     case UPATH:
         if (statusThread == 0 && pData->pStateData->pState == RUNNING)
@@ -218,6 +218,7 @@ out:
     default:
         break;
     }
+    publishUnitSnapshot(unit);
     /* Broadcast signal and unlock */
     if ((rv = pthread_cond_broadcast(unit->cv)) != 0) {
         *finalStatus = FINAL_STATUS_FAILURE;
@@ -250,38 +251,31 @@ out:
     return rvThread;
 }
 
-int startProcesses(Array **units, Unit *singleUnit)
+static int startUnitsThreads(Array *units, Array *unitsToStart)
 {
     int rv = 0, result = 0, numThreads = 0, *rvThread;
     Unit *unit = NULL;
     const char *unitName = NULL;
 
-    if (!singleUnit)
-        numThreads = (*units ? (*units)->size : 0);
-    else
-        numThreads = 1;
+    numThreads = (unitsToStart ? unitsToStart->size : 0);
     if (numThreads > 0) {
         UnitThreadData unitsThreadsData[numThreads];
         if (DEBUG)
             logWarning(ALL, "\n[*] CREATING %d THREADS (STARTING)\n", numThreads);
         for (int i = 0; i < numThreads; i++) {
             UnitThreadData *unitThreadData = &unitsThreadsData[i];
-            if (!singleUnit)
-                unit = arrayGet(*units, i);
-            else {
-                unit = singleUnit;
-                unit->showResult = false;
-            }
+            unit = arrayGet(unitsToStart, i);
             assert(unit);
             unitName = unit->name;
             if (DEBUG)
                 logInfo(ALL, "Creating the '%s' thread\n", unitName);
-            unitThreadData->units = *units;
+            /* The dependencies are always looked up into the whole units array */
+            unitThreadData->units = units;
             unitThreadData->unit = unit;
             if ((rv = pthread_create(&unitThreadData->thread, NULL, startProcess,
                                      unitThreadData)) != 0) {
-                logError(ALL, "src/core/processes/process.c", "startProcesses", rv, strerror(rv),
-                         "Unable to create the thread for '%s'", unitName);
+                logError(ALL, "src/core/processes/process.c", "startUnitsThreads", rv,
+                         strerror(rv), "Unable to create the thread for '%s'", unitName);
                 kill(UNITD_PID, SIGTERM);
             } else {
                 if (DEBUG)
@@ -293,8 +287,8 @@ int startProcesses(Array **units, Unit *singleUnit)
             unit = unitThreadData->unit;
             unitName = unit->name;
             if ((rv = pthread_join(unitThreadData->thread, (void **)&rvThread)) != 0) {
-                logError(ALL, "src/core/processes/process.c", "startProcesses", rv, strerror(rv),
-                         "Unable to join the thread for '%s'", unitName);
+                logError(ALL, "src/core/processes/process.c", "startUnitsThreads", rv,
+                         strerror(rv), "Unable to join the thread for '%s'", unitName);
                 kill(UNITD_PID, SIGTERM);
             } else {
                 if (DEBUG)
@@ -310,6 +304,38 @@ int startProcesses(Array **units, Unit *singleUnit)
     return result;
 }
 
+int startProcesses(Array **units, Unit *singleUnit)
+{
+    int rv = 0;
+    Array *singleUnitArr = NULL;
+
+    if (!singleUnit)
+        rv = startUnitsThreads(*units, *units);
+    else {
+        singleUnit->showResult = false;
+        singleUnitArr = arrayNew(NULL);
+        arrayAdd(singleUnitArr, singleUnit);
+        rv = startUnitsThreads(*units, singleUnitArr);
+        arrayRelease(&singleUnitArr);
+    }
+
+    return rv;
+}
+
+/* Starts (parallelized) only the units contained into 'unitsToStart' array.
+ * Their dependencies are looked up into 'units' array thus the "requires" ordering is
+ * respected even though the dependencies are started by the same call.
+*/
+int startProcessesList(Array **units, Array **unitsToStart)
+{
+    int len = (*unitsToStart ? (*unitsToStart)->size : 0);
+
+    for (int i = 0; i < len; i++)
+        ((Unit *)arrayGet(*unitsToStart, i))->showResult = false;
+
+    return startUnitsThreads(*units, *unitsToStart);
+}
+
 Array *getRunningUnits(Array **units)
 {
     Array *runningUnits = arrayNew(NULL);
@@ -362,6 +388,7 @@ void *stopProcess(void *arg)
                  "Unable to acquire the lock of the mutex for the %s unit", unitName);
         goto out;
     }
+    publishUnitSnapshot(unit);
     switch (unit->type) {
     case DAEMON:
         command = unit->stopCmd;
@@ -389,7 +416,7 @@ void *stopProcess(void *arg)
                      "Unable to unlock of the mutex for the %s unit (timer case)", unitName);
             goto out;
         }
-        statusThread = closePipes(NULL, unit);
+        statusThread = removeTimer(unit);
         if ((rv = pthread_mutex_lock(unitMutex)) != 0) {
             *finalStatus = FINAL_STATUS_FAILURE;
             logError(CONSOLE, "src/core/processes/process.c", "stopProcess", rv, strerror(rv),
@@ -426,6 +453,7 @@ void *stopProcess(void *arg)
     default:
         break;
     }
+    publishUnitSnapshot(unit);
     if ((rv = pthread_mutex_unlock(unitMutex)) != 0) {
         *finalStatus = FINAL_STATUS_FAILURE;
         logError(CONSOLE, "src/core/processes/process.c", "stopProcess", rv, strerror(rv),
@@ -571,10 +599,11 @@ void *listenPipe(void *arg)
                 logErrorStr(SYSTEM, "%s: '%s' failure command returned %d exit code!", unitName,
                             failureCmd, rv);
                 arrayAdd(unit->errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_GENERIC_ERR].desc));
+                refreshUnitSnapshot(unit);
             }
         }
         if ((restartMax > 0 && *restartNum < restartMax) || (restartMax == -1 && restart)) {
-            /* We lock the mutex to allow unitStatusServer func to retrieve the completed data. */
+            /* We lock the mutex to publish the completed data */
             if ((rvMutex = pthread_mutex_lock(unit->mutex)) != 0) {
                 logError(SYSTEM, "src/core/processes/process.c", "listenPipe", rvMutex,
                          strerror(rvMutex),
@@ -592,6 +621,7 @@ void *listenPipe(void *arg)
             arrayAdd(pDataHistory, processDataNew(*pData, PARSE_UNIT));
             resetPDataForRestart(pData);
             (*restartNum)++;
+            publishUnitSnapshot(unit);
             if ((rvMutex = pthread_mutex_unlock(unit->mutex)) != 0) {
                 logError(SYSTEM, "src/core/processes/process.c", "listenPipe", rvMutex,
                          strerror(rvMutex), "Unable to unlock the mutex for the %s unit", unitName);
@@ -17,6 +17,7 @@ typedef struct {
 } UnitThreadData;
 
 int startProcesses(Array **, Unit *);
+int startProcessesList(Array **, Array **);
 void *startProcess(void *);
 Array *getRunningUnits(Array **);
 int stopProcesses(Array **, Unit *);
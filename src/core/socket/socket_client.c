@@ -303,68 +303,28 @@ out:
     return rv;
 }
 
-static char *getLastTime(Unit *unit)
+/* The timers journal is loaded once for all the units */
+static char *getLastTime(Array **timerStates, Unit *unit)
 {
-    char *pattern = NULL, *lastTimeStr = NULL;
-    int rv = 0, finalStatus = -1;
-    const char *timeStr = NULL, *finalStatusStr = NULL;
-    glob_t results;
-    Time *lastTime = timeNew(NULL);
-    Array *entries = NULL;
+    char *lastTimeStr = NULL;
+    TimerState *timerState = NULL;
+    Time *lastTime = NULL;
 
     assert(unit);
 
-    if (!USER_INSTANCE)
-        pattern = stringNew(UNITD_TIMER_DATA_PATH);
-    else
-        pattern = stringNew(UNITD_USER_TIMER_DATA_PATH);
-    stringAppendChr(&pattern, '/');
-    stringAppendStr(&pattern, unit->name);
-    stringAppendStr(&pattern, "|last|*");
-    if ((rv = glob(pattern, 0, NULL, &results)) == 0) {
-        size_t lenResults = results.gl_pathc;
-        if (lenResults > 0) {
-            if (lenResults > 1) {
-                rv = 1;
-                logError(SYSTEM, "src/core/socket/socket_client.c", "getLastTime", rv, strerror(rv),
-                         "Have been found '%d' files with '%s' pattern!\n", lenResults, pattern);
-                goto out;
-            }
-            const char *fileName = results.gl_pathv[0];
-            assert(fileName);
-            entries = stringSplit((char *)fileName, "|", false);
-            assert(entries);
-            int lenEntries = entries->size;
-            assert(lenEntries == 4);
-            /* The third and fourth represents the last time and final status.*/
-            timeStr = arrayGet(entries, 2);
-            finalStatusStr = arrayGet(entries, 3);
-            if (!isValidNumber(timeStr, false)) {
-                rv = 1;
-                logError(SYSTEM, "src/core/socket/socket_client.c", "getLastTime", rv, strerror(rv),
-                         "The time from '%s' file is not valid!\n", fileName);
-                goto out;
-            }
-            if (!isValidNumber(finalStatusStr, true)) {
-                rv = 1;
-                logError(SYSTEM, "src/core/socket/socket_client.c", "getLastTime", rv, strerror(rv),
-                         "The final status from '%s' file is not valid!\n", fileName);
-                goto out;
-            }
-            finalStatus = atoi(finalStatusStr);
-            *lastTime->sec = atol(timeStr);
-            lastTimeStr = stringGetTimeStamp(lastTime, false, "%d-%m-%Y %H:%M:%S");
-            assert(lastTimeStr);
-            stringPrependStr(&lastTimeStr, finalStatus == 0 ? GREEN_COLOR : RED_COLOR);
-            stringAppendStr(&lastTimeStr, DEFAULT_COLOR);
-        }
+    if (!(*timerStates) && getTimerStates(timerStates) != 0)
+        return NULL;
+    timerState = getTimerStateByName(*timerStates, unit->name);
+    if (timerState && timerState->lastTime != -1) {
+        lastTime = timeNew(NULL);
+        *lastTime->sec = timerState->lastTime;
+        lastTimeStr = stringGetTimeStamp(lastTime, false, "%d-%m-%Y %H:%M:%S");
+        assert(lastTimeStr);
+        stringPrependStr(&lastTimeStr, timerState->lastStatus == 0 ? GREEN_COLOR : RED_COLOR);
+        stringAppendStr(&lastTimeStr, DEFAULT_COLOR);
+        timeRelease(&lastTime);
     }
 
-out:
-    globfree(&results);
-    timeRelease(&lastTime);
-    objectRelease(&pattern);
-    arrayRelease(&entries);
     return lastTimeStr;
 }
 
@@ -410,7 +370,7 @@ static void printStatus(PState pState, const char *status, int finalStatus, bool
         if (pState == DEAD)
             printf("%s%s%s", GREY_COLOR, status, DEFAULT_COLOR);
         /* The timers can have a restarting state and a final status equal to success.
-         * Read the comment in startTimerUnitThread. (Restart case).
+         * Read the comment in expireTimerUnit. (Restart case).
         */
         else if (pState == RESTARTING)
             logWarning(CONSOLE, "%s", status);
@@ -756,7 +716,7 @@ out:
 int showTimersList(SockMessageOut **sockMessageOut, ListFilter listFilter)
 {
     int rv = -1, lenUnits = -1, maxLenName = -1, maxLeftTime, len = -1, *finalStatus, pfds[2];
-    Array *unitsDisplay = NULL;
+    Array *unitsDisplay = NULL, *timerStates = NULL;
     Unit *unitDisplay = NULL;
     const char *unitName = NULL, *leftTime = NULL, *nextTime = NULL, *status = NULL;
     char *lasTime = NULL;
@@ -857,7 +817,7 @@ int showTimersList(SockMessageOut **sockMessageOut, ListFilter listFilter)
                     else
                         printf("%*s", 10 - ((int)strlen(status)) + PADDING, ""); //Status str
                     /* Last time */
-                    lasTime = getLastTime(unitDisplay);
+                    lasTime = getLastTime(&timerStates, unitDisplay);
                     if (lasTime) {
                         printf("%s", lasTime);
                         printf("%*s", PADDING, "");
@@ -907,6 +867,7 @@ int showTimersList(SockMessageOut **sockMessageOut, ListFilter listFilter)
     }
 
 out:
+    arrayRelease(&timerStates);
     sockMessageOutRelease(sockMessageOut);
     return rv;
 }
@@ -957,7 +918,7 @@ int showUnitStatus(SockMessageOut **sockMessageOut, const char *unitName)
     int rv = 0, len = 0, *finalStatus, *exitCode, *signalNum, *pid, restartNum = 0,
         lenPDataHistory = 0, lenUnitErrors = 0, pfds[2];
     Array *sockErrors = NULL, *units = NULL, *unitErrors = NULL, *pDatasHistory = NULL,
-          *messages = NULL;
+          *messages = NULL, *timerStates = NULL;
     Unit *unit = NULL;
     ProcessData *pData = NULL, *pDataHistory = NULL;
     PStateData *pStateData = NULL, *pStateDataHistory = NULL;
@@ -1046,7 +1007,8 @@ int showUnitStatus(SockMessageOut **sockMessageOut, const char *unitName)
                     /* Interval as string */
                     printf("%*s %s\n", MAX_LEN_KEY, "Interval :", interval);
                     /* Last Time */
-                    lastTime = getLastTime(unit);
+                    lastTime = getLastTime(&timerStates, unit);
+                    arrayRelease(&timerStates);
                     if (lastTime) {
                         printf("%*s %s \n", MAX_LEN_KEY, "Last Time :", lastTime);
                         objectRelease(&lastTime);
@@ -1059,6 +1021,10 @@ int showUnitStatus(SockMessageOut **sockMessageOut, const char *unitName)
                     leftTimeDuration = unit->leftTimeDuration;
                     if (leftTimeDuration && strlen(leftTimeDuration) > 0)
                         printf("%*s %s\n", MAX_LEN_KEY, "Left Time :", unit->leftTimeDuration);
+                    /* Wakeups saved */
+                    if (unit->wakeupsSaved)
+                        printf("%*s %d wakeups saved\n", MAX_LEN_KEY,
+                               "Coalesced :", *unit->wakeupsSaved);
                 }
                 printf("\n%s%s%s\n", WHITE_UNDERLINE_COLOR, "PROCESS DATA", DEFAULT_COLOR);
                 /* Process Type */
@@ -1366,6 +1332,77 @@ out:
     return rv;
 }
 
+int batchUnits(SockMessageOut **sockMessageOut, Command command, Array *unitNames, bool force,
+               bool run, bool reset)
+{
+    SockMessageIn *sockMessageIn = NULL;
+    int rv = -1, socketConnection = -1, bufferSize = INITIAL_SIZE;
+    char *bufferReq = NULL, *bufferRes = NULL;
+    Array *options = arrayNew(objectRelease);
+
+    assert(unitNames && unitNames->size > 0);
+
+    switch (command) {
+    case RESTART_COMMAND:
+        arrayAdd(options, stringNew(OPTIONS_DATA[RESTART_OPT].name));
+        command = START_COMMAND;
+        break;
+    case RE_ENABLE_COMMAND:
+        arrayAdd(options, stringNew(OPTIONS_DATA[RE_ENABLE_OPT].name));
+        command = ENABLE_COMMAND;
+        break;
+    case START_COMMAND:
+    case STOP_COMMAND:
+    case ENABLE_COMMAND:
+        break;
+    default:
+        logErrorStr(CONSOLE, "The '%s' command doesn't support more units!\n",
+                    COMMANDS_DATA[command].name);
+        arrayRelease(&options);
+        rv = 1;
+        goto out;
+    }
+    if (force)
+        arrayAdd(options, stringNew(OPTIONS_DATA[FORCE_OPT].name));
+    if (run)
+        arrayAdd(options, stringNew(OPTIONS_DATA[RUN_OPT].name));
+    if (reset)
+        arrayAdd(options, stringNew(OPTIONS_DATA[RESET_OPT].name));
+    if (options->size == 0)
+        arrayRelease(&options);
+    if ((rv = getSockMessageIn(&sockMessageIn, &socketConnection, command, NULL, options)) != 0)
+        goto out;
+    sockMessageIn->unitNames = arrayStrCopy(unitNames);
+    bufferReq = marshallRequest(sockMessageIn);
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "BatchUnits::Buffer sent (%lu): \n%s", strlen(bufferReq),
+               bufferReq);
+    if ((rv = uSend(socketConnection, bufferReq, strlen(bufferReq), 0)) == -1) {
+        logError(CONSOLE, "src/core/socket/socket_client.c", "batchUnits", errno, strerror(errno),
+                 "Send error");
+        goto out;
+    }
+    /* Read the response message */
+    bufferRes = calloc(bufferSize, sizeof(char));
+    assert(bufferRes);
+    if ((rv = readMessage(&socketConnection, &bufferRes, &bufferSize)) == -1)
+        goto out;
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "BatchUnits::Buffer received (%lu): \n%s",
+               strlen(bufferRes), bufferRes);
+    if (!(*sockMessageOut))
+        *sockMessageOut = sockMessageOutNew();
+    rv = unmarshallResponse(bufferRes, sockMessageOut);
+
+out:
+    objectRelease(&bufferReq);
+    objectRelease(&bufferRes);
+    sockMessageInRelease(&sockMessageIn);
+    if (socketConnection != -1)
+        close(socketConnection);
+    return rv;
+}
+
 int getUnitData(SockMessageOut **sockMessageOut, const char *unitName, bool requires,
                 bool conflicts, bool states)
 {
@@ -1594,6 +1631,430 @@ int showData(Command command, SockMessageOut **sockMessageOut, const char *arg,
     return 0;
 }
 
+int showBatchData(Command command, SockMessageOut **sockMessageOut, Array *unitNames, bool force,
+                  bool run, bool reset)
+{
+    int rv = 0, len = 0, lenErrors = 0;
+    char *message = NULL;
+    Array *sockErrors = NULL, *messages = NULL, *unitsDisplay = NULL, *unitErrors = NULL;
+    Unit *unitDisplay = NULL;
+    bool started = false, failed = false;
+
+    if ((rv = batchUnits(sockMessageOut, command, unitNames, force, run, reset)) != 0)
+        goto out;
+    sockErrors = (*sockMessageOut)->errors;
+    len = (sockErrors ? sockErrors->size : 0);
+    for (int i = 0; i < len; i++) {
+        logErrorStr(CONSOLE, arrayGet(sockErrors, i));
+        printf("\n");
+        rv = 1;
+    }
+    messages = (*sockMessageOut)->messages;
+    len = (messages ? messages->size : 0);
+    for (int i = 0; i < len; i++) {
+        message = arrayGet(messages, i);
+        if (stringStartsWithStr(message, "Warning"))
+            logWarning(CONSOLE, message);
+        else
+            logInfo(CONSOLE, message);
+        printf("\n");
+    }
+    /* Show a result for each unit */
+    started = (command == START_COMMAND || command == RESTART_COMMAND || run);
+    unitsDisplay = (*sockMessageOut)->unitsDisplay;
+    len = (unitsDisplay ? unitsDisplay->size : 0);
+    for (int i = 0; i < len; i++) {
+        unitDisplay = arrayGet(unitsDisplay, i);
+        unitErrors = unitDisplay->errors;
+        lenErrors = (unitErrors ? unitErrors->size : 0);
+        failed = (lenErrors > 0 ||
+                  (started && *unitDisplay->processData->finalStatus != FINAL_STATUS_SUCCESS));
+        if (!failed)
+            logInfo(CONSOLE, "[   %sOK%s   ] %s%s%s\n", GREEN_COLOR, DEFAULT_COLOR, WHITE_COLOR,
+                    unitDisplay->name, DEFAULT_COLOR);
+        else {
+            logInfo(CONSOLE, "[ %sFAILED%s ] %s%s%s\n", RED_COLOR, DEFAULT_COLOR, WHITE_COLOR,
+                    unitDisplay->name, DEFAULT_COLOR);
+            rv = 1;
+        }
+        for (int j = 0; j < lenErrors; j++) {
+            printf("%*s", WIDTH, "");
+            logErrorStr(CONSOLE, arrayGet(unitErrors, j));
+            printf("\n");
+        }
+    }
+
+out:
+    sockMessageOutRelease(sockMessageOut);
+    return rv;
+}
+
+static SockMessageIn *getSessionMessageIn(char *line, char **error)
+{
+    SockMessageIn *sockMessageIn = NULL;
+    Array *args = arrayNew(objectRelease), *options = arrayNew(objectRelease);
+    Command command = NO_COMMAND;
+    ListFilter listFilter = NO_FILTER;
+    char *token = NULL, *savePtr = NULL, *arg = NULL;
+    const char *commandName = NULL;
+    bool force = false, run = false, reset = false, valid = true;
+    int len = 0;
+
+    /* Command */
+    token = strtok_r(line, " \t", &savePtr);
+    assert(token);
+    if ((command = getCommand(token)) == NO_COMMAND) {
+        *error = getMsg(-1, "The '%s' command is not valid!", token);
+        goto out;
+    }
+    commandName = COMMANDS_DATA[command].name;
+    /* Options and units */
+    while ((token = strtok_r(NULL, " \t", &savePtr))) {
+        if (stringEquals(token, "-f") || stringEquals(token, "--force"))
+            force = true;
+        else if (stringEquals(token, "-r") || stringEquals(token, "--run"))
+            run = true;
+        else if (stringEquals(token, "-e") || stringEquals(token, "--reset"))
+            reset = true;
+        else if (token[0] == '-') {
+            *error = getMsg(-1, "The '%s' option is not valid!", token);
+            goto out;
+        } else
+            arrayAdd(args, stringNew(token));
+    }
+    len = args->size;
+    switch (command) {
+    case LIST_COMMAND:
+    case LIST_ENABLED_COMMAND:
+    case LIST_DISABLED_COMMAND:
+    case LIST_STARTED_COMMAND:
+    case LIST_DEAD_COMMAND:
+    case LIST_FAILED_COMMAND:
+    case LIST_RESTARTABLE_COMMAND:
+    case LIST_RESTARTED_COMMAND:
+    case LIST_TIMERS_COMMAND:
+    case LIST_UPATH_COMMAND:
+    case ANALYZE_COMMAND:
+    case GET_DEFAULT_STATE_COMMAND:
+        valid = (len == 0 && !force && !run && !reset &&
+                 !(command == GET_DEFAULT_STATE_COMMAND && USER_INSTANCE));
+        if (command == ANALYZE_COMMAND) {
+            arrayAdd(options, stringNew(OPTIONS_DATA[ANALYZE_OPT].name));
+            command = LIST_COMMAND;
+        } else if (command != GET_DEFAULT_STATE_COMMAND) {
+            if ((listFilter = getListFilterByCommand(command)) != NO_FILTER)
+                arrayAdd(options, stringNew(LIST_FILTER_DATA[listFilter].desc));
+            command = LIST_COMMAND;
+        }
+        break;
+    case STATUS_COMMAND:
+    case LIST_REQUIRES_COMMAND:
+    case LIST_CONFLICTS_COMMAND:
+    case LIST_STATES_COMMAND:
+    case SET_DEFAULT_STATE_COMMAND:
+        valid = (len == 1 && !force && !run && !reset &&
+                 !(command == SET_DEFAULT_STATE_COMMAND && USER_INSTANCE));
+        if (command == LIST_REQUIRES_COMMAND)
+            arrayAdd(options, stringNew(OPTIONS_DATA[REQUIRES_OPT].name));
+        else if (command == LIST_CONFLICTS_COMMAND)
+            arrayAdd(options, stringNew(OPTIONS_DATA[CONFLICTS_OPT].name));
+        else if (command == LIST_STATES_COMMAND)
+            arrayAdd(options, stringNew(OPTIONS_DATA[STATES_OPT].name));
+        else if (valid && command == SET_DEFAULT_STATE_COMMAND) {
+            arg = stringNew(arrayGet(args, 0));
+            stringReplaceAllStr(&arg, ".state", "");
+            switch (getStateByStr(arg)) {
+            case NO_STATE:
+            case INIT:
+            case POWEROFF:
+            case REBOOT:
+            case FINAL:
+                *error = getMsg(-1, "The '%s' argument is not valid!",
+                                (const char *)arrayGet(args, 0));
+                goto out;
+            default:
+                break;
+            }
+        }
+        break;
+    case DISABLE_COMMAND:
+        valid = (len == 1 && !force && !reset);
+        if (run)
+            arrayAdd(options, stringNew(OPTIONS_DATA[RUN_OPT].name));
+        break;
+    case STOP_COMMAND:
+        valid = (len > 0 && !force && !run && !reset);
+        break;
+    case START_COMMAND:
+    case RESTART_COMMAND:
+        valid = (len > 0 && !run);
+        if (command == RESTART_COMMAND) {
+            arrayAdd(options, stringNew(OPTIONS_DATA[RESTART_OPT].name));
+            command = START_COMMAND;
+        }
+        break;
+    case ENABLE_COMMAND:
+    case RE_ENABLE_COMMAND:
+        valid = (len > 0);
+        if (command == RE_ENABLE_COMMAND) {
+            arrayAdd(options, stringNew(OPTIONS_DATA[RE_ENABLE_OPT].name));
+            command = ENABLE_COMMAND;
+        }
+        if (run)
+            arrayAdd(options, stringNew(OPTIONS_DATA[RUN_OPT].name));
+        break;
+    default:
+        *error = getMsg(-1, "The '%s' command is not supported in a session!", commandName);
+        goto out;
+    }
+    if (!valid) {
+        *error = getMsg(-1, "The '%s' command has not valid arguments!", commandName);
+        goto out;
+    }
+    if (command == START_COMMAND || command == ENABLE_COMMAND) {
+        if (force)
+            arrayAdd(options, stringNew(OPTIONS_DATA[FORCE_OPT].name));
+        if (reset)
+            arrayAdd(options, stringNew(OPTIONS_DATA[RESET_OPT].name));
+    }
+    sockMessageIn = sockMessageInNew();
+    sockMessageIn->command = command;
+    if (len == 1)
+        sockMessageIn->arg = arg ? stringNew(arg) : stringNew(arrayGet(args, 0));
+    else if (len > 1)
+        sockMessageIn->unitNames = arrayStrCopy(args);
+    if (options->size > 0) {
+        sockMessageIn->options = options;
+        options = NULL;
+    }
+
+out:
+    objectRelease(&arg);
+    arrayRelease(&args);
+    arrayRelease(&options);
+    return sockMessageIn;
+}
+
+static void printSessionResponse(char *buffer)
+{
+    /* One response per line */
+    for (char *c = buffer; *c != '\0'; c++) {
+        if (*c == '\n')
+            *c = ' ';
+    }
+    printf("%s\n", buffer);
+    fflush(stdout);
+}
+
+static int sendSessionRequest(int *socketConnection, char *line, int id, int *pending)
+{
+    SockMessageIn *sockMessageIn = NULL;
+    SockMessageOut *sockMessageOut = NULL;
+    int rv = 0;
+    char *bufferReq = NULL, *error = NULL, idStr[20];
+
+    sprintf(idStr, "%d", id);
+    if (!(sockMessageIn = getSessionMessageIn(line, &error))) {
+        /* The request has not been sent thus we reply locally */
+        sockMessageOut = sockMessageOutNew();
+        sockMessageOut->id = stringNew(idStr);
+        sockMessageOut->errors = arrayNew(objectRelease);
+        arrayAdd(sockMessageOut->errors, error);
+        bufferReq = marshallResponse(sockMessageOut, PARSE_SOCK_RESPONSE);
+        printSessionResponse(bufferReq);
+        goto out;
+    }
+    sockMessageIn->id = stringNew(idStr);
+    bufferReq = marshallRequest(sockMessageIn);
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "SendSessionRequest::Buffer sent (%lu): \n%s",
+               strlen(bufferReq), bufferReq);
+    if ((rv = uSend(*socketConnection, bufferReq, strlen(bufferReq), 0)) == -1) {
+        logError(CONSOLE, "src/core/socket/socket_client.c", "sendSessionRequest", errno,
+                 strerror(errno), "Send error");
+        goto out;
+    }
+    rv = 0;
+    (*pending)++;
+
+out:
+    objectRelease(&bufferReq);
+    sockMessageInRelease(&sockMessageIn);
+    sockMessageOutRelease(&sockMessageOut);
+    return rv;
+}
+
+int showSession()
+{
+    struct sockaddr_un name;
+    struct pollfd fds[2];
+    int rv = 0, socketConnection = -1, bufferSize = 0, id = 0, pending = 0;
+    ssize_t lenRead = 0;
+    char *input = NULL, *line = NULL, *newLine = NULL, *bufferRes = NULL, chunk[BUFSIZ];
+    bool eof = false;
+
+    if ((socketConnection = initSocket(&name)) == -1) {
+        rv = 1;
+        goto out;
+    }
+    if ((rv = unitdSockConn(&socketConnection, &name)) != 0)
+        goto out;
+    input = stringNew("");
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[1].fd = socketConnection;
+    fds[1].events = POLLIN;
+    /* The requests are sent as soon as they are read (pipelined) */
+    while (!eof || pending > 0) {
+        /* After the end of the input, we only wait for the pending responses */
+        if (eof)
+            fds[0].fd = -1;
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE, "src/core/socket/socket_client.c", "showSession", errno,
+                     strerror(errno), "Poll error");
+            rv = 1;
+            goto out;
+        }
+        /* Response */
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            bufferSize = INITIAL_SIZE;
+            bufferRes = calloc(bufferSize, sizeof(char));
+            assert(bufferRes);
+            if ((rv = readMessage(&socketConnection, &bufferRes, &bufferSize)) <= 0) {
+                if (rv == 0)
+                    logErrorStr(CONSOLE, "The session has been closed by unitd!\n");
+                rv = 1;
+                goto out;
+            }
+            if (DEBUG)
+                syslog(LOG_DAEMON | LOG_DEBUG, "ShowSession::Buffer received (%lu): \n%s",
+                       strlen(bufferRes), bufferRes);
+            printSessionResponse(bufferRes);
+            objectRelease(&bufferRes);
+            pending--;
+            rv = 0;
+        }
+        /* Requests */
+        if (fds[0].fd != -1 && (fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            if ((lenRead = read(STDIN_FILENO, chunk, sizeof(chunk) - 1)) == -1) {
+                if (errno == EINTR)
+                    continue;
+                logError(CONSOLE, "src/core/socket/socket_client.c", "showSession", errno,
+                         strerror(errno), "Read error");
+                rv = 1;
+                goto out;
+            }
+            chunk[lenRead] = '\0';
+            if (lenRead == 0) {
+                eof = true;
+                /* The last line could be not terminated */
+                stringAppendChr(&input, '\n');
+            } else
+                stringAppendStr(&input, chunk);
+            while ((newLine = strchr(input, '\n'))) {
+                *newLine = '\0';
+                line = input + strspn(input, " \t");
+                /* Skip the empty lines and the comments */
+                if (*line != '\0' && *line != '#') {
+                    if ((rv = sendSessionRequest(&socketConnection, line, ++id, &pending)) != 0)
+                        goto out;
+                }
+                memmove(input, newLine + 1, strlen(newLine + 1) + 1);
+            }
+        }
+    }
+
+out:
+    objectRelease(&input);
+    objectRelease(&bufferRes);
+    if (socketConnection != -1)
+        close(socketConnection);
+    return rv;
+}
+
+int showUnitsBoard()
+{
+    int rv = 0, lenUnits = 0, maxLenName = WIDTH_UNIT_NAME, len = 0;
+    Array *unitsBoard = NULL;
+    UnitBoardEntry *entry = NULL;
+    const char *status = NULL;
+    char pidStr[20], exitCodeStr[20], dateStr[WIDTH_DATE + 1];
+    struct tm tm;
+    time_t timeChanged;
+
+    if ((rv = getUnitsBoard(&unitsBoard)) != 0)
+        goto out;
+    lenUnits = (unitsBoard ? unitsBoard->size : 0);
+    for (int i = 0; i < lenUnits; i++) {
+        entry = arrayGet(unitsBoard, i);
+        if ((len = strlen(entry->name)) > maxLenName)
+            maxLenName = len;
+    }
+    /* HEADER */
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "UNIT NAME", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, maxLenName - WIDTH_UNIT_NAME + PADDING, "",
+           DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "ENABLED", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, PADDING, "", DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "PID", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, 8 - WIDTH_PID + PADDING, "", DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "STATUS", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, 10 - WIDTH_STATUS + PADDING, "", DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "EXIT", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, PADDING, "", DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "RESTARTS", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, PADDING, "", DEFAULT_COLOR);
+    printf("%s%s%s", WHITE_UNDERLINE_COLOR, "LAST CHANGE", DEFAULT_COLOR);
+    printf("%s%*s%s", WHITE_UNDERLINE_COLOR, WIDTH_DATE - 11, "", DEFAULT_COLOR);
+    printf("\n");
+    /* CELLS */
+    for (int i = 0; i < lenUnits; i++) {
+        entry = arrayGet(unitsBoard, i);
+        /* The restarted or "continued" units require attention */
+        if (entry->restartNum > 0 || entry->signalNum == SIGCONT)
+            logWarning(CONSOLE, "%s", entry->name);
+        else
+            printf("%s", entry->name);
+        printf("%*s", maxLenName - (int)strlen(entry->name) + PADDING, "");
+        /* Enabled */
+        printf("%s", (entry->enabled ? "true" : "false"));
+        printf("%*s", WIDTH_ENABLED - (entry->enabled ? 3 : 4) + PADDING, "");
+        /* PID */
+        if (entry->pid == -1)
+            stringCopy(pidStr, "-");
+        else
+            sprintf(pidStr, "%d", entry->pid);
+        printf("%s%*s", pidStr, 8 - (int)strlen(pidStr) + PADDING, "");
+        /* STATUS */
+        status = PSTATE_DATA_ITEMS[entry->pState].desc;
+        printStatus(entry->pState, status, entry->finalStatus, false);
+        if (entry->finalStatus == FINAL_STATUS_FAILURE)
+            printf("%*s", 10 - 6 + PADDING, ""); //Failed str
+        else
+            printf("%*s", 10 - ((int)strlen(status)) + PADDING, ""); //Status str
+        /* Exit code */
+        if (entry->exitCode == -1)
+            stringCopy(exitCodeStr, "-");
+        else
+            sprintf(exitCodeStr, "%d", entry->exitCode);
+        printf("%s%*s", exitCodeStr, 4 - (int)strlen(exitCodeStr) + PADDING, "");
+        /* Restarts */
+        printf("%-8d%*s", entry->restartNum, PADDING, "");
+        /* Last change */
+        timeChanged = entry->timeChanged;
+        localtime_r(&timeChanged, &tm);
+        strftime(dateStr, sizeof(dateStr), "%d-%m-%Y %H:%M:%S", &tm);
+        printf("%s\n", dateStr);
+    }
+    printf("\n%d units found\n", lenUnits);
+
+out:
+    arrayRelease(&unitsBoard);
+    return rv;
+}
+
 int catEditUnit(Command command, const char *arg)
 {
     int rv = 0;
@@ -10,6 +10,9 @@ int showUnitList(SockMessageOut **, ListFilter);
 int showTimersList(SockMessageOut **, ListFilter);
 int showUnitStatus(SockMessageOut **, const char *);
 int showData(Command, SockMessageOut **, const char *, bool, bool, bool, bool, bool);
+int showBatchData(Command, SockMessageOut **, Array *, bool, bool, bool);
+int showSession();
+int showUnitsBoard();
 int catEditUnit(Command, const char *);
 int createUnit(const char *);
 int showBootAnalyze(SockMessageOut **);
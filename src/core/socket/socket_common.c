@@ -25,6 +25,9 @@ SockMessageIn *sockMessageInNew()
     sockMessageIn->command = NO_COMMAND;
     sockMessageIn->options = NULL;
     sockMessageIn->arg = NULL;
+    sockMessageIn->unitNames = NULL;
+    sockMessageIn->id = NULL;
+    sockMessageIn->arena = NULL;
 
     return sockMessageIn;
 }
@@ -32,8 +35,13 @@ SockMessageIn *sockMessageInNew()
 void sockMessageInRelease(SockMessageIn **sockMessageIn)
 {
     if (*sockMessageIn) {
-        objectRelease(&(*sockMessageIn)->arg);
+        /* The strings which belong to the arena are released together with it */
+        if (!(*sockMessageIn)->arena) {
+            objectRelease(&(*sockMessageIn)->arg);
+            objectRelease(&(*sockMessageIn)->id);
+        }
         arrayRelease(&(*sockMessageIn)->options);
+        arrayRelease(&(*sockMessageIn)->unitNames);
         objectRelease(sockMessageIn);
     }
 }
@@ -45,6 +53,8 @@ SockMessageOut *sockMessageOutNew()
     sockMessageOut->errors = NULL;
     sockMessageOut->unitsDisplay = NULL;
     sockMessageOut->messages = NULL;
+    sockMessageOut->id = NULL;
+    sockMessageOut->arena = NULL;
 
     return sockMessageOut;
 }
@@ -55,6 +65,7 @@ void sockMessageOutRelease(SockMessageOut **sockMessageOut)
         arrayRelease(&(*sockMessageOut)->unitsDisplay);
         arrayRelease(&(*sockMessageOut)->errors);
         arrayRelease(&(*sockMessageOut)->messages);
+        objectRelease(&(*sockMessageOut)->id);
         objectRelease(sockMessageOut);
     }
 }
@@ -103,18 +114,28 @@ int readMessage(int *socketFd, char **buffer, int *bufferSize)
                      strerror(errno), "Recv error");
             goto out;
         }
-        assert(rv > 0);
+        /* The peer has closed the connection */
+        if (rv == 0)
+            goto out;
         /* If the data are more large than buffer then we re-allocate it */
-        if (rv > *bufferSize) {
+        if (rv >= *bufferSize) {
             *bufferSize = rv + 1;
             *buffer = realloc(*buffer, *bufferSize * sizeof(char));
             assert(*buffer);
         } else
             break;
     }
+    /* Consume the message so that the next one of a session can be read */
+    if ((rv = uRecv(*socketFd, *buffer, *bufferSize, 0)) == -1) {
+        logError(CONSOLE, "src/core/socket/socket_common.c", "readMessage", errno,
+                 strerror(errno), "Recv error");
+        goto out;
+    }
 
 out:
     (*buffer)[(*bufferSize) - 1] = '\0';
+    if (rv >= 0)
+        (*buffer)[rv] = '\0';
     return rv;
 }
 
@@ -123,23 +144,23 @@ int sortUnitsByName(const void *unitDisplayA, const void *unitDisplayB)
     return strcasecmp((*(Unit **)unitDisplayA)->name, (*(Unit **)unitDisplayB)->name);
 }
 
-void setValueForBuffer(char **buffer, int value)
+void setValueForBuffer(Arena *arena, char **buffer, int value)
 {
     assert(*buffer);
     if (value == -1 || value == -2)
-        stringAppendStr(buffer, NONE);
+        arenaStringAppendStr(arena, buffer, NONE);
     else {
-        char valueStr[10] = { 0 };
+        char valueStr[12] = { 0 };
         sprintf(valueStr, "%d", value);
-        stringAppendStr(buffer, valueStr);
+        arenaStringAppendStr(arena, buffer, valueStr);
     }
 }
 
-Array *getScriptParams(const char *unitName, const char *stateStr, const char *symlOperation,
-                       const char *unitPath)
+/* Returns the symlink data of the unit for the state: from (index 0) and to (index 1) */
+Array *getSymlinkParams(const char *unitName, const char *stateStr, const char *unitPath)
 {
-    Array *scriptParams = NULL;
-    char *command = NULL, *from = NULL, *to = NULL;
+    Array *symlinkParams = NULL;
+    char *from = NULL, *to = NULL;
 
     from = stringNew(unitPath);
     to = !USER_INSTANCE ? stringNew(UNITS_ENAB_PATH) : stringNew(UNITS_USER_ENAB_PATH);
@@ -147,16 +168,11 @@ Array *getScriptParams(const char *unitName, const char *stateStr, const char *s
     stringAppendStr(&to, stateStr);
     stringAppendChr(&to, '/');
     stringAppendStr(&to, unitName);
-    scriptParams = arrayNew(objectRelease);
-    command = stringNew(UNITD_DATA_PATH);
-    stringAppendStr(&command, "/scripts/symlink-handle.sh");
-    arrayAdd(scriptParams, command); //0
-    arrayAdd(scriptParams, stringNew(symlOperation)); //1
-    arrayAdd(scriptParams, from); //2
-    arrayAdd(scriptParams, to); //3
-    arrayAdd(scriptParams, NULL); //4
-
-    return scriptParams;
+    symlinkParams = arrayNew(objectRelease);
+    arrayAdd(symlinkParams, from); //0
+    arrayAdd(symlinkParams, to); //1
+
+    return symlinkParams;
 }
 
 int sendWallMsg(Command command)
@@ -196,6 +212,7 @@ int sendWallMsg(Command command)
 void fillUnitsDisplayList(Array **units, Array **unitsDisplay, ListFilter listFilter)
 {
     Unit *unit = NULL;
+    UnitSnapshot *snapshot = NULL;
     bool add = false;
     PType pType = NO_PROCESS_TYPE;
     int lenUnits;
@@ -220,7 +237,15 @@ void fillUnitsDisplayList(Array **units, Array **unitsDisplay, ListFilter listFi
             add = true;
             break;
         }
-        if (add)
+        if (!add)
+            continue;
+        /* The live units are shared by the list data of their snapshot without copying them.
+         * The caller has to release the list by unitDisplayRelease.
+        */
+        if (unit->snapshot) {
+            snapshot = getUnitSnapshot(unit);
+            arrayAdd(*unitsDisplay, snapshot->unitListDisplay);
+        } else
             arrayAdd(*unitsDisplay, unitNew(unit, PARSE_SOCK_RESPONSE_UNITLIST));
     }
 }
@@ -20,6 +20,9 @@ typedef struct {
     char *arg;
     Command command;
     Array *options;
+    Array *unitNames;
+    char *id;
+    Arena *arena;
 } SockMessageIn;
 
 typedef struct {
@@ -35,8 +38,8 @@ SockMessageIn *sockMessageInNew();
 void sockMessageInRelease(SockMessageIn **);
 SockMessageOut *sockMessageOutNew();
 int sortUnitsByName(const void *, const void *);
-void setValueForBuffer(char **, int);
-Array *getScriptParams(const char *, const char *, const char *, const char *);
+void setValueForBuffer(Arena *, char **, int);
+Array *getSymlinkParams(const char *, const char *, const char *);
 int sendWallMsg(Command);
 void fillUnitsDisplayList(Array **, Array **, ListFilter);
 int loadAndCheckUnit(Array **, bool, const char *, bool, Array **);
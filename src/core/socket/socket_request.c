@@ -16,6 +16,11 @@ Option=value1|          (optional and repeatable)
 Option=value2|
 ....
 Option=valueN|
+Unit=value1|            (optional and repeatable, batch requests only)
+Unit=value2|
+....
+Unit=valueN|
+Id=value|               (optional and not repeatable, session requests only)
 
 */
 
@@ -24,19 +29,23 @@ typedef enum {
     COMMAND = 0,
     ARG = 1,
     OPTION = 2,
+    UNIT = 3,
+    ID = 4,
 } Keys;
 
 static const key_value KEY_VALUE[] = {
     { COMMAND, "Command" },
     { ARG, "Arg" },
     { OPTION, "Option" },
+    { UNIT, "Unit" },
+    { ID, "Id" },
 };
 
 char *marshallRequest(SockMessageIn *sockMessageIn)
 {
     char *buffer = NULL, commandStr[10];
-    const char *arg = NULL, *optionKey = NULL;
-    Array *options = NULL;
+    const char *arg = NULL, *optionKey = NULL, *unitKey = NULL;
+    Array *options = NULL, *unitNames = NULL;
     int len = 0;
 
     assert(sockMessageIn);
@@ -64,55 +73,102 @@ char *marshallRequest(SockMessageIn *sockMessageIn)
         stringAppendStr(&buffer, arrayGet(options, i));
         stringAppendStr(&buffer, TOKEN);
     }
+    unitNames = sockMessageIn->unitNames;
+    len = (unitNames ? unitNames->size : 0);
+    if (len > 0)
+        unitKey = KEY_VALUE[UNIT].value;
+    for (int i = 0; i < len; i++) {
+        stringAppendStr(&buffer, unitKey);
+        stringAppendStr(&buffer, ASSIGNER);
+        stringAppendStr(&buffer, arrayGet(unitNames, i));
+        stringAppendStr(&buffer, TOKEN);
+    }
+    if (sockMessageIn->id) {
+        stringAppendStr(&buffer, KEY_VALUE[ID].value);
+        stringAppendStr(&buffer, ASSIGNER);
+        stringAppendStr(&buffer, sockMessageIn->id);
+        stringAppendStr(&buffer, TOKEN);
+    }
 
     return buffer;
 }
 
+static bool isKey(const char *entry, size_t keyLen, Keys key)
+{
+    const char *keyStr = KEY_VALUE[key].value;
+
+    return strlen(keyStr) == keyLen && strncmp(entry, keyStr, keyLen) == 0;
+}
+
+static char *getValue(Arena *arena, const char *value, size_t len)
+{
+    char *ret = NULL;
+
+    if (arena)
+        return arenaStringNewN(arena, value, len);
+    ret = calloc(len + 1, sizeof(char));
+    assert(ret);
+    memcpy(ret, value, len);
+
+    return ret;
+}
+
 int unmarshallRequest(char *buffer, SockMessageIn **sockMessageIn)
 {
-    Array **options;
-    int rv = 0, lenBuffer = 0;
-    char key[BUFSIZ], *value = NULL, entries[BUFSIZ], c = 0;
+    Array **options, **unitNames;
+    Arena *arena = NULL;
+    int rv = 0;
+    const char *entry = NULL, *token = NULL, *value = NULL;
+    size_t keyLen = 0, valueLen = 0;
 
     assert(buffer);
     assert(sockMessageIn);
 
-    stringCopy(entries, "");
     options = &(*sockMessageIn)->options;
-    lenBuffer = buffer ? strlen(buffer) : 0;
-    for (int i = 0; i < lenBuffer; i++) {
-        c = buffer[i];
-        if (c != TOKEN[0]) {
-            char chrStr[] = { c, '\0' };
-            strcat(entries, chrStr);
-            continue;
-        } else {
-            value = strstr(entries, ASSIGNER) + 1;
-            stringCopyN(key, entries, strlen(entries) - strlen(value) - 1);
-            if (stringEquals(KEY_VALUE[COMMAND].value, key)) {
-                (*sockMessageIn)->command = atoi(value);
-                goto next;
-            }
-            if (stringEquals(KEY_VALUE[ARG].value, key)) {
-                (*sockMessageIn)->arg = stringNew(value);
-                goto next;
-            }
-            if (stringEquals(KEY_VALUE[OPTION].value, key)) {
-                if (!(*options))
-                    *options = arrayNew(objectRelease);
-                arrayAdd(*options, stringNew(value));
-                goto next;
-            }
-            // Should never happen
-            logError(CONSOLE | SYSTEM, "src/core/socket/socket_request.c", "unmarshallRequest",
-                     EPERM, strerror(EPERM), "Property %s not found!", key);
-            rv = EPERM;
-            goto out;
+    unitNames = &(*sockMessageIn)->unitNames;
+    /* If the request has an arena then the values are allocated into it */
+    arena = (*sockMessageIn)->arena;
+    entry = buffer;
+    while ((token = strchr(entry, TOKEN[0]))) {
+        if (!(value = memchr(entry, ASSIGNER[0], token - entry)))
+            value = token;
+        keyLen = value - entry;
+        if (value < token) {
+            value++;
+            valueLen = token - value;
+        } else
+            valueLen = 0;
+        if (isKey(entry, keyLen, COMMAND)) {
+            (*sockMessageIn)->command = atoi(value);
+            goto next;
+        }
+        if (isKey(entry, keyLen, ARG)) {
+            (*sockMessageIn)->arg = getValue(arena, value, valueLen);
+            goto next;
+        }
+        if (isKey(entry, keyLen, OPTION)) {
+            if (!(*options))
+                *options = arrayNew(arena ? NULL : objectRelease);
+            arrayAdd(*options, getValue(arena, value, valueLen));
+            goto next;
+        }
+        if (isKey(entry, keyLen, UNIT)) {
+            if (!(*unitNames))
+                *unitNames = arrayNew(arena ? NULL : objectRelease);
+            arrayAdd(*unitNames, getValue(arena, value, valueLen));
+            goto next;
+        }
+        if (isKey(entry, keyLen, ID)) {
+            (*sockMessageIn)->id = getValue(arena, value, valueLen);
+            goto next;
         }
+        // Should never happen
+        logError(CONSOLE | SYSTEM, "src/core/socket/socket_request.c", "unmarshallRequest", EPERM,
+                 strerror(EPERM), "Property %.*s not found!", (int)keyLen, entry);
+        rv = EPERM;
+        goto out;
 next:
-        stringCopy(entries, "");
-        stringCopy(key, "");
-        continue;
+        entry = token + 1;
     }
 
 out:
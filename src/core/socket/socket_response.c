@@ -11,6 +11,7 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 /* COMMUNICATION PROTOCOL (RESPONSE) ACCORDING THE PARSER FUNCTIONALITY */
 
 /* PARSE_SOCK_RESPONSE_UNITLIST functionality
+Id=value                (optional and not repeatable, session requests only)
 Message=value1          (optional and repeatable)
 Message=value2
 .....
@@ -39,6 +40,7 @@ SignalNum=value         (optional and repeatable)
 /* PARSE_SOCK_RESPONSE functionality
   (it will include the initial part of the unit section of the PARSE_SOCK_RESPONSE_UNITLIST functionality)
 
+Id=value                (optional and not repeatable, session requests only)
 Message=value1          (optional and repeatable)
 Message=value2
 .....
@@ -75,6 +77,7 @@ ExitCode=value          (optional and repeatable)
 DateTimeStart=value     (optional and repeatable)
 DateTimeStop=value      (optional and repeatable)
 Interval=value          (optional and repeatable)
+WakeupsSaved=value      (optional and repeatable)
 [PDataHistory]          (optional and repeatable)
 PidH=value              (optional and repeatable)
 ExitCodeH=value         (optional and repeatable)
@@ -125,7 +128,9 @@ typedef enum {
     FINALSTATUSH = 33,
     DATETIMESTARTH = 34,
     DATETIMESTOPH = 35,
-    DURATIONH = 36
+    DURATIONH = 36,
+    ID = 37,
+    WAKEUPSSAVED = 38
 } Keys;
 
 // clang-format off
@@ -167,12 +172,15 @@ static const key_value KEY_VALUE[] = {
     { DATETIMESTARTH, "DateTimeStartH" },
     { DATETIMESTOPH, "DateTimeStopH" },
     { DURATIONH, "DurationH" },
+    { ID, "Id" },
+    { WAKEUPSSAVED, "WakeupsSaved" },
 };
 // clang-format on
 
 char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
 {
-    char *buffer = NULL;
+    char *buffer = NULL, *ret = NULL;
+    Arena *arena = NULL;
     Array *messages = NULL, *errors = NULL, *units = NULL, *unitErrors = NULL, *pDataHistory = NULL;
     int len = 0, lenUnitErrors = 0, lenPdataHistory = 0;
     const char *msgKey = NULL, *errKey = NULL, *unitDesc = NULL, *unitPath, *dateTimeStart,
@@ -185,9 +193,18 @@ char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
 
     assert(sockMessageOut);
 
-    /* The following data (messages and errors) are in common between
+    /* The buffer is built into the arena of the request (or a temporary one) */
+    arena = sockMessageOut->arena ? sockMessageOut->arena : arenaNew();
+    /* The following data (id, messages and errors) are in common between
     * PARSE_SOCK_RESPONSE_UNITLIST and PARSE_SOCK_RESPONSE
     */
+    /* Request id (session) */
+    if (sockMessageOut->id) {
+        buffer = arenaStringNew(arena, KEY_VALUE[ID].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, sockMessageOut->id);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
+    }
     /* Messages */
     messages = sockMessageOut->messages;
     len = (messages ? messages->size : 0);
@@ -195,13 +212,13 @@ char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
         msgKey = KEY_VALUE[MESSAGE].value;
     for (int i = 0; i < len; i++) {
         if (i == 0 && !buffer)
-            buffer = stringNew(msgKey);
+            buffer = arenaStringNew(arena, msgKey);
         else
-            stringAppendStr(&buffer, msgKey);
+            arenaStringAppendStr(arena, &buffer, msgKey);
 
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, arrayGet(messages, i));
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, arrayGet(messages, i));
+        arenaStringAppendStr(arena, &buffer, TOKEN);
     }
     /* Errors */
     errors = sockMessageOut->errors;
@@ -210,13 +227,13 @@ char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
         errKey = KEY_VALUE[ERROR].value;
     for (int i = 0; i < len; i++) {
         if (i == 0 && !buffer)
-            buffer = stringNew(errKey);
+            buffer = arenaStringNew(arena, errKey);
         else
-            stringAppendStr(&buffer, errKey);
+            arenaStringAppendStr(arena, &buffer, errKey);
 
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, arrayGet(errors, i));
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, arrayGet(errors, i));
+        arenaStringAppendStr(arena, &buffer, TOKEN);
     }
     /* Units */
     units = sockMessageOut->unitsDisplay;
@@ -226,190 +243,199 @@ char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
         pData = unit->processData;
         /* Unit section */
         if (i == 0 && !buffer)
-            buffer = stringNew(KEY_VALUE[UNIT_SEC].value);
+            buffer = arenaStringNew(arena, KEY_VALUE[UNIT_SEC].value);
         else
-            stringAppendStr(&buffer, KEY_VALUE[UNIT_SEC].value);
-        stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[UNIT_SEC].value);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* The following data are in common between
          * PARSE_SOCK_RESPONSE_UNITLIST and PARSE_SOCK_RESPONSE
         */
         /* Name */
-        stringAppendStr(&buffer, KEY_VALUE[NAME].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, unit->name);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[NAME].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, unit->name);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Enabled */
-        stringAppendStr(&buffer, KEY_VALUE[ENABLED].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, (unit->enabled ? "1" : "0"));
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[ENABLED].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, (unit->enabled ? "1" : "0"));
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Pid */
-        stringAppendStr(&buffer, KEY_VALUE[PID].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, *pData->pid);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[PID].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, *pData->pid);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Process State */
-        stringAppendStr(&buffer, KEY_VALUE[PSTATE].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, pData->pStateData->pState);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[PSTATE].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, pData->pStateData->pState);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Final Status */
-        stringAppendStr(&buffer, KEY_VALUE[FINALSTATUS].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, *pData->finalStatus);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[FINALSTATUS].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, *pData->finalStatus);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Description */
         unitDesc = unit->desc;
-        stringAppendStr(&buffer, KEY_VALUE[DESC].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, (unitDesc ? unitDesc : NONE));
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[DESC].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, (unitDesc ? unitDesc : NONE));
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Duration */
         duration = pData->duration;
-        stringAppendStr(&buffer, KEY_VALUE[DURATION].value);
-        stringAppendStr(&buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[DURATION].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
         if (duration)
-            stringAppendStr(&buffer, duration);
+            arenaStringAppendStr(arena, &buffer, duration);
         else {
             if (pData->timeStart) {
                 Time *currentTimeStop = timeNew(NULL);
                 char *diff = stringGetDiffTime(currentTimeStop, pData->timeStart);
-                stringAppendStr(&buffer, diff);
+                arenaStringAppendStr(arena, &buffer, diff);
                 timeRelease(&currentTimeStop);
                 objectRelease(&diff);
             } else
-                stringAppendStr(&buffer, NONE);
+                arenaStringAppendStr(arena, &buffer, NONE);
         }
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* RestartNum */
-        stringAppendStr(&buffer, KEY_VALUE[RESTARTNUM].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, unit->restartNum);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[RESTARTNUM].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, unit->restartNum);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Restartable */
-        stringAppendStr(&buffer, KEY_VALUE[RESTARTABLE].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        stringAppendStr(&buffer, ((unit->restart || unit->restartMax > 0) ? "1" : "0"));
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[RESTARTABLE].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        arenaStringAppendStr(arena, &buffer, ((unit->restart || unit->restartMax > 0) ? "1" : "0"));
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Type */
-        stringAppendStr(&buffer, KEY_VALUE[TYPE].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, unit->type);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[TYPE].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, unit->type);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Next time (date) */
         char *nextTimeDate = unit->nextTimeDate;
         if (nextTimeDate && strlen(nextTimeDate) > 0) {
-            stringAppendStr(&buffer, KEY_VALUE[NEXTTIMEDATE].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            stringAppendStr(&buffer, nextTimeDate);
-            stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[NEXTTIMEDATE].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, nextTimeDate);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
         }
         /* Left time (duration) */
         char *leftTimeDuration = unit->leftTimeDuration;
         if (leftTimeDuration && strlen(leftTimeDuration) > 0) {
-            setLeftTimeAndDuration(&unit);
-            stringAppendStr(&buffer, KEY_VALUE[LEFTTIMEDURATION].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            stringAppendStr(&buffer, leftTimeDuration);
-            stringAppendStr(&buffer, TOKEN);
+            /* The unit could be shared by a status snapshot so we don't update it */
+            leftTimeDuration = getLeftTimeDuration(unit);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[LEFTTIMEDURATION].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, leftTimeDuration);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
+            objectRelease(&leftTimeDuration);
         }
         /* Signal Num */
-        stringAppendStr(&buffer, KEY_VALUE[SIGNALNUM].value);
-        stringAppendStr(&buffer, ASSIGNER);
-        setValueForBuffer(&buffer, *pData->signalNum);
-        stringAppendStr(&buffer, TOKEN);
+        arenaStringAppendStr(arena, &buffer, KEY_VALUE[SIGNALNUM].value);
+        arenaStringAppendStr(arena, &buffer, ASSIGNER);
+        setValueForBuffer(arena, &buffer, *pData->signalNum);
+        arenaStringAppendStr(arena, &buffer, TOKEN);
         /* Unit content is changed */
         if (unit->isChanged) {
-            stringAppendStr(&buffer, KEY_VALUE[IS_CHANGED].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            stringAppendStr(&buffer, "1");
-            stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[IS_CHANGED].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, "1");
+            arenaStringAppendStr(arena, &buffer, TOKEN);
         }
         if (funcType == PARSE_SOCK_RESPONSE) {
             /* Timer name */
             char *timerName = unit->timerName;
             if (timerName) {
-                stringAppendStr(&buffer, KEY_VALUE[TIMERNAME].value);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, timerName);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[TIMERNAME].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, timerName);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Timer process state */
             PState *timerPState = unit->timerPState;
             if (timerPState) {
-                stringAppendStr(&buffer, KEY_VALUE[TIMERPSTATE].value);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *timerPState);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[TIMERPSTATE].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *timerPState);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Path unit name */
             char *pathUnitName = unit->pathUnitName;
             if (pathUnitName) {
-                stringAppendStr(&buffer, KEY_VALUE[PATHUNITNAME].value);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, pathUnitName);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[PATHUNITNAME].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, pathUnitName);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Path unit process state */
             PState *pathUnitPState = unit->pathUnitPState;
             if (pathUnitPState) {
-                stringAppendStr(&buffer, KEY_VALUE[PATHUNITPSTATE].value);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *pathUnitPState);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[PATHUNITPSTATE].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *pathUnitPState);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Path */
             unitPath = unit->path;
-            stringAppendStr(&buffer, KEY_VALUE[PATH].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            stringAppendStr(&buffer, (unitPath ? unitPath : NONE));
-            stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[PATH].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, (unitPath ? unitPath : NONE));
+            arenaStringAppendStr(arena, &buffer, TOKEN);
             /* RestartMax */
-            stringAppendStr(&buffer, KEY_VALUE[RESTARTMAX].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            setValueForBuffer(&buffer, unit->restartMax);
-            stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[RESTARTMAX].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            setValueForBuffer(arena, &buffer, unit->restartMax);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
             /* Unit errors */
             unitErrors = unit->errors;
             lenUnitErrors = (unitErrors ? unitErrors->size : 0);
             for (int j = 0; j < lenUnitErrors; j++) {
                 if (!unitErrorKey)
                     unitErrorKey = KEY_VALUE[UNITERROR].value;
-                stringAppendStr(&buffer, unitErrorKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, arrayGet(unitErrors, j));
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, unitErrorKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, arrayGet(unitErrors, j));
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Exit code */
-            stringAppendStr(&buffer, KEY_VALUE[EXITCODE].value);
-            stringAppendStr(&buffer, ASSIGNER);
-            setValueForBuffer(&buffer, *pData->exitCode);
-            stringAppendStr(&buffer, TOKEN);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[EXITCODE].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
+            setValueForBuffer(arena, &buffer, *pData->exitCode);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
             /* Date Time Start */
             dateTimeStart = pData->dateTimeStartStr;
-            stringAppendStr(&buffer, KEY_VALUE[DATETIMESTART].value);
-            stringAppendStr(&buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[DATETIMESTART].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
             if (dateTimeStart)
-                stringAppendStr(&buffer, dateTimeStart);
+                arenaStringAppendStr(arena, &buffer, dateTimeStart);
             else
-                stringAppendStr(&buffer, NONE);
-            stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, NONE);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
             /* Date Time Stop */
             dateTimeStop = pData->dateTimeStopStr;
-            stringAppendStr(&buffer, KEY_VALUE[DATETIMESTOP].value);
-            stringAppendStr(&buffer, ASSIGNER);
+            arenaStringAppendStr(arena, &buffer, KEY_VALUE[DATETIMESTOP].value);
+            arenaStringAppendStr(arena, &buffer, ASSIGNER);
             if (dateTimeStop)
-                stringAppendStr(&buffer, dateTimeStop);
+                arenaStringAppendStr(arena, &buffer, dateTimeStop);
             else
-                stringAppendStr(&buffer, NONE);
-            stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, NONE);
+            arenaStringAppendStr(arena, &buffer, TOKEN);
             /* Interval */
             char *intervalStr = unit->intervalStr;
             if (intervalStr && strlen(intervalStr) > 0) {
-                stringAppendStr(&buffer, KEY_VALUE[INTERVAL].value);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, intervalStr);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[INTERVAL].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, intervalStr);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
+            }
+            /* Wakeups saved by the timer accuracy */
+            if (unit->wakeupsSaved) {
+                arenaStringAppendStr(arena, &buffer, KEY_VALUE[WAKEUPSSAVED].value);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *unit->wakeupsSaved);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
             /* Process Data history */
             pDataHistory = unit->processDataHistory;
@@ -418,69 +444,73 @@ char *marshallResponse(SockMessageOut *sockMessageOut, ParserFuncType funcType)
                 pDataHistorySecKey = KEY_VALUE[PDATAHISTORY_SEC].value;
             for (int j = 0; j < lenPdataHistory; j++) {
                 pData = arrayGet(pDataHistory, j);
-                stringAppendStr(&buffer, pDataHistorySecKey);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, pDataHistorySecKey);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Pid history */
                 if (!pidHKey)
                     pidHKey = KEY_VALUE[PIDH].value;
-                stringAppendStr(&buffer, pidHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *pData->pid);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, pidHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *pData->pid);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Exit code history */
                 if (!exitCodeHKey)
                     exitCodeHKey = KEY_VALUE[EXITCODEH].value;
-                stringAppendStr(&buffer, exitCodeHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *pData->exitCode);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, exitCodeHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *pData->exitCode);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Process State History */
                 if (!pStateHKey)
                     pStateHKey = KEY_VALUE[PSTATEH].value;
-                stringAppendStr(&buffer, pStateHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, pData->pStateData->pState);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, pStateHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, pData->pStateData->pState);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Signal number History */
                 if (!signalNumHKey)
                     signalNumHKey = KEY_VALUE[SIGNALNUMH].value;
-                stringAppendStr(&buffer, signalNumHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *pData->signalNum);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, signalNumHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *pData->signalNum);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Final status History */
                 if (!finalStatusHKey)
                     finalStatusHKey = KEY_VALUE[FINALSTATUSH].value;
-                stringAppendStr(&buffer, finalStatusHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                setValueForBuffer(&buffer, *pData->finalStatus);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, finalStatusHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                setValueForBuffer(arena, &buffer, *pData->finalStatus);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Date time start history */
                 if (!datetimeStartHKey)
                     datetimeStartHKey = KEY_VALUE[DATETIMESTARTH].value;
-                stringAppendStr(&buffer, datetimeStartHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, pData->dateTimeStartStr);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, datetimeStartHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, pData->dateTimeStartStr);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Date time stop history */
                 if (!datetimeStopHKey)
                     datetimeStopHKey = KEY_VALUE[DATETIMESTOPH].value;
-                stringAppendStr(&buffer, datetimeStopHKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, pData->dateTimeStopStr);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, datetimeStopHKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, pData->dateTimeStopStr);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
                 /* Duration history */
                 if (!durationKey)
                     durationKey = KEY_VALUE[DURATIONH].value;
-                stringAppendStr(&buffer, durationKey);
-                stringAppendStr(&buffer, ASSIGNER);
-                stringAppendStr(&buffer, pData->duration);
-                stringAppendStr(&buffer, TOKEN);
+                arenaStringAppendStr(arena, &buffer, durationKey);
+                arenaStringAppendStr(arena, &buffer, ASSIGNER);
+                arenaStringAppendStr(arena, &buffer, pData->duration);
+                arenaStringAppendStr(arena, &buffer, TOKEN);
             }
         }
     }
+    if (buffer)
+        ret = stringNew(buffer);
+    if (arena != sockMessageOut->arena)
+        arenaRelease(&arena);
 
-    return buffer;
+    return ret;
 }
 
 int unmarshallResponse(char *buffer, SockMessageOut **sockMessageOut)
@@ -539,6 +569,10 @@ int unmarshallResponse(char *buffer, SockMessageOut **sockMessageOut)
                 goto out;
             } else {
                 // PROPERTIES
+                if (stringEquals(key, KEY_VALUE[ID].value)) {
+                    (*sockMessageOut)->id = stringNew(value);
+                    goto next;
+                }
                 if (stringEquals(key, KEY_VALUE[MESSAGE].value)) {
                     if (!(*messages))
                         *messages = arrayNew(objectRelease);
@@ -684,6 +718,12 @@ int unmarshallResponse(char *buffer, SockMessageOut **sockMessageOut)
                     unitDisplay->intervalStr = stringNew(value);
                     goto next;
                 }
+                if (stringEquals(key, KEY_VALUE[WAKEUPSSAVED].value)) {
+                    unitDisplay->wakeupsSaved = calloc(1, sizeof(int));
+                    assert(unitDisplay->wakeupsSaved);
+                    *unitDisplay->wakeupsSaved = atoi(value);
+                    goto next;
+                }
                 if (stringEquals(key, KEY_VALUE[PIDH].value)) {
                     if (stringEquals(value, NONE))
                         *pDataHistory->pid = -1;
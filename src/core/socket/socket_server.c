@@ -13,7 +13,13 @@ bool LISTEN_SOCK_REQUEST;
 Command SHUTDOWN_COMMAND;
 char *SOCKET_USER_PATH;
 int MONITORED_FD_SET[MAX_CLIENT_SUPPORTED];
+/* The peer credentials of the connection (SO_PEERCRED) */
+static struct ucred MONITORED_CRED_SET[MAX_CLIENT_SUPPORTED];
+/* The peer of the connection is allowed to run the administrator commands (-1 = not resolved) */
+static int MONITORED_ADMIN_SET[MAX_CLIENT_SUPPORTED];
 int MAX_SOCKBUF_SIZE = 0;
+/* Defined by tests/malloc_counter.c when unitd runs with LD_PRELOAD=libmalloc_counter.so */
+unsigned long mallocCount() __attribute__((weak));
 
 static void initializeMonitoredFdSet()
 {
@@ -21,16 +27,20 @@ static void initializeMonitoredFdSet()
         MONITORED_FD_SET[i] = -1;
 }
 
-static void addToMonitoredFdSet(int socketFd)
+static int addToMonitoredFdSet(int socketFd, bool hasCred, struct ucred *ucred)
 {
     int *currentFd;
     for (int i = 0; i < MAX_CLIENT_SUPPORTED; i++) {
         currentFd = &MONITORED_FD_SET[i];
         if (*currentFd == -1) {
             *currentFd = socketFd;
-            break;
+            MONITORED_CRED_SET[i] = *ucred;
+            /* A peer without credentials is never an administrator */
+            MONITORED_ADMIN_SET[i] = hasCred ? -1 : 0;
+            return 0;
         }
     }
+    return 1;
 }
 
 static void removeFromMonitoredFdSet(int socketFd)
@@ -73,12 +83,81 @@ static void unlinkSocket()
     unlink(!USER_INSTANCE ? SOCKET_PATH : SOCKET_USER_PATH);
 }
 
+/* Only the peer credentials are taken when the connection is accepted */
+static bool getPeerCred(int socketFd, struct ucred *ucred)
+{
+    socklen_t len = sizeof(struct ucred);
+
+    if (getsockopt(socketFd, SOL_SOCKET, SO_PEERCRED, ucred, &len) == -1) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "getPeerCred", errno, strerror(errno),
+                 "Unable to get the peer credentials");
+        return false;
+    }
+
+    return true;
+}
+
+/* The administrator check can query the user databases (NSS) thus it is resolved once per
+ * connection, by the first administrator command. The read only requests never run it.
+ * Session and batch requests are authorized by the same check.
+*/
+static bool isAdminPeer(struct ucred *ucred, int *isAdmin)
+{
+    if (*isAdmin == -1) {
+        if (USER_INSTANCE)
+            *isAdmin = ucred->uid == 0 || ucred->uid == getuid();
+        else
+            *isAdmin = isAdministrator(ucred->uid, ucred->gid);
+    }
+
+    return *isAdmin;
+}
+
+static bool isAdminCommand(Command command)
+{
+    switch (command) {
+    case REBOOT_COMMAND:
+    case POWEROFF_COMMAND:
+    case HALT_COMMAND:
+    case KEXEC_COMMAND:
+    case STOP_COMMAND:
+    case START_COMMAND:
+    case RESTART_COMMAND:
+    case DISABLE_COMMAND:
+    case ENABLE_COMMAND:
+    case RE_ENABLE_COMMAND:
+    case SET_DEFAULT_STATE_COMMAND:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void sendPermissionError(int *socketFd, SockMessageOut **sockMessageOut)
+{
+    Array **errors = &(*sockMessageOut)->errors;
+    char *buffer = NULL;
+
+    if (!(*errors))
+        *errors = arrayNew(objectRelease);
+    arrayAdd(*errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_PERMISSION_ERR].desc,
+                             UNITD_ADMIN_GROUP));
+    buffer = marshallResponse(*sockMessageOut, PARSE_SOCK_RESPONSE);
+    if (uSend(*socketFd, buffer, strlen(buffer), 0) == -1) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "sendPermissionError", errno,
+                 strerror(errno), "Send func returned -1 exit code!");
+    }
+    objectRelease(&buffer);
+}
+
 int listenSocketRequest()
 {
     struct sockaddr_un name;
     int rv = -1, socketData = -1, socketConnection = -1, socketFd = -1, bufferSize, *currentFd;
     fd_set readFds;
+    struct ucred ucred = { 0 };
     char *buffer = NULL;
+    bool isSession = false;
 
     initializeMonitoredFdSet();
     unlinkSocket();
@@ -99,7 +178,7 @@ int listenSocketRequest()
         SHUTDOWN_COMMAND = REBOOT_COMMAND;
         goto out;
     }
-    addToMonitoredFdSet(socketConnection);
+    addToMonitoredFdSet(socketConnection, false, &ucred);
     BOOT_STOP = timeNew(NULL);
     /* Main loop */
     while (SHUTDOWN_COMMAND == NO_COMMAND) {
@@ -113,7 +192,13 @@ int listenSocketRequest()
                          strerror(errno), "Accept error");
                 goto out;
             }
-            addToMonitoredFdSet(socketData);
+            if (socketData != -1 &&
+                addToMonitoredFdSet(socketData, getPeerCred(socketData, &ucred), &ucred) != 0) {
+                logError(SYSTEM, "src/core/socket/socket_server.c", "listenSocketRequest", EBUSY,
+                         strerror(EBUSY), "Too many connections (max = %d)",
+                         MAX_CLIENT_SUPPORTED);
+                close(socketData);
+            }
         } else {
             for (int i = 0; i < MAX_CLIENT_SUPPORTED; i++) {
                 currentFd = &MONITORED_FD_SET[i];
@@ -122,12 +207,22 @@ int listenSocketRequest()
                     bufferSize = INITIAL_SIZE;
                     buffer = calloc(bufferSize, sizeof(char));
                     assert(buffer);
-                    if ((rv = readMessage(&socketFd, &buffer, &bufferSize)) == -1)
-                        goto out;
-                    rv = socketDispatchRequest(buffer, &socketFd);
+                    /* The client has closed the connection (or the session) */
+                    if ((rv = readMessage(&socketFd, &buffer, &bufferSize)) <= 0) {
+                        objectRelease(&buffer);
+                        close(socketFd);
+                        removeFromMonitoredFdSet(socketFd);
+                        continue;
+                    }
+                    isSession = false;
+                    rv = socketDispatchRequest(buffer, &socketFd, &isSession,
+                                               &MONITORED_CRED_SET[i], &MONITORED_ADMIN_SET[i]);
                     objectRelease(&buffer);
-                    removeFromMonitoredFdSet(socketFd);
-                    continue;
+                    /* A session keeps the connection open for the next requests */
+                    if (!isSession) {
+                        close(socketFd);
+                        removeFromMonitoredFdSet(socketFd);
+                    }
                 }
             }
         }
@@ -142,23 +237,50 @@ out:
     return rv;
 }
 
-int socketDispatchRequest(char *buffer, int *socketFd)
+int socketDispatchRequest(char *buffer, int *socketFd, bool *isSession, struct ucred *ucred,
+                          int *isAdmin)
 {
     int rv = 0;
     Command command = NO_COMMAND;
     SockMessageIn *sockMessageIn = NULL;
     SockMessageOut *sockMessageOut = NULL;
+    Arena *arena = NULL;
+    unsigned long mallocs = 0;
 
     assert(buffer);
     assert(*socketFd != -1);
 
+    if (DEBUG && mallocCount)
+        mallocs = mallocCount();
+    /* The request parsing and the response buffer are backed by the arena */
+    arena = arenaNew();
     sockMessageIn = sockMessageInNew();
+    sockMessageIn->arena = arena;
     sockMessageOut = sockMessageOutNew();
+    sockMessageOut->arena = arena;
     if (DEBUG)
         syslog(LOG_DAEMON | LOG_DEBUG, "SocketDispatchRequest::Buffer received (%lu): \n%s",
                strlen(buffer), buffer);
     if ((rv = unmarshallRequest(buffer, &sockMessageIn)) == 0) {
         command = sockMessageIn->command;
+        /* Session request (the response is tagged by the request id) */
+        if (sockMessageIn->id) {
+            *isSession = true;
+            sockMessageOut->id = stringNew(sockMessageIn->id);
+        }
+        /* The batch requests only contain administrator commands */
+        if ((sockMessageIn->unitNames || isAdminCommand(command)) &&
+            !isAdminPeer(ucred, isAdmin)) {
+            logWarning(SYSTEM, "Permission denied for the '%s' command",
+                       command != NO_COMMAND ? COMMANDS_DATA[command].name : "none");
+            sendPermissionError(socketFd, &sockMessageOut);
+            goto out;
+        }
+        /* Batch request (more units) */
+        if (sockMessageIn->unitNames) {
+            batchUnitServer(socketFd, sockMessageIn, &sockMessageOut);
+            goto out;
+        }
         switch (command) {
         case POWEROFF_COMMAND:
         case REBOOT_COMMAND:
@@ -184,7 +306,7 @@ int socketDispatchRequest(char *buffer, int *socketFd)
             disableUnitServer(socketFd, sockMessageIn, &sockMessageOut, NULL, true);
             break;
         case ENABLE_COMMAND:
-            enableUnitServer(socketFd, sockMessageIn, &sockMessageOut);
+            enableUnitServer(socketFd, sockMessageIn, &sockMessageOut, true);
             break;
         case LIST_REQUIRES_COMMAND:
         case LIST_CONFLICTS_COMMAND:
@@ -205,6 +327,11 @@ int socketDispatchRequest(char *buffer, int *socketFd)
 out:
     sockMessageInRelease(&sockMessageIn);
     sockMessageOutRelease(&sockMessageOut);
+    arenaRelease(&arena);
+    if (DEBUG && mallocCount)
+        syslog(LOG_DAEMON | LOG_DEBUG, "SocketDispatchRequest::Mallocs (%s): %lu",
+               command != NO_COMMAND ? COMMANDS_DATA[command].name : "none",
+               mallocCount() - mallocs);
     return rv;
 }
 
@@ -239,7 +366,7 @@ int getUnitListServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOu
 
     assert(*socketFd != -1);
 
-    *unitsDisplay = arrayNew(unitRelease);
+    *unitsDisplay = arrayNew(unitDisplayRelease);
     bootAnalyze = arrayContainsStr(options, OPTIONS_DATA[ANALYZE_OPT].name);
     if (!bootAnalyze) {
         fillUnitsDisplayList(&UNITD_DATA->units, unitsDisplay, listFilter);
@@ -383,7 +510,8 @@ int getUnitStatusServer(int *socketFd, SockMessageIn *sockMessageIn,
     int rv = 0;
     Array **unitsDisplay, **errors, **messages, *units;
     char *buffer = NULL, *unitName = NULL;
-    Unit *unit = NULL;
+    Unit *unit = NULL, *unitDisplay = NULL;
+    UnitSnapshot *snapshot = NULL;
 
     unitsDisplay = &(*sockMessageOut)->unitsDisplay;
     errors = &(*sockMessageOut)->errors;
@@ -394,7 +522,7 @@ int getUnitStatusServer(int *socketFd, SockMessageIn *sockMessageIn,
     assert(*socketFd != -1);
 
     unitName = getUnitName(sockMessageIn->arg);
-    *unitsDisplay = arrayNew(unitRelease);
+    *unitsDisplay = arrayNew(unitDisplayRelease);
     unit = getUnitByName(units, unitName);
     if (unit) {
         handleMutex(&NOTIFIER_MUTEX, true);
@@ -409,13 +537,17 @@ int getUnitStatusServer(int *socketFd, SockMessageIn *sockMessageIn,
                                        !USER_INSTANCE ? "" : "--user ", unitName));
             goto out;
         }
-        handleMutex(unit->mutex, true);
-        if (unit->type == DAEMON || unit->type == ONESHOT) {
-            setOtherDataForUnit(&unit, TIMER);
-            setOtherDataForUnit(&unit, UPATH);
+        /* We never wait for an operation in progress on the unit (i.e. an oneshot start).
+         * The timer and path unit data are added to the status unit because the snapshot
+         * is immutable.
+        */
+        snapshot = getUnitSnapshot(unit);
+        unitDisplay = unitStatusNew(snapshot);
+        if (unitDisplay->type == DAEMON || unitDisplay->type == ONESHOT) {
+            setOtherDataForUnit(&unitDisplay, TIMER);
+            setOtherDataForUnit(&unitDisplay, UPATH);
         }
-        arrayAdd(*unitsDisplay, unitNew(unit, PARSE_SOCK_RESPONSE));
-        handleMutex(unit->mutex, false);
+        arrayAdd(*unitsDisplay, unitDisplay);
     } else {
         rv = loadAndCheckUnit(unitsDisplay, true, unitName, true, errors);
         if (rv == 0) {
@@ -545,13 +677,19 @@ out:
     return rv;
 }
 
-int startUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut,
-                    bool sendResponse, bool isTimer)
+/* Performs all the checks and loads the unit into memory without starting it.
+ * If 'batchNames' is not NULL, the dependencies which are included into it are considered
+ * satisfied because they will be started by the same batch request (startProcess waits for them).
+ * On success, 'unitPrepared' points to the unit which is ready to be started.
+*/
+static int prepareStartUnit(int *socketFd, SockMessageIn *sockMessageIn,
+                            SockMessageOut **sockMessageOut, bool sendResponse, Array *batchNames,
+                            Unit **unitPrepared)
 {
-    int rv = 0, len = 0, rvMutex = 0;
+    int rv = 0, len = 0;
     Array **unitsDisplay, **errors, **units, *conflicts, *stopConflictsArr = NULL, **messages,
                                                          *requires;
-    char *buffer = NULL, *unitName = NULL;
+    char *unitName = NULL;
     Unit *unit = NULL, *unitDisplay, *unitConflict = NULL, *unitDep = NULL;
     bool force = false, restart = false, hasError = false, reset = false;
     const char *dep = NULL, *conflict = NULL;
@@ -566,12 +704,8 @@ int startUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
     assert(sockMessageIn);
     assert(*socketFd != -1);
 
+    *unitPrepared = NULL;
     unitName = getUnitName(sockMessageIn->arg);
-    if ((rvMutex = pthread_mutex_lock(&START_MUTEX)) != 0) {
-        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitServer", rv, strerror(rv),
-                 "Unable to lock the start mutex for %s!", unitName);
-        kill(UNITD_PID, SIGTERM);
-    }
     force = arrayContainsStr(sockMessageIn->options, OPTIONS_DATA[FORCE_OPT].name);
     restart = arrayContainsStr(sockMessageIn->options, OPTIONS_DATA[RESTART_OPT].name);
     reset = arrayContainsStr(sockMessageIn->options, OPTIONS_DATA[RESET_OPT].name);
@@ -655,6 +789,8 @@ int startUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
     len = (requires ? requires->size : 0);
     for (int i = 0; i < len; i++) {
         dep = arrayGet(requires, i);
+        if (arrayContainsStr(batchNames, dep))
+            continue;
         if (!(unitDep = getUnitByName(*units, dep)) ||
             unitDep->processData->pStateData->pState == DEAD ||
             *unitDep->processData->finalStatus != FINAL_STATUS_SUCCESS ||
@@ -724,19 +860,41 @@ int startUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
         }
         arrayRelease(&stopConflictsArr);
     }
+    initUnitSnapshot(unit);
     arrayAdd(*units, unit);
-    if (unit->type == TIMER || hasPipe(unit)) {
+    if (hasPipe(unit)) {
         unit->pipe = pipeNew();
-        if (unit->type != TIMER) {
-            unit->processDataHistory = arrayNew(processDataRelease);
-            listenPipes(NULL, unit);
-        } else if (unit->type == TIMER && reset)
-            resetNextTime(unitName);
-    } else if (unit->type == UPATH)
+        unit->processDataHistory = arrayNew(processDataRelease);
+        listenPipes(NULL, unit);
+    } else if (unit->type == TIMER && reset)
+        resetNextTime(unitName);
+    else if (unit->type == UPATH)
         addWatchers(&unit);
-    startProcesses(units, unit);
+    *unitPrepared = unit;
 
 out:
+    objectRelease(&unitName);
+    return rv;
+}
+
+int startUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut,
+                    bool sendResponse, bool isTimer)
+{
+    int rv = 0, rvMutex = 0;
+    char *buffer = NULL;
+    Unit *unit = NULL;
+
+    assert(sockMessageIn);
+    assert(*socketFd != -1);
+
+    if ((rvMutex = pthread_mutex_lock(&START_MUTEX)) != 0) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitServer", rvMutex,
+                 strerror(rvMutex), "Unable to lock the start mutex for %s!", sockMessageIn->arg);
+        kill(UNITD_PID, SIGTERM);
+    }
+    rv = prepareStartUnit(socketFd, sockMessageIn, sockMessageOut, sendResponse, NULL, &unit);
+    if (unit)
+        startProcesses(&UNITD_DATA->units, unit);
     if (sendResponse && !isTimer) {
         buffer = marshallResponse(*sockMessageOut, PARSE_SOCK_RESPONSE);
         if (DEBUG)
@@ -749,19 +907,18 @@ out:
         objectRelease(&buffer);
     }
     if ((rvMutex = pthread_mutex_unlock(&START_MUTEX)) != 0) {
-        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitServer", rv, strerror(rv),
-                 "Unable to unlock the start mutex for %s!", unitName);
+        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitServer", rvMutex,
+                 strerror(rvMutex), "Unable to unlock the start mutex for %s!", sockMessageIn->arg);
         kill(UNITD_PID, SIGTERM);
     }
 
-    objectRelease(&unitName);
     return rv;
 }
 
 int disableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut,
                       const char *unitNameArg, bool sendResponse)
 {
-    Array **unitsDisplay, **errors, **messages, *scriptParams = NULL, *statesData = NULL;
+    Array **unitsDisplay, **errors, **messages, *symlinkParams = NULL, *statesData = NULL;
     Unit *unit = NULL, *unitDisplay = NULL;
     char *unitName = NULL, *buffer = NULL, *stateStr = NULL, *from = NULL, *to = NULL;
     bool run = false, reEnable = false;
@@ -828,7 +985,7 @@ int disableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOu
         arrayAdd(*errors, getMsg(-1, UNITS_ERRORS_ITEMS[UNIT_ALREADY_ERR].desc, "disabled"));
         goto out;
     }
-    /* Call the script to remove symlinks from the states.
+    /* Remove the symlinks from the states.
      * We always consider the default state (or cmdline ), reboot and poweroff (system instance) or
      * user state (user instance)
     */
@@ -852,23 +1009,23 @@ int disableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOu
          * We show the message only if it is really there.
         */
         if (isEnabledUnit(unitName, state)) {
-            scriptParams = getScriptParams(unitName, stateStr, SYML_REMOVE_OP, unitDisplay->path);
-            from = arrayGet(scriptParams, 2);
-            to = arrayGet(scriptParams, 3);
-            rv = execScript(UNITD_DATA_PATH, "/scripts/symlink-handle.sh", scriptParams->arr, NULL);
-            if (rv != 0) {
+            symlinkParams = getSymlinkParams(unitName, stateStr, unitDisplay->path);
+            from = arrayGet(symlinkParams, 0);
+            to = arrayGet(symlinkParams, 1);
+            if ((rv = handleSymlink(SYML_REMOVE_OP, from, to)) != 0) {
                 arrayAdd(*errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_GENERIC_ERR].desc));
                 arrayAdd(*messages, getMsg(-1, UNITD_MESSAGES_ITEMS[UNITD_SYSTEM_LOG_MSG].desc));
-                logError(SYSTEM, "src/core/socket/socket_server.c", "disableUnitServer", rv,
-                         strerror(rv), "ExecScript error!");
                 goto out;
             } else {
-                if (unit)
+                if (unit) {
                     unit->enabled = false;
+                    updateUnitsBoard(unit, false);
+                    refreshUnitSnapshot(unit);
+                }
                 arrayAdd(*messages,
                          getMsg(-1, UNITS_MESSAGES_ITEMS[UNIT_REMOVED_SYML_MSG].desc, to, from));
             }
-            arrayRelease(&scriptParams);
+            arrayRelease(&symlinkParams);
         }
         objectRelease(&stateStr);
     }
@@ -893,16 +1050,17 @@ out:
     objectRelease(&unitName);
     arrayRelease(&statesData);
     objectRelease(&stateStr);
-    arrayRelease(&scriptParams);
+    arrayRelease(&symlinkParams);
     return rv;
 }
 
-int enableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut)
+int enableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut,
+                     bool sendResponse)
 {
     int rv = 0, len = 0;
     Array **units, **unitsDisplay, **errors, **messages, **unitDisplayErrors,
         *conflicts = NULL, *conflictNames = NULL, *unitsConflicts = NULL, *wantedBy,
-        *scriptParams = NULL, *requires = NULL;
+        *symlinkParams = NULL, *requires = NULL;
     Unit *unit = NULL, *unitDisplay = NULL, *unitConflict = NULL;
     char *unitName = NULL, *buffer = NULL, *stateStr = NULL, *from = NULL, *to = NULL;
     const char *conflictName = NULL;
@@ -1104,7 +1262,7 @@ int enableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
         }
         arrayRelease(&unitsConflicts);
     }
-    /* Call the script to add symlinks.
+    /* Add the symlinks.
      * We always consider the default state (or cmdline ), reboot and poweroff (system instance)
      * or user state (user instance)
     */
@@ -1117,24 +1275,24 @@ int enableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
         assert(state != NO_STATE);
         if (state == STATE_DEFAULT || state == STATE_CMDLINE || state == REBOOT ||
             state == POWEROFF || state == USER) {
-            scriptParams = getScriptParams(unitName, stateStr, SYML_ADD_OP, unitDisplay->path);
-            from = arrayGet(scriptParams, 2);
-            to = arrayGet(scriptParams, 3);
-            rv = execScript(UNITD_DATA_PATH, "/scripts/symlink-handle.sh", scriptParams->arr, NULL);
-            if (rv != 0) {
+            symlinkParams = getSymlinkParams(unitName, stateStr, unitDisplay->path);
+            from = arrayGet(symlinkParams, 0);
+            to = arrayGet(symlinkParams, 1);
+            if ((rv = handleSymlink(SYML_ADD_OP, from, to)) != 0) {
                 arrayAdd(*errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_GENERIC_ERR].desc));
                 arrayAdd(*messages, getMsg(-1, UNITD_MESSAGES_ITEMS[UNITD_SYSTEM_LOG_MSG].desc));
-                logError(SYSTEM, "src/core/socket/socket_server.c", "enableUnitServer", rv,
-                         strerror(rv), "ExecScript error!");
                 goto out;
             } else {
-                if (unit)
+                if (unit) {
                     unit->enabled = true;
+                    updateUnitsBoard(unit, false);
+                    refreshUnitSnapshot(unit);
+                }
                 unitDisplay->enabled = true;
                 arrayAdd(*messages,
                          getMsg(-1, UNITS_MESSAGES_ITEMS[UNIT_CREATED_SYML_MSG].desc, to, from));
             }
-            arrayRelease(&scriptParams);
+            arrayRelease(&symlinkParams);
         }
         objectRelease(&stateStr);
     }
@@ -1142,17 +1300,19 @@ int enableUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut
         startUnitServer(socketFd, sockMessageIn, sockMessageOut, false, false);
 
 out:
-    buffer = marshallResponse(*sockMessageOut, PARSE_SOCK_RESPONSE);
-    if (DEBUG)
-        syslog(LOG_DAEMON | LOG_DEBUG, "EnableUnitServer::Buffer sent (%lu): \n%s", strlen(buffer),
-               buffer);
-    if ((rv = uSend(*socketFd, buffer, strlen(buffer), 0)) == -1) {
-        logError(SYSTEM, "src/core/socket/socket_server.c", "enableUnitServer", errno,
-                 strerror(errno), "Send func returned -1 exit code!");
+    if (sendResponse) {
+        buffer = marshallResponse(*sockMessageOut, PARSE_SOCK_RESPONSE);
+        if (DEBUG)
+            syslog(LOG_DAEMON | LOG_DEBUG, "EnableUnitServer::Buffer sent (%lu): \n%s",
+                   strlen(buffer), buffer);
+        if ((rv = uSend(*socketFd, buffer, strlen(buffer), 0)) == -1) {
+            logError(SYSTEM, "src/core/socket/socket_server.c", "enableUnitServer", errno,
+                     strerror(errno), "Send func returned -1 exit code!");
+        }
     }
 
     objectRelease(&unitName);
-    arrayRelease(&scriptParams);
+    arrayRelease(&symlinkParams);
     objectRelease(&stateStr);
     objectRelease(&buffer);
     return rv;
@@ -1184,8 +1344,10 @@ int getUnitDataServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOu
     if (!unitName)
         unitName = sockMessageIn->arg;
     else {
-        objectRelease(&sockMessageIn->arg);
-        sockMessageIn->arg = unitName;
+        /* The arg belongs to the arena of the request */
+        sockMessageIn->arg = arenaStringNew(sockMessageIn->arena, unitName);
+        objectRelease(&unitName);
+        unitName = sockMessageIn->arg;
     }
     *unitsDisplay = arrayNew(unitRelease);
     unit = getUnitByName(*units, unitName);
@@ -1325,3 +1487,283 @@ int setDefaultStateServer(int *socketFd, SockMessageIn *sockMessageIn,
     objectRelease(&buffer);
     return rv;
 }
+
+static SockMessageIn *getBatchMessageIn(SockMessageIn *sockMessageIn, const char *unitName,
+                                        bool removeRun)
+{
+    SockMessageIn *unitMessageIn = sockMessageInNew();
+    Array *options = NULL;
+    char *option = NULL;
+
+    /* The unit message shares the arena of the batch request */
+    unitMessageIn->arena = sockMessageIn->arena;
+    unitMessageIn->command = sockMessageIn->command;
+    unitMessageIn->arg = arenaStringNew(unitMessageIn->arena, unitName);
+    if (sockMessageIn->options) {
+        options = arrayNew(NULL);
+        for (int i = 0; i < sockMessageIn->options->size; i++) {
+            option = arrayGet(sockMessageIn->options, i);
+            if (!removeRun || !stringEquals(option, OPTIONS_DATA[RUN_OPT].name))
+                arrayAdd(options, option);
+        }
+        unitMessageIn->options = options;
+    }
+
+    return unitMessageIn;
+}
+
+/* Adds the result of a single unit of the batch request.
+ * The errors of the unit are merged into its 'errors' array thus the client can
+ * show a result for each unit.
+*/
+static void addBatchResult(Array **unitsDisplay, Array **messages, const char *unitName,
+                           SockMessageOut *unitMessageOut)
+{
+    Unit *unit = NULL, *unitDisplay = NULL;
+    Array *errors = unitMessageOut->errors, *unitMessages = unitMessageOut->messages,
+          *unitsLoaded = unitMessageOut->unitsDisplay;
+    const char *error = NULL;
+    int len = 0;
+
+    unit = getUnitByName(UNITD_DATA->units, unitName);
+    if (unit) {
+        handleMutex(unit->mutex, true);
+        unitDisplay = unitNew(unit, PARSE_SOCK_RESPONSE);
+        handleMutex(unit->mutex, false);
+    } else if (unitsLoaded && unitsLoaded->size > 0)
+        unitDisplay = unitNew(arrayGet(unitsLoaded, 0), PARSE_SOCK_RESPONSE);
+    else {
+        unitDisplay = unitNew(NULL, PARSE_SOCK_RESPONSE);
+        unitDisplay->name = stringNew(unitName);
+    }
+    if (!unitDisplay->errors)
+        unitDisplay->errors = arrayNew(objectRelease);
+    len = (errors ? errors->size : 0);
+    for (int i = 0; i < len; i++) {
+        error = arrayGet(errors, i);
+        if (!arrayContainsStr(unitDisplay->errors, error))
+            arrayAdd(unitDisplay->errors, stringNew(error));
+    }
+    len = (unitMessages ? unitMessages->size : 0);
+    for (int i = 0; i < len; i++)
+        arrayAdd(*messages, stringNew(arrayGet(unitMessages, i)));
+    arrayAdd(*unitsDisplay, unitDisplay);
+}
+
+static void startUnitsBatch(int *socketFd, SockMessageIn *sockMessageIn, Array *unitNames,
+                            Array **unitsDisplay, Array **messages)
+{
+    int rvMutex = 0, len = 0;
+    Array *unitsMessageOut = NULL, *preparedNames = NULL, *unitsToStart = NULL;
+    SockMessageIn *unitMessageIn = NULL;
+    SockMessageOut *unitMessageOut = NULL;
+    Unit *unit = NULL;
+    const char *unitName = NULL;
+
+    if ((rvMutex = pthread_mutex_lock(&START_MUTEX)) != 0) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitsBatch", rvMutex,
+                 strerror(rvMutex), "Unable to lock the start mutex!");
+        kill(UNITD_PID, SIGTERM);
+    }
+    unitsMessageOut = arrayNew(sockMessageOutRelease);
+    preparedNames = arrayNew(NULL);
+    len = unitNames->size;
+    /* Checks and loading (serialized) */
+    for (int i = 0; i < len; i++) {
+        unitName = arrayGet(unitNames, i);
+        unitMessageIn = getBatchMessageIn(sockMessageIn, unitName, false);
+        unitMessageOut = sockMessageOutNew();
+        prepareStartUnit(socketFd, unitMessageIn, &unitMessageOut, true, unitNames, &unit);
+        if (unit)
+            arrayAdd(preparedNames, (void *)unitName);
+        arrayAdd(unitsMessageOut, unitMessageOut);
+        sockMessageInRelease(&unitMessageIn);
+    }
+    /* A forced conflict of a following unit might have released a prepared unit
+     * thus we retrieve them again by name.
+    */
+    unitsToStart = arrayNew(NULL);
+    for (int i = 0; i < preparedNames->size; i++) {
+        unit = getUnitByName(UNITD_DATA->units, arrayGet(preparedNames, i));
+        if (unit && *unit->processData->finalStatus == FINAL_STATUS_READY)
+            arrayAdd(unitsToStart, unit);
+    }
+    /* Starting (parallelized). Each unit waits for its dependencies. */
+    startProcessesList(&UNITD_DATA->units, &unitsToStart);
+    for (int i = 0; i < len; i++)
+        addBatchResult(unitsDisplay, messages, arrayGet(unitNames, i),
+                       arrayGet(unitsMessageOut, i));
+    if ((rvMutex = pthread_mutex_unlock(&START_MUTEX)) != 0) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "startUnitsBatch", rvMutex,
+                 strerror(rvMutex), "Unable to unlock the start mutex!");
+        kill(UNITD_PID, SIGTERM);
+    }
+
+    arrayRelease(&unitsToStart);
+    arrayRelease(&preparedNames);
+    arrayRelease(&unitsMessageOut);
+}
+
+static void stopUnitsBatch(Array *unitNames, Array **unitsDisplay, Array **messages)
+{
+    int len = 0;
+    Array **units = &UNITD_DATA->units, *unitsToStop = NULL, *runningUnits = NULL,
+          *unitsMessageOut = NULL, **errors = NULL;
+    SockMessageOut *unitMessageOut = NULL;
+    Unit *unit = NULL;
+    const char *unitName = NULL;
+    PState *pState = NULL;
+
+    unitsMessageOut = arrayNew(sockMessageOutRelease);
+    unitsToStop = arrayNew(NULL);
+    len = unitNames->size;
+    for (int i = 0; i < len; i++) {
+        unitMessageOut = sockMessageOutNew();
+        arrayAdd(unitsMessageOut, unitMessageOut);
+        unit = getUnitByName(*units, arrayGet(unitNames, i));
+        if (unit)
+            arrayAdd(unitsToStop, unit);
+    }
+    /* Stopping all the units (parallelized) */
+    runningUnits = getRunningUnits(&unitsToStop);
+    for (int i = 0; i < runningUnits->size; i++) {
+        unit = arrayGet(runningUnits, i);
+        unit->showResult = false;
+        unit->isStopping = true;
+    }
+    closePipes(&unitsToStop, NULL);
+    stopProcesses(&runningUnits, NULL);
+    handleMutex(&NOTIFIER_MUTEX, true);
+    handleMutex(&NOTIFIER_MUTEX, false);
+    for (int i = 0; i < len; i++) {
+        unitName = arrayGet(unitNames, i);
+        unitMessageOut = arrayGet(unitsMessageOut, i);
+        errors = &unitMessageOut->errors;
+        unitMessageOut->unitsDisplay = arrayNew(unitRelease);
+        unit = getUnitByName(*units, unitName);
+        if (unit) {
+            pState = &unit->processData->pStateData->pState;
+            if (unit->isChanged || unit->type == ONESHOT ||
+                (unit->errors && unit->errors->size > 0) ||
+                (unit->type == DAEMON && (*pState == EXITED || *pState == KILLED))) {
+                /* Release the unit and load "dead" data */
+                arrayRemove(*units, unit);
+                unit = NULL;
+                loadAndCheckUnit(&unitMessageOut->unitsDisplay, false, unitName, false, errors);
+            } else if (!getUnitByName(runningUnits, unitName) && *pState == DEAD) {
+                if (!(*errors))
+                    *errors = arrayNew(objectRelease);
+                arrayAdd(*errors, getMsg(-1, UNITS_ERRORS_ITEMS[UNIT_ALREADY_ERR].desc, "dead"));
+            }
+        } else if (loadAndCheckUnit(&unitMessageOut->unitsDisplay, false, unitName, false,
+                                    errors) == 0) {
+            if (!(*errors))
+                *errors = arrayNew(objectRelease);
+            arrayAdd(*errors, getMsg(-1, UNITS_ERRORS_ITEMS[UNIT_ALREADY_ERR].desc, "dead"));
+        }
+        addBatchResult(unitsDisplay, messages, unitName, unitMessageOut);
+    }
+
+    arrayRelease(&runningUnits);
+    arrayRelease(&unitsToStop);
+    arrayRelease(&unitsMessageOut);
+}
+
+int batchUnitServer(int *socketFd, SockMessageIn *sockMessageIn, SockMessageOut **sockMessageOut)
+{
+    int rv = 0, len = 0;
+    Array **unitsDisplay, **messages, *unitNames = NULL, *enabledNames = NULL,
+                                      *unitsMessageOut = NULL, *startDisplay = NULL;
+    char *buffer = NULL, *unitName = NULL;
+    bool run = false;
+    SockMessageIn *unitMessageIn = NULL;
+    SockMessageOut *unitMessageOut = NULL;
+    Unit *unitDisplay = NULL;
+
+    assert(sockMessageIn);
+    assert(sockMessageIn->unitNames);
+    assert(*socketFd != -1);
+
+    unitsDisplay = &(*sockMessageOut)->unitsDisplay;
+    *unitsDisplay = arrayNew(unitRelease);
+    messages = &(*sockMessageOut)->messages;
+    *messages = arrayNew(objectRelease);
+    /* Get the unit names removing the duplicates */
+    unitNames = arrayNew(objectRelease);
+    len = sockMessageIn->unitNames->size;
+    for (int i = 0; i < len; i++) {
+        unitName = getUnitName(arrayGet(sockMessageIn->unitNames, i));
+        if (!arrayContainsStr(unitNames, unitName))
+            arrayAdd(unitNames, unitName);
+        else
+            objectRelease(&unitName);
+    }
+    switch (sockMessageIn->command) {
+    case START_COMMAND:
+    case RESTART_COMMAND:
+        startUnitsBatch(socketFd, sockMessageIn, unitNames, unitsDisplay, messages);
+        break;
+    case STOP_COMMAND:
+        stopUnitsBatch(unitNames, unitsDisplay, messages);
+        break;
+    case ENABLE_COMMAND:
+        run = arrayContainsStr(sockMessageIn->options, OPTIONS_DATA[RUN_OPT].name);
+        unitsMessageOut = arrayNew(sockMessageOutRelease);
+        enabledNames = arrayNew(NULL);
+        /* Enabling (serialized) in the given order because the dependencies have to be
+         * enabled before the units which require them.
+        */
+        len = unitNames->size;
+        for (int i = 0; i < len; i++) {
+            unitName = arrayGet(unitNames, i);
+            unitMessageIn = getBatchMessageIn(sockMessageIn, unitName, true);
+            unitMessageOut = sockMessageOutNew();
+            enableUnitServer(socketFd, unitMessageIn, &unitMessageOut, false);
+            if (!unitMessageOut->errors || unitMessageOut->errors->size == 0) {
+                arrayAdd(enabledNames, unitName);
+                /* If we have to run it then the result will be the starting one.
+                 * We only keep the symlinks messages.
+                */
+                if (run) {
+                    for (int j = 0; j < unitMessageOut->messages->size; j++)
+                        arrayAdd(*messages, stringNew(arrayGet(unitMessageOut->messages, j)));
+                    arrayRelease(&unitMessageOut->messages);
+                }
+            }
+            arrayAdd(unitsMessageOut, unitMessageOut);
+            sockMessageInRelease(&unitMessageIn);
+        }
+        /* Starting the enabled units (parallelized) */
+        if (run && enabledNames->size > 0) {
+            startDisplay = arrayNew(unitRelease);
+            startUnitsBatch(socketFd, sockMessageIn, enabledNames, &startDisplay, messages);
+        }
+        for (int i = 0; i < len; i++) {
+            unitName = arrayGet(unitNames, i);
+            unitMessageOut = arrayGet(unitsMessageOut, i);
+            unitDisplay = getUnitByName(startDisplay, unitName);
+            if (unitDisplay)
+                arrayAdd(*unitsDisplay, unitNew(unitDisplay, PARSE_SOCK_RESPONSE));
+            else
+                addBatchResult(unitsDisplay, messages, unitName, unitMessageOut);
+        }
+        break;
+    default:
+        break;
+    }
+    buffer = marshallResponse(*sockMessageOut, PARSE_SOCK_RESPONSE);
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "BatchUnitServer::Buffer sent (%lu): \n%s", strlen(buffer),
+               buffer);
+    if ((rv = uSend(*socketFd, buffer, strlen(buffer), 0)) == -1) {
+        logError(SYSTEM, "src/core/socket/socket_server.c", "batchUnitServer", errno,
+                 strerror(errno), "Send func returned -1 exit code!");
+    }
+
+    arrayRelease(&startDisplay);
+    arrayRelease(&enabledNames);
+    arrayRelease(&unitsMessageOut);
+    arrayRelease(&unitNames);
+    objectRelease(&buffer);
+    return rv;
+}
@@ -7,13 +7,14 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 */
 
 int listenSocketRequest();
-int socketDispatchRequest(char *, int *);
+int socketDispatchRequest(char *, int *, bool *, struct ucred *, int *);
 int getUnitListServer(int *, SockMessageIn *, SockMessageOut **);
 int getUnitStatusServer(int *, SockMessageIn *, SockMessageOut **);
 int stopUnitServer(int *, SockMessageIn *, SockMessageOut **, bool);
 int startUnitServer(int *, SockMessageIn *, SockMessageOut **, bool, bool);
 int disableUnitServer(int *, SockMessageIn *, SockMessageOut **, const char *, bool);
-int enableUnitServer(int *, SockMessageIn *, SockMessageOut **);
+int enableUnitServer(int *, SockMessageIn *, SockMessageOut **, bool);
 int getUnitDataServer(int *, SockMessageIn *, SockMessageOut **);
 int getDefaultStateServer(int *, SockMessageIn *, SockMessageOut **);
 int setDefaultStateServer(int *, SockMessageIn *, SockMessageOut **);
+int batchUnitServer(int *, SockMessageIn *, SockMessageOut **);
@@ -13,6 +13,9 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #include "handlers/signals.h"
 #include "handlers/notifier.h"
 #include "handlers/cleaner.h"
+#include "handlers/scheduler.h"
+#include "board/board.h"
+#include "arena/arena.h"
 #include "common/common.h"
 #include "socket/socket_client.h"
 #include "socket/socket_common.h"
@@ -24,6 +27,8 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #include "commands/commands.h"
 #include "units/units.h"
 #include "units/utimers/utimers.h"
+#include "units/utimers/timer_journal.h"
+#include "units/utimers/calendar.h"
 #include "units/upath/upath.h"
 #include "logger/logger.h"
 
@@ -38,6 +43,8 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #endif
 
 #define PROC_CMDLINE_UNITD_DEBUG "unitd_debug=true"
+#define PROC_CMDLINE_UNITD_CATCHUP_MAX "unitd_timers_catchup_max="
+#define PROC_CMDLINE_UNITD_CATCHUP_SPREAD "unitd_timers_catchup_spread="
 #define PATH_ENV_VAR "/usr/bin:/usr/sbin:/bin:/sbin"
 
 #define UNUSED __attribute__((unused))
@@ -70,7 +77,11 @@ extern pthread_mutex_t START_MUTEX;
 extern pthread_mutex_t NOTIFIER_MUTEX;
 
 /* Errors */
-typedef enum { UNITD_GENERIC_ERR = 0, UNITD_SOCKBUF_ERR = 1 } UnitdErrorsEnum;
+typedef enum {
+    UNITD_GENERIC_ERR = 0,
+    UNITD_SOCKBUF_ERR = 1,
+    UNITD_PERMISSION_ERR = 2
+} UnitdErrorsEnum;
 typedef struct {
     UnitdErrorsEnum errorEnum;
     const char *desc;
@@ -78,11 +78,14 @@ const UnitsErrorsData UNITS_ERRORS_ITEMS[] = {
     { UNIT_CHANGED_ERR, "The unit content is changed!" },
     { UNIT_ENABLE_STATE_ERR, "Unable to perform the enabling!" },
     { UNIT_EXIST_ERR, "'%s' already exists!" },
-    { UTIMER_INTERVAL_ERR, "At least one criterion must be defined for the interval!" },
+    { UTIMER_INTERVAL_ERR,
+      "At least one criterion must be defined for the interval or the calendar expression!" },
     { UPATH_WELL_FORMED_PATH_ERR, "The '%s' property path is not well formed!" },
     { UPATH_PATH_SEC_ERR, "At least one path to be monitored must be defined!" },
     { UPATH_ACCESS_ERR, "Unable to access to '%s' property path!" },
-    { UPATH_PATH_RESOURCE_ERR, "The '%s' property path doesn't look like a %s!" }
+    { UPATH_PATH_RESOURCE_ERR, "The '%s' property path doesn't look like a %s!" },
+    { UTIMER_CALENDAR_ERR, "The '%s' calendar expression is not valid!" },
+    { UTIMER_INTERVAL_CALENDAR_ERR, "The interval and the calendar expression are exclusive!" }
 };
 
 const UnitsMessagesData UNITS_MESSAGES_ITEMS[] = {
@@ -205,6 +208,14 @@ Unit *unitNew(Unit *unitFrom, ParserFuncType funcType)
     unit->type = (unitFrom ? unitFrom->type : DAEMON);
     unit->isChanged = (unitFrom && unitFrom->isChanged ? true : false);
     //TIMER DATA
+    /* Accuracy */
+    int *accuracySec = NULL;
+    if (unitFrom && unitFrom->accuracySec) {
+        accuracySec = calloc(1, sizeof(int));
+        assert(accuracySec);
+        *accuracySec = *unitFrom->accuracySec;
+    }
+    unit->accuracySec = accuracySec;
     /* Seconds */
     int *seconds = NULL;
     if (unitFrom && unitFrom->intSeconds) {
@@ -277,6 +288,14 @@ Unit *unitNew(Unit *unitFrom, ParserFuncType funcType)
         stringCopy(unit->nextTimeDate, unitFrom->nextTimeDate);
     } else
         unit->nextTimeDate = NULL;
+    /* Wakeups saved */
+    int *wakeupsSaved = NULL;
+    if (unitFrom && unitFrom->wakeupsSaved) {
+        wakeupsSaved = calloc(1, sizeof(int));
+        assert(wakeupsSaved);
+        *wakeupsSaved = *unitFrom->wakeupsSaved;
+    }
+    unit->wakeupsSaved = wakeupsSaved;
     //END TIMER DATA
     if (funcType == PARSE_SOCK_RESPONSE || funcType == PARSE_UNIT) {
         unit->requires = (unitFrom ? arrayStrCopy(unitFrom->requires) : NULL);
@@ -327,6 +346,9 @@ Unit *unitNew(Unit *unitFrom, ParserFuncType funcType)
         unit->pathResourceChangedMonitor = NULL;
         unit->pathDirectoryNotEmpty = NULL;
         unit->pathDirectoryNotEmptyMonitor = NULL;
+        unit->triggerQuietSec = NULL;
+        unit->triggerLimitIntervalSec = NULL;
+        unit->triggerLimitBurst = NULL;
         /* Initialize mutex */
         pthread_mutex_t *mutex = NULL;
         mutex = calloc(1, sizeof(pthread_mutex_t));
@@ -681,10 +703,6 @@ int loadUnits(Array **units, const char *path, const char *dirName, State curren
                             unit->processDataHistory = arrayNew(processDataRelease);
                         }
                         break;
-                    case TIMER:
-                        /* We always need of the pipe. No need of a processDataHistory instead. */
-                        unit->pipe = pipeNew();
-                        break;
                     case UPATH:
                         addWatchers(&unit);
                         break;
@@ -692,6 +710,8 @@ int loadUnits(Array **units, const char *path, const char *dirName, State curren
                         break;
                     }
                 }
+                if (funcType == PARSE_UNIT)
+                    initUnitSnapshot(unit);
                 arrayAdd(*units, unit);
             } else
                 objectRelease(&unitName);
@@ -987,6 +1007,7 @@ void unitRelease(Unit **unit)
         objectRelease(&unitTemp->pathUnitPState);
         /* Unit timer data */
         objectRelease(&unitTemp->wakeSystem);
+        objectRelease(&unitTemp->accuracySec);
         objectRelease(&unitTemp->intSeconds);
         objectRelease(&unitTemp->intMinutes);
         objectRelease(&unitTemp->intHours);
@@ -995,9 +1016,11 @@ void unitRelease(Unit **unit)
         objectRelease(&unitTemp->intMonths);
         objectRelease(&unitTemp->leftTimeDuration);
         objectRelease(&unitTemp->nextTimeDate);
+        objectRelease(&unitTemp->wakeupsSaved);
         objectRelease(&unitTemp->leftTime);
         timeRelease(&unitTemp->nextTime);
         objectRelease(&unitTemp->intervalStr);
+        calendarRelease(&unitTemp->calendar);
         timerRelease(&unitTemp->timer);
         /* Path unit */
         objectRelease(&unitTemp->pathExists);
@@ -1008,11 +1031,137 @@ void unitRelease(Unit **unit)
         objectRelease(&unitTemp->pathResourceChangedMonitor);
         objectRelease(&unitTemp->pathDirectoryNotEmpty);
         objectRelease(&unitTemp->pathDirectoryNotEmptyMonitor);
+        objectRelease(&unitTemp->triggerQuietSec);
+        objectRelease(&unitTemp->triggerLimitIntervalSec);
+        objectRelease(&unitTemp->triggerLimitBurst);
         notifierRelease(&unitTemp->notifier);
+        unitSnapshotRelease(&unitTemp->snapshot);
         objectRelease(unit);
     }
 }
 
+/* Protects the snapshot pointers of the units while a reader takes its reference */
+static pthread_mutex_t SNAPSHOT_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+static UnitSnapshot *unitSnapshotNew(Unit *unit)
+{
+    UnitSnapshot *snapshot = calloc(1, sizeof(UnitSnapshot));
+    assert(snapshot);
+
+    snapshot->unitDisplay = unitNew(unit, PARSE_SOCK_RESPONSE);
+    snapshot->unitDisplay->snapshot = snapshot;
+    snapshot->unitListDisplay = unitNew(unit, PARSE_SOCK_RESPONSE_UNITLIST);
+    snapshot->unitListDisplay->snapshot = snapshot;
+    /* The first reference belongs to the publisher */
+    snapshot->refCount = 1;
+
+    return snapshot;
+}
+
+void unitSnapshotRelease(UnitSnapshot **snapshot)
+{
+    if (*snapshot) {
+        if (__atomic_sub_fetch(&(*snapshot)->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+            (*snapshot)->unitDisplay->snapshot = NULL;
+            unitRelease(&(*snapshot)->unitDisplay);
+            (*snapshot)->unitListDisplay->snapshot = NULL;
+            unitRelease(&(*snapshot)->unitListDisplay);
+            objectRelease(snapshot);
+        }
+        *snapshot = NULL;
+    }
+}
+
+void unitDisplayRelease(Unit **unitDisplay)
+{
+    UnitSnapshot *snapshot = NULL;
+
+    if (*unitDisplay) {
+        /* If the unit belongs to a snapshot then we only drop our reference */
+        if ((snapshot = (*unitDisplay)->snapshot)) {
+            if (*unitDisplay != snapshot->unitDisplay &&
+                *unitDisplay != snapshot->unitListDisplay) {
+                /* Status unit (see unitStatusNew()) */
+                objectRelease(&(*unitDisplay)->timerName);
+                objectRelease(&(*unitDisplay)->timerPState);
+                objectRelease(&(*unitDisplay)->pathUnitName);
+                objectRelease(&(*unitDisplay)->pathUnitPState);
+                objectRelease(unitDisplay);
+            }
+            *unitDisplay = NULL;
+            unitSnapshotRelease(&snapshot);
+        } else
+            unitRelease(unitDisplay);
+    }
+}
+
+/* The first snapshot is published before the unit is shared with the other threads */
+void initUnitSnapshot(Unit *unit)
+{
+    assert(unit);
+    assert(!unit->snapshot);
+
+    unit->snapshot = unitSnapshotNew(unit);
+}
+
+void publishUnitSnapshot(Unit *unit)
+{
+    UnitSnapshot *snapshot = NULL, *oldSnapshot = NULL;
+
+    assert(unit);
+
+    /* The caller must own the unit mutex.
+     * The unit keeps the publisher reference of the new snapshot and we release the old one.
+     * The readers still using the old one keep it alive by their own reference.
+    */
+    __atomic_store_n(&unit->isSnapshotStale, false, __ATOMIC_RELEASE);
+    snapshot = unitSnapshotNew(unit);
+    handleMutex(&SNAPSHOT_MUTEX, true);
+    oldSnapshot = unit->snapshot;
+    unit->snapshot = snapshot;
+    handleMutex(&SNAPSHOT_MUTEX, false);
+    unitSnapshotRelease(&oldSnapshot);
+    updateUnitsBoard(unit, true);
+}
+
+/* The snapshot is only published when the unit state changes, so the readers never lock the unit
+ * and they only take a reference. The caller has to release it by unitSnapshotRelease.
+*/
+UnitSnapshot *getUnitSnapshot(Unit *unit)
+{
+    UnitSnapshot *snapshot = NULL;
+
+    assert(unit);
+
+    /* The snapshot mutex only protects the pointer swap against our reference */
+    handleMutex(&SNAPSHOT_MUTEX, true);
+    snapshot = unit->snapshot;
+    assert(snapshot);
+    __atomic_add_fetch(&snapshot->refCount, 1, __ATOMIC_RELAXED);
+    handleMutex(&SNAPSHOT_MUTEX, false);
+
+    return snapshot;
+}
+
+/* The status unit is a shallow copy of the snapshot one which only owns the data added by the
+ * request (timer and path unit data). It takes over the reference of the snapshot thus the caller
+ * has to release it by unitDisplayRelease.
+*/
+Unit *unitStatusNew(UnitSnapshot *snapshot)
+{
+    Unit *unitStatus = calloc(1, sizeof(Unit));
+    assert(unitStatus);
+    assert(snapshot);
+
+    *unitStatus = *snapshot->unitDisplay;
+    unitStatus->timerName = NULL;
+    unitStatus->timerPState = NULL;
+    unitStatus->pathUnitName = NULL;
+    unitStatus->pathUnitPState = NULL;
+
+    return unitStatus;
+}
+
 ProcessData *processDataNew(ProcessData *pDataFrom, ParserFuncType funcType)
 {
     ProcessData *pDataRet = NULL;
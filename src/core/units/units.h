@@ -40,7 +40,9 @@ typedef enum {
     UPATH_WELL_FORMED_PATH_ERR = 23,
     UPATH_PATH_SEC_ERR = 24,
     UPATH_ACCESS_ERR = 25,
-    UPATH_PATH_RESOURCE_ERR = 26
+    UPATH_PATH_RESOURCE_ERR = 26,
+    UTIMER_CALENDAR_ERR = 27,
+    UTIMER_INTERVAL_CALENDAR_ERR = 28
 } UnitsErrorsEnum;
 typedef struct {
     UnitsErrorsEnum errorEnum;
@@ -68,6 +70,15 @@ typedef struct {
 } UnitsMessagesData;
 extern const UnitsMessagesData UNITS_MESSAGES_ITEMS[];
 
+/* Immutable and reference counted copy of the unit status.
+ * The status and the list have their own display unit which points to the snapshot.
+*/
+struct UnitSnapshot {
+    Unit *unitDisplay;
+    Unit *unitListDisplay;
+    int refCount;
+};
+
 typedef struct {
     ListFilter listFilter;
     const char *desc;
@@ -77,6 +88,12 @@ extern int LIST_FILTER_LEN;
 
 Unit *unitNew(Unit *, ParserFuncType);
 void unitRelease(Unit **);
+void unitDisplayRelease(Unit **);
+void unitSnapshotRelease(UnitSnapshot **);
+void initUnitSnapshot(Unit *);
+void publishUnitSnapshot(Unit *);
+UnitSnapshot *getUnitSnapshot(Unit *);
+Unit *unitStatusNew(UnitSnapshot *);
 ProcessData *processDataNew(ProcessData *, ParserFuncType);
 void resetPDataForRestart(ProcessData **);
 void processDataRelease(ProcessData **);
@@ -18,7 +18,10 @@ enum PropertyNameEnum {
     PATH_EXISTS_GLOB = 4,
     PATH_RESOURCE_CHANGED = 5,
     PATH_DIRECTORY_NOT_EMPTY = 6,
-    WANTEDBY = 7
+    WANTEDBY = 7,
+    TRIGGER_QUIET_SEC = 8,
+    TRIGGER_LIMIT_INTERVAL_SEC = 9,
+    TRIGGER_LIMIT_BURST = 10
 };
 int UPATH_SECTIONS_ITEMS_LEN = 3;
 SectionData UPATH_SECTIONS_ITEMS[] = { { { UNIT, "[Unit]" }, false, true, 0 },
@@ -31,7 +34,7 @@ static const char *WANTEDBY_VALUES[] = { STATE_DATA_ITEMS[SINGLE_USER].desc,
                                          STATE_DATA_ITEMS[GRAPHICAL].desc,
                                          STATE_DATA_ITEMS[USER].desc,
                                          NULL };
-int UPATH_PROPERTIES_ITEMS_LEN = 8;
+int UPATH_PROPERTIES_ITEMS_LEN = 11;
 // clang-format off
 PropertyData UPATH_PROPERTIES_ITEMS[] = {
     { UNIT,  { DESCRIPTION, "Description" }, false, true, false, 0, NULL, NULL },
@@ -41,7 +44,10 @@ PropertyData UPATH_PROPERTIES_ITEMS[] = {
     { PATH,  { PATH_EXISTS_GLOB, "PathExistsGlob" }, false, false, false, 0, NULL, NULL },
     { PATH,  { PATH_RESOURCE_CHANGED, "PathResourceChanged" }, false, false, false, 0, NULL, NULL },
     { PATH,  { PATH_DIRECTORY_NOT_EMPTY, "PathDirectoryNotEmpty" }, false, false, false, 0, NULL, NULL },
-    { STATE, { WANTEDBY, "WantedBy" }, true, true, false, 0, WANTEDBY_VALUES, NULL }
+    { STATE, { WANTEDBY, "WantedBy" }, true, true, false, 0, WANTEDBY_VALUES, NULL },
+    { PATH,  { TRIGGER_QUIET_SEC, "TriggerQuietSec" }, false, false, true, 0, NULL, NULL },
+    { PATH,  { TRIGGER_LIMIT_INTERVAL_SEC, "TriggerLimitIntervalSec" }, false, false, true, 0, NULL, NULL },
+    { PATH,  { TRIGGER_LIMIT_BURST, "TriggerLimitBurst" }, false, false, true, 0, NULL, NULL }
 };
 // clang-format on
 //END PARSER CONFIGURATION
@@ -165,7 +171,7 @@ void addWatchers(Unit **unit)
         if (watchPathMonitor)
             arrayAdd(notifier->watchers, watcherNew(notifier, watchPathMonitor, watcherType));
     }
-    if (notifierInit(notifier) != 0)
+    if (checkWatcherPaths(notifier) != 0)
         arrayAdd((*unit)->errors, getMsg(-1, UNITD_ERRORS_ITEMS[UNITD_GENERIC_ERR].desc));
 }
 
@@ -260,6 +266,21 @@ int parsePathUnit(Array **units, Unit **unit, bool isAggregate)
                     case WANTEDBY:
                         arrayAdd(wantedBy, stringNew(value));
                         break;
+                    case TRIGGER_QUIET_SEC:
+                        (*unit)->triggerQuietSec = calloc(1, sizeof(int));
+                        assert((*unit)->triggerQuietSec);
+                        *(*unit)->triggerQuietSec = atoi(value);
+                        break;
+                    case TRIGGER_LIMIT_INTERVAL_SEC:
+                        (*unit)->triggerLimitIntervalSec = calloc(1, sizeof(int));
+                        assert((*unit)->triggerLimitIntervalSec);
+                        *(*unit)->triggerLimitIntervalSec = atoi(value);
+                        break;
+                    case TRIGGER_LIMIT_BURST:
+                        (*unit)->triggerLimitBurst = calloc(1, sizeof(int));
+                        assert((*unit)->triggerLimitBurst);
+                        *(*unit)->triggerLimitBurst = atoi(value);
+                        break;
                     }
                 }
             }
@@ -0,0 +1,363 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../../unitd_impl.h"
+
+/* CALENDAR EXPRESSIONS
+
+OnCalendar = [WeekDays] [Year-]Month-Day [Hour:Minute[:Second]]
+
+Each field can be '*', a value, a range (a..b), a list (a,b,c) and a repetition (a/n).
+The repetition starts from a value or from the minimum if '*' is used.
+The week days are the English names (Mon, Tue, ...) or their ranges (Mon..Fri).
+The date and the time are optional, their default values are respectively '*-*-*' and '00:00:00'.
+The 'minutely', 'hourly', 'daily', 'weekly', 'monthly' and 'yearly' shortcuts are allowed too.
+
+An expression is compiled into a bitmask for each field.
+The next value of a field is the first set bit from the current one (ctz), so the next time is
+computed field by field and a carry to the upper field resets the lower ones.
+The days are checked together with the week days by a mask for each week day of the first day
+of the month. The next time is computed in local time and converted by mktime() thus the daylight
+saving time is handled.
+
+*/
+
+static const char *CALENDAR_SHORTCUTS[][2] = {
+    { "minutely", "*-*-* *:*:00" }, { "hourly", "*-*-* *:00:00" },
+    { "daily", "*-*-* 00:00:00" },  { "weekly", "Mon *-*-* 00:00:00" },
+    { "monthly", "*-*-01 00:00:00" }, { "yearly", "*-01-01 00:00:00" },
+};
+static const char *WEEK_DAYS[] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+
+Calendar *calendarNew()
+{
+    Calendar *calendar = calloc(1, sizeof(Calendar));
+    assert(calendar);
+
+    return calendar;
+}
+
+void calendarRelease(Calendar **calendar)
+{
+    objectRelease(calendar);
+}
+
+static void setCalendarBit(uint64_t *mask, int bit)
+{
+    mask[bit / 64] |= 1ULL << (bit % 64);
+}
+
+static int getNextBit(uint64_t mask, int from)
+{
+    if (from < 0)
+        from = 0;
+    if (from >= 64)
+        return -1;
+    mask &= ~0ULL << from;
+
+    return mask ? __builtin_ctzll(mask) : -1;
+}
+
+static int getNextYear(Calendar *calendar, int year)
+{
+    int bit = year - CALENDAR_MIN_YEAR, next = -1;
+
+    if (bit < 0)
+        bit = 0;
+    for (int i = bit / 64; i < 2; i++) {
+        if ((next = getNextBit(calendar->years[i], i == bit / 64 ? bit % 64 : 0)) != -1)
+            return CALENDAR_MIN_YEAR + i * 64 + next;
+    }
+
+    return -1;
+}
+
+static bool isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int getDaysInMonth(int year, int month)
+{
+    static const int DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    return (month == 1 && isLeapYear(year)) ? 29 : DAYS[month];
+}
+
+/* Returns the week day (Sunday = 0) of a date. The month starts from 0. */
+static int getWeekDay(int year, int month, int day)
+{
+    static const int OFFSETS[] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+
+    if (month < 2)
+        year--;
+
+    return (year + year / 4 - year / 100 + year / 400 + OFFSETS[month] + day) % 7;
+}
+
+static int parseCalendarValue(const char *str, char **endPtr, bool weekDay)
+{
+    long value = -1;
+
+    if (weekDay) {
+        for (int i = 0; i < 7; i++) {
+            if (strncasecmp(str, WEEK_DAYS[i], 3) == 0) {
+                /* The full names are allowed too (Monday) */
+                *endPtr = (char *)str + 3;
+                while (isalpha(**endPtr))
+                    (*endPtr)++;
+                return i;
+            }
+        }
+        return -1;
+    }
+    if (!isdigit(*str))
+        return -1;
+    value = strtol(str, endPtr, 10);
+
+    return value > INT_MAX ? -1 : value;
+}
+
+/* Parse a field (list of values, ranges and repetitions) and set the bits into the mask.
+ * The bit of a value is 'value - base'.
+*/
+static int parseCalendarField(char *field, int min, int max, int base, bool weekDay,
+                              uint64_t *mask)
+{
+    char *item = NULL, *savePtr = NULL, *endPtr = NULL;
+    int start = 0, end = 0, step = 1;
+
+    for (item = strtok_r(field, ",", &savePtr); item; item = strtok_r(NULL, ",", &savePtr)) {
+        step = 1;
+        if (*item == '*') {
+            start = min;
+            end = max;
+            endPtr = item + 1;
+        } else {
+            if ((start = parseCalendarValue(item, &endPtr, weekDay)) == -1)
+                return 1;
+            end = start;
+            if (strncmp(endPtr, "..", 2) == 0) {
+                if ((end = parseCalendarValue(endPtr + 2, &endPtr, weekDay)) == -1)
+                    return 1;
+            }
+        }
+        if (*endPtr == '/') {
+            /* A repetition without range goes up to the maximum */
+            if (start == end)
+                end = max;
+            if ((step = parseCalendarValue(endPtr + 1, &endPtr, false)) <= 0)
+                return 1;
+        }
+        if (*endPtr != '\0' || start < min || end > max || start > end)
+            return 1;
+        for (int value = start; value <= end; value += step)
+            setCalendarBit(mask, value - base);
+    }
+
+    return item || !field[0] ? 1 : 0;
+}
+
+static int parseCalendarDate(char *date, Calendar *calendar)
+{
+    char *fields[3] = { NULL }, *savePtr = NULL, *field = NULL;
+    int numFields = 0;
+    char yearsAll[] = "*";
+
+    for (field = strtok_r(date, "-", &savePtr); field; field = strtok_r(NULL, "-", &savePtr)) {
+        if (numFields == 3)
+            return 1;
+        fields[numFields++] = field;
+    }
+    /* The year is optional */
+    if (numFields == 2) {
+        fields[2] = fields[1];
+        fields[1] = fields[0];
+        fields[0] = yearsAll;
+    } else if (numFields != 3)
+        return 1;
+
+    return parseCalendarField(fields[0], CALENDAR_MIN_YEAR, CALENDAR_MAX_YEAR, CALENDAR_MIN_YEAR,
+                              false, calendar->years) ||
+           parseCalendarField(fields[1], 1, 12, 1, false, &calendar->months) ||
+           parseCalendarField(fields[2], 1, 31, 0, false, &calendar->days);
+}
+
+static int parseCalendarTime(char *timeStr, Calendar *calendar)
+{
+    char *fields[3] = { NULL }, *savePtr = NULL, *field = NULL;
+    int numFields = 0;
+    char secondsZero[] = "0";
+
+    for (field = strtok_r(timeStr, ":", &savePtr); field; field = strtok_r(NULL, ":", &savePtr)) {
+        if (numFields == 3)
+            return 1;
+        fields[numFields++] = field;
+    }
+    /* The seconds are optional */
+    if (numFields == 2)
+        fields[2] = secondsZero;
+    else if (numFields != 3)
+        return 1;
+
+    return parseCalendarField(fields[0], 0, 23, 0, false, &calendar->hours) ||
+           parseCalendarField(fields[1], 0, 59, 0, false, &calendar->minutes) ||
+           parseCalendarField(fields[2], 0, 59, 0, false, &calendar->seconds);
+}
+
+int parseCalendar(const char *expr, Calendar *calendar)
+{
+    char *buffer = NULL, *token = NULL, *savePtr = NULL, *weekDays = NULL, *date = NULL,
+         *timeStr = NULL;
+    char dateAll[] = "*-*-*", timeZero[] = "00:00:00", weekDaysAll[] = "*";
+    int rv = 0, lenShortcuts = sizeof(CALENDAR_SHORTCUTS) / sizeof(CALENDAR_SHORTCUTS[0]);
+
+    assert(expr);
+    assert(calendar);
+
+    memset(calendar, 0, sizeof(Calendar));
+    for (int i = 0; i < lenShortcuts; i++) {
+        if (strcasecmp(expr, CALENDAR_SHORTCUTS[i][0]) == 0) {
+            expr = CALENDAR_SHORTCUTS[i][1];
+            break;
+        }
+    }
+    buffer = stringNew(expr);
+    for (token = strtok_r(buffer, " \t", &savePtr); token;
+         token = strtok_r(NULL, " \t", &savePtr)) {
+        if (!weekDays && !date && !timeStr && isalpha(*token))
+            weekDays = token;
+        else if (!date && !timeStr && strchr(token, '-'))
+            date = token;
+        else if (!timeStr && strchr(token, ':'))
+            timeStr = token;
+        else {
+            rv = 1;
+            goto out;
+        }
+    }
+    if (!weekDays && !date && !timeStr) {
+        rv = 1;
+        goto out;
+    }
+    if ((rv = parseCalendarField(weekDays ? weekDays : weekDaysAll, 0, 6, 0, true,
+                                 &calendar->weekDays)) != 0 ||
+        (rv = parseCalendarDate(date ? date : dateAll, calendar)) != 0 ||
+        (rv = parseCalendarTime(timeStr ? timeStr : timeZero, calendar)) != 0)
+        goto out;
+    /* Precompute the days which match the week days for each week day of the first day */
+    for (int firstWeekDay = 0; firstWeekDay < 7; firstWeekDay++) {
+        for (int day = 1; day <= 31; day++) {
+            if ((calendar->days & (1ULL << day)) &&
+                (calendar->weekDays & (1ULL << ((firstWeekDay + day - 1) % 7))))
+                calendar->dayMasks[firstWeekDay] |= 1ULL << day;
+        }
+    }
+    /* The expression must elapse at least once (i.e. not 'Feb 30') */
+    if (getCalendarNextTime(calendar, time(NULL)) == -1)
+        rv = 1;
+
+out:
+    objectRelease(&buffer);
+    return rv;
+}
+
+long getCalendarNextTime(Calendar *calendar, long after)
+{
+    struct tm tmTime = { 0 };
+    time_t next = after + 1;
+    int year, month, day, hour, minute, second, value, daysInMonth;
+    uint64_t dayMask = 0;
+
+    assert(calendar);
+
+    if (!localtime_r(&next, &tmTime))
+        return -1;
+    year = tmTime.tm_year + 1900;
+    month = tmTime.tm_mon;
+    day = tmTime.tm_mday;
+    hour = tmTime.tm_hour;
+    minute = tmTime.tm_min;
+    second = tmTime.tm_sec;
+    for (int i = 0; i < CALENDAR_MAX_STEPS; i++) {
+        if ((value = getNextYear(calendar, year)) == -1)
+            return -1;
+        if (value != year) {
+            year = value;
+            month = 0;
+            day = 1;
+            hour = minute = second = 0;
+        }
+        if ((value = getNextBit(calendar->months, month)) == -1) {
+            year++;
+            month = 0;
+            day = 1;
+            hour = minute = second = 0;
+            continue;
+        }
+        if (value != month) {
+            month = value;
+            day = 1;
+            hour = minute = second = 0;
+        }
+        daysInMonth = getDaysInMonth(year, month);
+        dayMask = calendar->dayMasks[getWeekDay(year, month, 1)] & ((2ULL << daysInMonth) - 1);
+        if ((value = getNextBit(dayMask, day)) == -1) {
+            /* The months are checked again with the next iteration (carry included) */
+            if (++month == 12) {
+                year++;
+                month = 0;
+            }
+            day = 1;
+            hour = minute = second = 0;
+            continue;
+        }
+        if (value != day) {
+            day = value;
+            hour = minute = second = 0;
+        }
+        if ((value = getNextBit(calendar->hours, hour)) == -1) {
+            day++;
+            hour = minute = second = 0;
+            continue;
+        }
+        if (value != hour) {
+            hour = value;
+            minute = second = 0;
+        }
+        if ((value = getNextBit(calendar->minutes, minute)) == -1) {
+            hour++;
+            minute = second = 0;
+            continue;
+        }
+        if (value != minute) {
+            minute = value;
+            second = 0;
+        }
+        if ((value = getNextBit(calendar->seconds, second)) == -1) {
+            minute++;
+            second = 0;
+            continue;
+        }
+        second = value;
+        memset(&tmTime, 0, sizeof(struct tm));
+        tmTime.tm_year = year - 1900;
+        tmTime.tm_mon = month;
+        tmTime.tm_mday = day;
+        tmTime.tm_hour = hour;
+        tmTime.tm_min = minute;
+        tmTime.tm_sec = second;
+        tmTime.tm_isdst = -1;
+        if ((next = mktime(&tmTime)) != -1 && next > after)
+            return next;
+        /* The local time has been repeated by the daylight saving time */
+        second++;
+    }
+
+    return -1;
+}
@@ -0,0 +1,16 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#define CALENDAR_MIN_YEAR 1970
+#define CALENDAR_MAX_YEAR 2097
+#define CALENDAR_MAX_STEPS 4096
+
+Calendar *calendarNew();
+void calendarRelease(Calendar **);
+int parseCalendar(const char *, Calendar *);
+long getCalendarNextTime(Calendar *, long);
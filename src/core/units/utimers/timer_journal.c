@@ -0,0 +1,484 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../../unitd_impl.h"
+
+/* TIMERS JOURNAL
+
+The next and last times of the timers are saved into an append-only journal of
+fixed-size records. Each record contains a checksum so a record which has been
+partially written (crash) is detected and the journal is truncated there.
+The journal is loaded in one read when unitd starts and the current state of the
+timers is kept in memory. When the obsolete records are too many, the journal is
+compacted into a temporary file which replaces it atomically (rename), then the
+directory is synced so the replacement survives a crash.
+The clients read the same file to show the last time of the timers.
+
+*/
+
+static Array *TIMER_STATES = NULL;
+static char *JOURNAL_PATH = NULL;
+static int JOURNAL_FD = -1;
+static off_t JOURNAL_SIZE = 0;
+static int JOURNAL_RECORDS = 0;
+static pthread_mutex_t JOURNAL_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+TimerState *timerStateNew(const char *name)
+{
+    TimerState *timerState = calloc(1, sizeof(TimerState));
+    assert(timerState);
+    timerState->name = stringNew(name);
+    timerState->nextTime = -1;
+    timerState->lastTime = -1;
+    timerState->lastStatus = -1;
+
+    return timerState;
+}
+
+void timerStateRelease(TimerState **timerState)
+{
+    if (*timerState) {
+        objectRelease(&(*timerState)->name);
+        objectRelease(timerState);
+    }
+}
+
+TimerState *getTimerStateByName(Array *timerStates, const char *name)
+{
+    TimerState *timerState = NULL;
+    int len = (timerStates ? timerStates->size : 0);
+
+    for (int i = 0; i < len; i++) {
+        timerState = arrayGet(timerStates, i);
+        if (stringEquals(timerState->name, name))
+            return timerState;
+    }
+
+    return NULL;
+}
+
+static char *getTimerJournalPath()
+{
+    char *journalPath = NULL;
+
+    if (!USER_INSTANCE)
+        journalPath = stringNew(UNITD_TIMER_DATA_PATH);
+    else
+        journalPath = stringNew(UNITD_USER_TIMER_DATA_PATH);
+    stringAppendChr(&journalPath, '/');
+    stringAppendStr(&journalPath, TIMER_JOURNAL_NAME);
+
+    return journalPath;
+}
+
+static uint32_t getRecordChecksum(TimerRecord *timerRecord)
+{
+    TimerRecord copy = *timerRecord;
+    const unsigned char *bytes = (const unsigned char *)&copy;
+    uint32_t crc = 0xFFFFFFFF;
+
+    /* CRC-32 of the record with a zero checksum */
+    copy.checksum = 0;
+    for (size_t i = 0; i < sizeof(TimerRecord); i++) {
+        crc ^= bytes[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+
+    return ~crc;
+}
+
+static void setTimerRecord(TimerRecord *timerRecord, const char *name, TimerRecordType type,
+                           long time, int finalStatus)
+{
+    memset(timerRecord, 0, sizeof(TimerRecord));
+    timerRecord->magic = TIMER_JOURNAL_MAGIC;
+    timerRecord->type = type;
+    timerRecord->time = time;
+    timerRecord->finalStatus = finalStatus;
+    strncpy(timerRecord->name, name, TIMER_JOURNAL_NAME_LEN - 1);
+    timerRecord->checksum = getRecordChecksum(timerRecord);
+}
+
+static void applyTimerRecord(Array *timerStates, TimerRecord *timerRecord)
+{
+    TimerState *timerState = getTimerStateByName(timerStates, timerRecord->name);
+
+    if (!timerState) {
+        timerState = timerStateNew(timerRecord->name);
+        arrayAdd(timerStates, timerState);
+    }
+    switch (timerRecord->type) {
+    case TIMER_NEXT_RECORD:
+        timerState->nextTime = timerRecord->time;
+        break;
+    case TIMER_LAST_RECORD:
+        timerState->lastTime = timerRecord->time;
+        timerState->lastStatus = timerRecord->finalStatus;
+        break;
+    case TIMER_RESET_RECORD:
+        timerState->nextTime = -1;
+        break;
+    default:
+        break;
+    }
+}
+
+/* Returns the number of the valid records.
+ * The replay stops at the first damaged record.
+*/
+static int replayTimerJournal(const char *buffer, size_t size, Array *timerStates,
+                              size_t *validSize)
+{
+    TimerRecord timerRecord;
+    size_t offset = 0;
+    int numRecords = 0;
+
+    while (offset + sizeof(TimerRecord) <= size) {
+        memcpy(&timerRecord, buffer + offset, sizeof(TimerRecord));
+        if (timerRecord.magic != TIMER_JOURNAL_MAGIC ||
+            timerRecord.checksum != getRecordChecksum(&timerRecord) ||
+            timerRecord.type > TIMER_RESET_RECORD)
+            break;
+        timerRecord.name[TIMER_JOURNAL_NAME_LEN - 1] = '\0';
+        applyTimerRecord(timerStates, &timerRecord);
+        offset += sizeof(TimerRecord);
+        numRecords++;
+    }
+    *validSize = offset;
+
+    return numRecords;
+}
+
+static int readTimerJournal(int fd, char **buffer, size_t *size)
+{
+    int rv = 0;
+    struct stat sb;
+    ssize_t len = 0;
+    size_t done = 0;
+
+    if (fstat(fd, &sb) == -1)
+        return errno;
+    *size = sb.st_size;
+    if (*size == 0)
+        return rv;
+    *buffer = calloc(*size, sizeof(char));
+    assert(*buffer);
+    while (done < *size) {
+        if ((len = read(fd, *buffer + done, *size - done)) == -1) {
+            if (errno == EINTR)
+                continue;
+            rv = errno;
+            break;
+        }
+        /* The journal could have been truncated meanwhile */
+        if (len == 0)
+            break;
+        done += len;
+    }
+    *size = done;
+
+    return rv;
+}
+
+/* The caller must own the journal mutex */
+static int appendTimerRecord(TimerRecord *timerRecord)
+{
+    int rv = 0;
+    ssize_t len = 0;
+
+    if ((len = pwrite(JOURNAL_FD, timerRecord, sizeof(TimerRecord), JOURNAL_SIZE)) !=
+        sizeof(TimerRecord)) {
+        rv = (len == -1 ? errno : EIO);
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "appendTimerRecord",
+                 rv, strerror(rv), "Unable to write into the timers journal %s", JOURNAL_PATH);
+        /* Remove a partial record */
+        if (ftruncate(JOURNAL_FD, JOURNAL_SIZE) == -1)
+            logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c",
+                     "appendTimerRecord", errno, strerror(errno),
+                     "Unable to truncate the timers journal %s", JOURNAL_PATH);
+        return rv;
+    }
+    JOURNAL_SIZE += sizeof(TimerRecord);
+    JOURNAL_RECORDS++;
+
+    return rv;
+}
+
+/* The rename is durable only when the directory is on disk */
+static void syncTimerJournalDir()
+{
+    int fd = -1;
+    const char *dirPath = !USER_INSTANCE ? UNITD_TIMER_DATA_PATH : UNITD_USER_TIMER_DATA_PATH;
+
+    if ((fd = open(dirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1 || fsync(fd) == -1)
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "syncTimerJournalDir",
+                 errno, strerror(errno), "Unable to sync the %s directory", dirPath);
+    if (fd != -1)
+        close(fd);
+}
+
+/* The caller must own the journal mutex */
+static int compactTimerJournal()
+{
+    int rv = 0, fd = -1, lenStates = 0, numRecords = 0;
+    char *tmpPath = NULL;
+    TimerRecord *timerRecords = NULL;
+    TimerState *timerState = NULL;
+    size_t size = 0;
+
+    lenStates = TIMER_STATES->size;
+    timerRecords = calloc(lenStates * 2 + 1, sizeof(TimerRecord));
+    assert(timerRecords);
+    for (int i = 0; i < lenStates; i++) {
+        timerState = arrayGet(TIMER_STATES, i);
+        if (timerState->nextTime != -1)
+            setTimerRecord(&timerRecords[numRecords++], timerState->name, TIMER_NEXT_RECORD,
+                           timerState->nextTime, -1);
+        if (timerState->lastTime != -1)
+            setTimerRecord(&timerRecords[numRecords++], timerState->name, TIMER_LAST_RECORD,
+                           timerState->lastTime, timerState->lastStatus);
+    }
+    size = numRecords * sizeof(TimerRecord);
+    tmpPath = stringNew(JOURNAL_PATH);
+    stringAppendStr(&tmpPath, ".tmp");
+    if ((fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "compactTimerJournal",
+                 rv, strerror(rv), "Unable to create %s", tmpPath);
+        goto out;
+    }
+    if (size > 0 && pwrite(fd, timerRecords, size, 0) != (ssize_t)size) {
+        rv = errno ? errno : EIO;
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "compactTimerJournal",
+                 rv, strerror(rv), "Unable to write into %s", tmpPath);
+        goto out;
+    }
+    /* The new journal must be on disk before it replaces the old one */
+    if (fdatasync(fd) == -1 || rename(tmpPath, JOURNAL_PATH) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "compactTimerJournal",
+                 rv, strerror(rv), "Unable to replace the timers journal %s", JOURNAL_PATH);
+        goto out;
+    }
+    /* The journal has been replaced thus a sync error doesn't stop the swap */
+    syncTimerJournalDir();
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG,
+               "CompactTimerJournal::%d records have been compacted into %d records",
+               JOURNAL_RECORDS, numRecords);
+    close(JOURNAL_FD);
+    JOURNAL_FD = fd;
+    fd = -1;
+    JOURNAL_SIZE = size;
+    JOURNAL_RECORDS = numRecords;
+
+out:
+    if (fd != -1) {
+        close(fd);
+        unlink(tmpPath);
+    }
+    objectRelease(&tmpPath);
+    objectRelease(&timerRecords);
+    return rv;
+}
+
+/* The caller must own the journal mutex */
+static void checkCompactTimerJournal()
+{
+    if (JOURNAL_RECORDS >= TIMER_JOURNAL_COMPACT_MIN + TIMER_STATES->size * 4)
+        compactTimerJournal();
+}
+
+/* Import the times which the previous versions saved as file names
+ * ('name|next|time' and 'name|last|time|finalStatus').
+ * The caller must own the journal mutex.
+*/
+static void importTimerFiles()
+{
+    glob_t results;
+    char *pattern = NULL;
+    const char *filePath = NULL, *fileName = NULL, *timeStr = NULL, *finalStatusStr = NULL;
+    Array *entries = NULL;
+    TimerRecord timerRecord;
+    TimerRecordType type;
+    int lenEntries = 0;
+
+    if (!USER_INSTANCE)
+        pattern = stringNew(UNITD_TIMER_DATA_PATH);
+    else
+        pattern = stringNew(UNITD_USER_TIMER_DATA_PATH);
+    stringAppendStr(&pattern, "/*|*");
+    if (glob(pattern, 0, NULL, &results) == 0) {
+        for (size_t i = 0; i < results.gl_pathc; i++) {
+            filePath = results.gl_pathv[i];
+            fileName = strrchr(filePath, '/');
+            fileName = (fileName ? fileName + 1 : filePath);
+            entries = stringSplit((char *)fileName, "|", false);
+            lenEntries = (entries ? entries->size : 0);
+            if (lenEntries == 3 && stringEquals(arrayGet(entries, 1), "next"))
+                type = TIMER_NEXT_RECORD;
+            else if (lenEntries == 4 && stringEquals(arrayGet(entries, 1), "last"))
+                type = TIMER_LAST_RECORD;
+            else
+                goto next;
+            timeStr = arrayGet(entries, 2);
+            finalStatusStr = (type == TIMER_LAST_RECORD ? arrayGet(entries, 3) : NULL);
+            if (!isValidNumber(timeStr, false) ||
+                (finalStatusStr && !isValidNumber(finalStatusStr, true)))
+                goto next;
+            setTimerRecord(&timerRecord, arrayGet(entries, 0), type, atol(timeStr),
+                           finalStatusStr ? atoi(finalStatusStr) : -1);
+            if (appendTimerRecord(&timerRecord) == 0) {
+                applyTimerRecord(TIMER_STATES, &timerRecord);
+                unlink(filePath);
+            }
+next:
+            arrayRelease(&entries);
+        }
+    }
+
+    globfree(&results);
+    objectRelease(&pattern);
+}
+
+int openTimerJournal()
+{
+    int rv = 0, fd = -1, numRecords = 0;
+    char *buffer = NULL;
+    size_t size = 0, validSize = 0;
+
+    assert(!TIMER_STATES);
+
+    handleMutex(&JOURNAL_MUTEX, true);
+    TIMER_STATES = arrayNew(timerStateRelease);
+    JOURNAL_PATH = getTimerJournalPath();
+    if ((fd = open(JOURNAL_PATH, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "openTimerJournal",
+                 rv, strerror(rv), "Unable to open the timers journal %s", JOURNAL_PATH);
+        goto out;
+    }
+    if ((rv = readTimerJournal(fd, &buffer, &size)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c", "openTimerJournal",
+                 rv, strerror(rv), "Unable to read the timers journal %s", JOURNAL_PATH);
+        close(fd);
+        goto out;
+    }
+    numRecords = replayTimerJournal(buffer, size, TIMER_STATES, &validSize);
+    if (validSize < size) {
+        logWarning(SYSTEM, "The timers journal %s contains %lu damaged bytes. Truncating ...",
+                   JOURNAL_PATH, size - validSize);
+        if (ftruncate(fd, validSize) == -1)
+            logError(CONSOLE | SYSTEM, "src/core/units/utimers/timer_journal.c",
+                     "openTimerJournal", errno, strerror(errno),
+                     "Unable to truncate the timers journal %s", JOURNAL_PATH);
+    }
+    JOURNAL_FD = fd;
+    JOURNAL_SIZE = validSize;
+    JOURNAL_RECORDS = numRecords;
+    if (size == 0)
+        importTimerFiles();
+    checkCompactTimerJournal();
+    if (DEBUG)
+        syslog(LOG_DAEMON | LOG_DEBUG, "OpenTimerJournal::%d records loaded for %d timers",
+               JOURNAL_RECORDS, TIMER_STATES->size);
+
+out:
+    handleMutex(&JOURNAL_MUTEX, false);
+    objectRelease(&buffer);
+    return rv;
+}
+
+int saveTimerRecord(const char *name, TimerRecordType type, long time, int finalStatus)
+{
+    int rv = 0;
+    TimerRecord timerRecord;
+
+    assert(name);
+
+    handleMutex(&JOURNAL_MUTEX, true);
+    if (!TIMER_STATES)
+        goto out;
+    setTimerRecord(&timerRecord, name, type, time, finalStatus);
+    applyTimerRecord(TIMER_STATES, &timerRecord);
+    /* If the journal is not available then we only keep the state in memory.
+     * The error has already been logged.
+    */
+    if (JOURNAL_FD == -1)
+        goto out;
+    if ((rv = appendTimerRecord(&timerRecord)) == 0)
+        checkCompactTimerJournal();
+
+out:
+    handleMutex(&JOURNAL_MUTEX, false);
+    return rv;
+}
+
+long getTimerNextTime(const char *name)
+{
+    TimerState *timerState = NULL;
+    long nextTime = -1;
+
+    handleMutex(&JOURNAL_MUTEX, true);
+    if ((timerState = getTimerStateByName(TIMER_STATES, name)))
+        nextTime = timerState->nextTime;
+    handleMutex(&JOURNAL_MUTEX, false);
+
+    return nextTime;
+}
+
+void closeTimerJournal()
+{
+    handleMutex(&JOURNAL_MUTEX, true);
+    if (JOURNAL_FD != -1) {
+        close(JOURNAL_FD);
+        JOURNAL_FD = -1;
+    }
+    arrayRelease(&TIMER_STATES);
+    objectRelease(&JOURNAL_PATH);
+    JOURNAL_SIZE = 0;
+    JOURNAL_RECORDS = 0;
+    handleMutex(&JOURNAL_MUTEX, false);
+}
+
+int getTimerStates(Array **timerStates)
+{
+    int rv = 0, fd = -1;
+    char *journalPath = NULL, *buffer = NULL;
+    size_t size = 0, validSize = 0;
+
+    assert(timerStates);
+
+    if (!(*timerStates))
+        *timerStates = arrayNew(timerStateRelease);
+    journalPath = getTimerJournalPath();
+    if ((fd = open(journalPath, O_RDONLY | O_CLOEXEC)) == -1) {
+        /* No timer has been saved yet */
+        if (errno != ENOENT) {
+            rv = errno;
+            logError(SYSTEM, "src/core/units/utimers/timer_journal.c", "getTimerStates", rv,
+                     strerror(rv), "Unable to open the timers journal %s", journalPath);
+        }
+        goto out;
+    }
+    if ((rv = readTimerJournal(fd, &buffer, &size)) != 0) {
+        logError(SYSTEM, "src/core/units/utimers/timer_journal.c", "getTimerStates", rv,
+                 strerror(rv), "Unable to read the timers journal %s", journalPath);
+        goto out;
+    }
+    /* A record which is being written is ignored */
+    replayTimerJournal(buffer, size, *timerStates, &validSize);
+
+out:
+    if (fd != -1)
+        close(fd);
+    objectRelease(&buffer);
+    objectRelease(&journalPath);
+    return rv;
+}
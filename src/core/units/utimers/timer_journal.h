@@ -0,0 +1,43 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#define TIMER_JOURNAL_NAME "timers.journal"
+#define TIMER_JOURNAL_MAGIC 0x554e544a
+#define TIMER_JOURNAL_NAME_LEN 128
+#define TIMER_JOURNAL_COMPACT_MIN 64
+
+typedef enum {
+    TIMER_NEXT_RECORD = 0,
+    TIMER_LAST_RECORD = 1,
+    TIMER_RESET_RECORD = 2
+} TimerRecordType;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t type;
+    int64_t time;
+    int32_t finalStatus;
+    uint32_t checksum;
+    char name[TIMER_JOURNAL_NAME_LEN];
+} TimerRecord;
+
+typedef struct {
+    char *name;
+    long nextTime;
+    long lastTime;
+    int lastStatus;
+} TimerState;
+
+TimerState *timerStateNew(const char *);
+void timerStateRelease(TimerState **);
+TimerState *getTimerStateByName(Array *, const char *);
+int getTimerStates(Array **);
+int openTimerJournal();
+int saveTimerRecord(const char *, TimerRecordType, long, int);
+long getTimerNextTime(const char *);
+void closeTimerJournal();
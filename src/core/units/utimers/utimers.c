@@ -23,7 +23,9 @@ enum PropertyNameEnum {
     DAYS = 7,
     WEEKS = 8,
     MONTHS = 9,
-    WANTEDBY = 10
+    WANTEDBY = 10,
+    ONCALENDAR = 11,
+    ACCURACYSEC = 12
 };
 int UTIMERS_SECTIONS_ITEMS_LEN = 3;
 SectionData UTIMERS_SECTIONS_ITEMS[] = { { { UNIT, "[Unit]" }, false, true, 0 },
@@ -37,7 +39,7 @@ static const char *WANTEDBY_VALUES[] = { STATE_DATA_ITEMS[SINGLE_USER].desc,
                                          STATE_DATA_ITEMS[GRAPHICAL].desc,
                                          STATE_DATA_ITEMS[USER].desc,
                                          NULL };
-int UTIMERS_PROPERTIES_ITEMS_LEN = 11;
+int UTIMERS_PROPERTIES_ITEMS_LEN = 13;
 PropertyData UTIMERS_PROPERTIES_ITEMS[] = {
     { UNIT, { DESCRIPTION, "Description" }, false, true, false, 0, NULL, NULL },
     { UNIT, { REQUIRES, "Requires" }, true, false, false, 0, NULL, NULL },
@@ -49,7 +51,9 @@ PropertyData UTIMERS_PROPERTIES_ITEMS[] = {
     { INTERVAL, { DAYS, "Days" }, false, false, true, 0, NULL, NULL },
     { INTERVAL, { WEEKS, "Weeks" }, false, false, true, 0, NULL, NULL },
     { INTERVAL, { MONTHS, "Months" }, false, false, true, 0, NULL, NULL },
-    { STATE, { WANTEDBY, "WantedBy" }, true, true, false, 0, WANTEDBY_VALUES, NULL }
+    { STATE, { WANTEDBY, "WantedBy" }, true, true, false, 0, WANTEDBY_VALUES, NULL },
+    { INTERVAL, { ONCALENDAR, "OnCalendar" }, false, false, false, 0, NULL, NULL },
+    { UNIT, { ACCURACYSEC, "AccuracySec" }, false, false, true, 0, NULL, NULL }
 };
 //END PARSER CONFIGURATION
 
@@ -57,26 +61,31 @@ Timer *timerNew()
 {
     Timer *timer = calloc(1, sizeof(Timer));
     assert(timer);
-    //Timer id
-    timer_t *timerId = calloc(1, sizeof(timer_t));
-    assert(timerId);
-    timer->timerId = timerId;
-    //Event data
-    struct eventData *eventData = calloc(1, sizeof(struct eventData));
-    assert(eventData);
-    timer->eventData = eventData;
-    //Signal event
-    struct sigevent *sev = calloc(1, sizeof(struct sigevent));
-    assert(sev);
-    sev->sigev_value.sival_ptr = eventData;
-    sev->sigev_notify = SIGEV_THREAD;
-    sev->sigev_notify_function = &expired;
-    timer->sev = sev;
-    //Itimerspec
-    struct itimerspec *its = calloc(1, sizeof(struct itimerspec));
-    assert(its);
-    its->it_value.tv_sec = -1;
-    timer->its = its;
+    //Expiration time
+    struct timespec *expiry = calloc(1, sizeof(struct timespec));
+    assert(expiry);
+    timer->expiry = expiry;
+    //Earliest expiration time
+    long *earliest = calloc(1, sizeof(long));
+    assert(earliest);
+    timer->earliest = earliest;
+    //Catch-up time
+    long *catchUp = calloc(1, sizeof(long));
+    assert(catchUp);
+    *catchUp = -1;
+    timer->catchUp = catchUp;
+    //Heap index
+    int *heapIdx = calloc(1, sizeof(int));
+    assert(heapIdx);
+    *heapIdx = -1;
+    timer->heapIdx = heapIdx;
+    //Flags
+    bool *active = calloc(1, sizeof(bool));
+    assert(active);
+    timer->active = active;
+    bool *busy = calloc(1, sizeof(bool));
+    assert(busy);
+    timer->busy = busy;
 
     return timer;
 }
@@ -84,10 +93,12 @@ Timer *timerNew()
 void timerRelease(Timer **timer)
 {
     if (*timer) {
-        objectRelease(&(*timer)->timerId);
-        objectRelease(&(*timer)->eventData);
-        objectRelease(&(*timer)->sev);
-        objectRelease(&(*timer)->its);
+        objectRelease(&(*timer)->expiry);
+        objectRelease(&(*timer)->earliest);
+        objectRelease(&(*timer)->catchUp);
+        objectRelease(&(*timer)->heapIdx);
+        objectRelease(&(*timer)->active);
+        objectRelease(&(*timer)->busy);
         objectRelease(timer);
     }
 }
@@ -111,6 +122,33 @@ void setNextTimeDate(Unit **unit)
     objectRelease(&nextTimeDate);
 }
 
+/* Unlike setLeftTimeAndDuration(), it doesn't modify the unit thus it can be used for the
+ * shared status snapshots.
+*/
+char *getLeftTimeDuration(Unit *unit)
+{
+    Time *nextTime = NULL, *current = NULL;
+    long leftTime = 0;
+    char *leftTimeDuration = NULL;
+
+    assert(unit);
+
+    if (!unit->nextTime)
+        return stringNew(unit->leftTimeDuration);
+    nextTime = timeNew(unit->nextTime);
+    current = timeNew(NULL);
+    *current->durationSec = 0;
+    *current->durationMillisec = 0;
+    leftTime = *nextTime->sec - *current->sec;
+    *nextTime->durationSec = leftTime;
+    *nextTime->durationMillisec = 0;
+    leftTimeDuration = leftTime <= 0 ? stringNew("expired") : stringGetDiffTime(nextTime, current);
+
+    timeRelease(&nextTime);
+    timeRelease(&current);
+    return leftTimeDuration;
+}
+
 void setLeftTimeAndDuration(Unit **unit)
 {
     Time *nextTime = NULL, *current = timeNew(NULL);
@@ -142,44 +180,11 @@ void setLeftTimeAndDuration(Unit **unit)
 
 int saveTime(Unit *unit, const char *timerUnitName, Time *currentTime, int finalStatus)
 {
-    char *filePath = NULL, *pattern = NULL;
-    int rv = 0;
+    /* If the unit is defined then we save the next time otherwise the last time */
+    if (unit)
+        return saveTimerRecord(unit->name, TIMER_NEXT_RECORD, *unit->nextTime->sec, -1);
 
-    if (!USER_INSTANCE)
-        filePath = stringNew(UNITD_TIMER_DATA_PATH);
-    else
-        filePath = stringNew(UNITD_USER_TIMER_DATA_PATH);
-    stringAppendChr(&filePath, '/');
-    stringAppendStr(&filePath, unit ? unit->name : timerUnitName);
-    stringAppendStr(&filePath, unit ? "|next|" : "|last|");
-    pattern = stringNew(filePath);
-    stringAppendChr(&pattern, '*');
-    if (unit) {
-        char timeStr[50] = { 0 };
-        sprintf(timeStr, "%lu", *unit->nextTime->sec);
-        stringAppendStr(&filePath, timeStr);
-    } else {
-        /* Current time */
-        char currentTimeStr[50] = { 0 };
-        sprintf(currentTimeStr, "%lu", *currentTime->sec);
-        stringAppendStr(&filePath, currentTimeStr);
-        stringAppendChr(&filePath, '|');
-        /* Final status */
-        char finalStatusStr[3] = { 0 };
-        sprintf(finalStatusStr, "%d", finalStatus);
-        stringAppendStr(&filePath, finalStatusStr);
-    }
-    Array *envVars = NULL;
-    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-    addEnvVar(&envVars, "PATTERN", pattern);
-    addEnvVar(&envVars, "FILE_PATH", filePath);
-    arrayAdd(envVars, NULL);
-    rv = execUScript(&envVars, "save-time");
-
-    arrayRelease(&envVars);
-    objectRelease(&filePath);
-    objectRelease(&pattern);
-    return rv;
+    return saveTimerRecord(timerUnitName, TIMER_LAST_RECORD, *currentTime->sec, finalStatus);
 }
 
 int setNextTimeFromInterval(Unit **unit)
@@ -218,63 +223,43 @@ int setNextTimeFromInterval(Unit **unit)
     return rv;
 }
 
+int setNextTimeFromCalendar(Unit **unit)
+{
+    long nextTime = -1;
+
+    assert(*unit);
+    assert((*unit)->calendar);
+
+    if ((nextTime = getCalendarNextTime((*unit)->calendar, time(NULL))) == -1)
+        return 1;
+    *(*unit)->nextTime->sec = nextTime;
+    setNextTimeDate(unit);
+    setLeftTimeAndDuration(unit);
+
+    return 0;
+}
+
+int setNextTime(Unit **unit)
+{
+    assert(*unit);
+
+    return (*unit)->calendar ? setNextTimeFromCalendar(unit) : setNextTimeFromInterval(unit);
+}
+
 int setNextTimeFromDisk(Unit **unit)
 {
-    glob_t results;
-    char *pattern = NULL, *timeStr = NULL;
-    int rv = 0;
-    Time *nextTime = NULL;
-    const char *unitName = NULL;
+    long nextTime = -1;
 
     assert(*unit);
 
-    unitName = (*unit)->name;
-    nextTime = (*unit)->nextTime;
-    if (!USER_INSTANCE)
-        pattern = stringNew(UNITD_TIMER_DATA_PATH);
-    else
-        pattern = stringNew(UNITD_USER_TIMER_DATA_PATH);
-    stringAppendChr(&pattern, '/');
-    stringAppendStr(&pattern, unitName);
-    stringAppendStr(&pattern, "|next*");
-    if ((rv = glob(pattern, 0, NULL, &results)) == 0) {
-        size_t lenResults = results.gl_pathc;
-        if (lenResults > 0) {
-            /* There should be only one file with this pattern. */
-            if (lenResults > 1) {
-                rv = 1;
-                logError(
-                    CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "setNextTimeFromDisk", rv,
-                    strerror(rv),
-                    "Have been found '%d' files with '%s' pattern! Regenerate the next file.\n",
-                    lenResults, pattern);
-                goto out;
-            }
-            const char *fileName = results.gl_pathv[0];
-            assert(fileName);
-            /* Get the next time */
-            int index = stringLastIndexOfChr(fileName, '|');
-            timeStr = stringSub(fileName, index + 1, strlen(fileName) - 1);
-            if (!isValidNumber(timeStr, false)) {
-                rv = 1;
-                logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c",
-                         "setNextTimeFromDisk", rv, strerror(rv),
-                         "The time from '%s' file is not valid!\n", fileName);
-                goto out;
-            } else {
-                /* Set the next time */
-                *nextTime->sec = atol(timeStr);
-                setNextTimeDate(unit);
-                setLeftTimeAndDuration(unit);
-            }
-        }
-    }
+    /* Get the persistent next time from the timers journal */
+    if ((nextTime = getTimerNextTime((*unit)->name)) == -1)
+        return ENOENT;
+    *(*unit)->nextTime->sec = nextTime;
+    setNextTimeDate(unit);
+    setLeftTimeAndDuration(unit);
 
-out:
-    objectRelease(&pattern);
-    objectRelease(&timeStr);
-    globfree(&results);
-    return rv;
+    return 0;
 }
 
 int checkInterval(Unit **unit)
@@ -293,7 +278,20 @@ int checkInterval(Unit **unit)
     intDays = (*unit)->intDays;
     intWeeks = (*unit)->intWeeks;
     intMonths = (*unit)->intMonths;
-    if ((!intSeconds || *intSeconds == -1) && (!intMinutes || *intMinutes == -1) &&
+    if ((*unit)->calendar) {
+        /* The calendar expression is the interval string */
+        if (parseCalendar(intervalStr, (*unit)->calendar) != 0) {
+            rv = 1;
+            arrayAdd((*unit)->errors,
+                     getMsg(-1, UNITS_ERRORS_ITEMS[UTIMER_CALENDAR_ERR].desc, intervalStr));
+        } else if ((intSeconds && *intSeconds != -1) || (intMinutes && *intMinutes != -1) ||
+            (intHours && *intHours != -1) || (intDays && *intDays != -1) ||
+            (intWeeks && *intWeeks != -1) || (intMonths && *intMonths != -1)) {
+            rv = 1;
+            arrayAdd((*unit)->errors,
+                     getMsg(-1, UNITS_ERRORS_ITEMS[UTIMER_INTERVAL_CALENDAR_ERR].desc));
+        }
+    } else if ((!intSeconds || *intSeconds == -1) && (!intMinutes || *intMinutes == -1) &&
         (!intHours || *intHours == -1) && (!intDays || *intDays == -1) &&
         (!intWeeks || *intWeeks == -1) && (!intMonths || *intMonths == -1)) {
         rv = 1;
@@ -398,6 +396,10 @@ int parseTimerUnit(Array **units, Unit **unit, bool isAggregate)
     char *intervalStr = calloc(50, sizeof(char));
     assert(intervalStr);
     (*unit)->intervalStr = intervalStr;
+    // Wakeups saved by the accuracy
+    int *wakeupsSaved = calloc(1, sizeof(int));
+    assert(wakeupsSaved);
+    (*unit)->wakeupsSaved = wakeupsSaved;
     /* Some repeatable properties require the duplicate value check.
      * Just set their pointers in the PROPERTIES_ITEM array.
      * Optional.
@@ -455,6 +457,11 @@ int parseTimerUnit(Array **units, Unit **unit, bool isAggregate)
                             *(*unit)->wakeSystem = true;
                         }
                         break;
+                    case ACCURACYSEC:
+                        (*unit)->accuracySec = calloc(1, sizeof(int));
+                        assert((*unit)->accuracySec);
+                        *(*unit)->accuracySec = atoi(value);
+                        break;
                     case SECONDS:
                         (*unit)->intSeconds = calloc(1, sizeof(int));
                         assert((*unit)->intSeconds);
@@ -488,6 +495,12 @@ int parseTimerUnit(Array **units, Unit **unit, bool isAggregate)
                     case WANTEDBY:
                         arrayAdd(wantedBy, stringNew(value));
                         break;
+                    case ONCALENDAR:
+                        /* The expression will be compiled by checkInterval() */
+                        (*unit)->calendar = calendarNew();
+                        objectRelease(&(*unit)->intervalStr);
+                        (*unit)->intervalStr = stringNew(value);
+                        break;
                     }
                 }
             }
@@ -514,228 +527,163 @@ int parseTimerUnit(Array **units, Unit **unit, bool isAggregate)
     return rv;
 }
 
-void expired(union sigval timerData)
+void initTimerUnit(Unit *unit)
 {
-    int output = 1, rv = 0;
-    const char *timerUnitName = NULL;
-    Array *units = UNITD_DATA->units;
-    struct eventData *data = timerData.sival_ptr;
-
-    assert(data);
-
-    timerUnitName = data->timerUnitName;
-    Unit *timerUnit = getUnitByName(units, timerUnitName);
-    assert(timerUnit);
-    /* We communicate to the timer unit pipe to restart the timer. */
-    if (SHUTDOWN_COMMAND == NO_COMMAND)
-        if ((rv = uWrite(timerUnit->pipe->fds[1], &output, sizeof(int))) == -1) {
-            logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "expired", errno,
-                     strerror(errno), "Unable to write into pipe for the %s unit", timerUnitName);
+    const char *unitName = NULL;
+    int rv = 0;
+    long *leftTime = NULL;
+
+    assert(unit);
+
+    unitName = unit->name;
+    leftTime = unit->leftTime;
+    /* Try to get the persistent "nextTime" */
+    rv = setNextTimeFromDisk(&unit);
+    if (rv == 0 && *leftTime <= 0) {
+        /* The scheduler will execute it by catchUpTimerUnit() */
+        if (DEBUG)
+            logInfo(SYSTEM, "%s: the persistent 'nextTime' exists but it is expired.", unitName);
+        catchUpTimer(unit);
+        return;
+    }
+    if (rv != 0) {
+        if (DEBUG)
+            logInfo(SYSTEM, "%s: generating the 'nextTime' ...", unitName);
+        if (setNextTime(&unit) != 0) {
+            logWarning(SYSTEM, "%s: the calendar expression doesn't elapse anymore.", unitName);
+            return;
+        }
+        assert(unit->nextTime && *leftTime != -1);
+        if ((rv = saveTime(unit, NULL, NULL, -1)) != 0) {
             kill(UNITD_PID, SIGTERM);
+            return;
         }
+    }
+    armTimer(unit);
 }
 
-void armTimer(Unit *unit)
+void expireTimerUnit(Unit *unit)
 {
-    int rv = 0;
-    Timer *timer = NULL;
     const char *unitName = NULL;
-    bool wakeSystem = false;
+    int rv = 0;
+    long *leftTime = NULL;
 
     assert(unit);
 
     unitName = unit->name;
-    wakeSystem = unit->wakeSystem && *unit->wakeSystem ? true : false;
-    timer = unit->timer;
-    timer->eventData->timerUnitName = unitName;
-    timer->its->it_value.tv_sec = *unit->leftTime;
-    while (true) {
-        rv = timer_create(wakeSystem ? CLOCK_BOOTTIME_ALARM : CLOCK_BOOTTIME, timer->sev,
-                          timer->timerId);
-        if (rv == -1) {
-            if (errno == EAGAIN)
-                continue;
-            else {
-                logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "armTimer", errno,
-                         strerror(errno), "Unable to create the timer for '%s'", unitName);
-                kill(UNITD_PID, SIGTERM);
-                break;
-            }
-        }
-        break;
+    leftTime = unit->leftTime;
+    /* The left time is expired!
+     * Lock and unlock the unit mutex to simulate the same
+     * behaviour of listenPipeThread() func when the processes restart.
+     * A possible unit status request will show the restarted or completed data.
+    */
+    if ((rv = pthread_mutex_lock(unit->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "expireTimerUnit", rv,
+                 strerror(rv), "Unable to lock the mutex (restart timer) for '%s'", unitName);
+        kill(UNITD_PID, SIGTERM);
     }
-    rv = timer_settime(*timer->timerId, 0, timer->its, NULL);
-    if (rv == -1) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "armTimer", errno,
-                 strerror(errno), "Unable to start the timer for '%s'", unitName);
+    /* Reset data for restarting.
+     * Unlike the units, the restarting of the timers is considerated like a success.
+     * For this reason, we don't set a final status different by SUCCESS.
+     * In this way, the requires check is satisfied as well.
+    */
+    *unit->processData->pStateData = PSTATE_DATA_ITEMS[RESTARTING];
+    stringCopy(unit->nextTimeDate, "-");
+    stringCopy(unit->leftTimeDuration, "-");
+    publishUnitSnapshot(unit);
+    if ((rv = pthread_mutex_unlock(unit->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "expireTimerUnit", rv,
+                 strerror(rv), "Unable to unlock the mutex (restart timer) for '%s'", unitName);
         kill(UNITD_PID, SIGTERM);
     }
+    if (SHUTDOWN_COMMAND != NO_COMMAND || (rv = executeUnit(unit, TIMER)) == EUIDOWN)
+        logWarning(SYSTEM, "Shutting down the unitd instance. Skipped '%s' execution.", unitName);
+    else {
+        *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
+        if ((rv = pthread_mutex_lock(unit->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "expireTimerUnit", rv,
+                     strerror(rv), "Unable to lock the mutex (restart timer before start) for '%s'",
+                     unitName);
+            kill(UNITD_PID, SIGTERM);
+        }
+        if (setNextTime(&unit) != 0)
+            logWarning(SYSTEM, "%s: the calendar expression doesn't elapse anymore.", unitName);
+        else {
+            assert(unit->nextTime && *leftTime != -1);
+            if ((rv = saveTime(unit, NULL, NULL, -1)) != 0)
+                kill(UNITD_PID, SIGTERM);
+            armTimer(unit);
+        }
+        publishUnitSnapshot(unit);
+        if ((rv = pthread_mutex_unlock(unit->mutex)) != 0) {
+            logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "expireTimerUnit", rv,
+                     strerror(rv),
+                     "Unable to unlock the mutex (restart timer after start) for '%s'", unitName);
+            kill(UNITD_PID, SIGTERM);
+        }
+    }
 }
 
-void disarmTimer(Unit *unit)
+void catchUpTimerUnit(Unit *unit, long delay)
 {
-    Timer *timer = NULL;
-    int rv = 0;
-
     assert(unit);
 
-    timer = unit->timer;
-    if (*timer->timerId != 0 && (rv = timer_delete(*timer->timerId)) == -1) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "disarmTimer", errno,
-                 strerror(errno), "Unable to delete the timer for '%s'", unit->name);
-        kill(UNITD_PID, SIGTERM);
-    }
-    *timer->timerId = 0;
+    /* The overdue timer has waited for the random spread and for a free slot */
+    logInfo(SYSTEM, "%s: executing the overdue timer after a catch-up delay of %ld seconds.",
+            unit->name, delay);
+    expireTimerUnit(unit);
 }
 
-void *startTimerUnitThread(void *arg)
+void rearmTimerUnit(Unit *unit)
 {
-    Unit *unit = NULL;
     const char *unitName = NULL;
-    int rv = 0, input = 0;
-    Pipe *unitPipe = NULL;
-    long *leftTime = NULL;
+    int rv = 0;
+    long nextTime = -1;
+    bool expired = false;
 
-    assert(arg);
+    assert(unit);
 
-    unit = (Unit *)arg;
     unitName = unit->name;
-    unitPipe = unit->pipe;
-    leftTime = unit->leftTime;
-    if ((rv = pthread_mutex_lock(unitPipe->mutex)) != 0) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnitThread", rv,
-                 strerror(rv), "Unable to acquire the lock of the pipe mutex for '%s'", unitName);
+    if ((rv = pthread_mutex_lock(unit->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "rearmTimerUnit", rv,
+                 strerror(rv), "Unable to lock the mutex for '%s'", unitName);
         kill(UNITD_PID, SIGTERM);
     }
-    while (!LISTEN_SOCK_REQUEST && SHUTDOWN_COMMAND == NO_COMMAND)
-        msleep(50);
-    if (SHUTDOWN_COMMAND != NO_COMMAND)
-        goto out;
-    /* Try to get the persistent "nextTime" */
-    rv = setNextTimeFromDisk(&unit);
-    if (rv != 0 || *leftTime <= 0) {
-        if (rv == 0) {
-            if (DEBUG)
-                logInfo(SYSTEM, "%s: the persistent 'nextTime' exists but it is expired.",
-                        unitName);
-            if (SHUTDOWN_COMMAND != NO_COMMAND || (rv = executeUnit(unit, TIMER)) == EUIDOWN) {
-                logWarning(SYSTEM, "Shutting down the unitd instance. Skipped '%s' execution.",
-                           unitName);
-                goto out;
-            }
-        }
-        if (DEBUG)
-            logInfo(SYSTEM, "%s: generating the 'nextTime' by interval ...", unitName);
-        setNextTimeFromInterval(&unit);
-        assert(unit->nextTime && *leftTime != -1);
-        if ((rv = saveTime(unit, NULL, NULL, -1)) != 0) {
-            kill(UNITD_PID, SIGTERM);
-            goto out;
-        }
-    }
-    armTimer(unit);
-    while (true) {
-        if ((rv = uRead(unitPipe->fds[0], &input, sizeof(int))) == -1) {
-            logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnitThread",
-                     errno, strerror(errno), "Unable to read from pipe for '%s'", unitName);
-            kill(UNITD_PID, SIGTERM);
-            goto out;
-        }
-        if (input == 1) {
-            /* The left time is expired!
-             * Lock and unlock the unit mutex to simulate the same
-             * behaviour of listenPipeThread() func when the processes restart.
-             * A possible unit status request will show the restarted or completed data.
-            */
-            disarmTimer(unit);
-            if ((rv = pthread_mutex_lock(unit->mutex)) != 0) {
-                logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c",
-                         "startTimerUnitThread", rv, strerror(rv),
-                         "Unable to lock the mutex (restart timer)", unitName);
-                kill(UNITD_PID, SIGTERM);
-            }
-            /* Reset data for restarting.
-             * Unlike the units, the restarting of the timers is considerated like a success.
-             * For this reason, we don't set a final status different by SUCCESS.
-             * In this way, the requires check is satisfied as well.
-            */
-            *unit->processData->pStateData = PSTATE_DATA_ITEMS[RESTARTING];
-            stringCopy(unit->nextTimeDate, "-");
-            stringCopy(unit->leftTimeDuration, "-");
-            if ((rv = pthread_mutex_unlock(unit->mutex)) != 0) {
-                logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c",
-                         "startTimerUnitThread", rv, strerror(rv),
-                         "Unable to unlock the mutex (restart timer)", unitName);
+    /* A next time which is passed is executed at once. Otherwise, the realtime clock or the
+     * timezone has changed thus the next time is computed again from the calendar.
+    */
+    setLeftTimeAndDuration(&unit);
+    if (!(expired = *unit->leftTime <= 0)) {
+        nextTime = *unit->nextTime->sec;
+        if (setNextTimeFromCalendar(&unit) != 0)
+            logWarning(SYSTEM, "%s: the calendar expression doesn't elapse anymore.", unitName);
+        else {
+            if (*unit->nextTime->sec != nextTime && (rv = saveTime(unit, NULL, NULL, -1)) != 0)
                 kill(UNITD_PID, SIGTERM);
-            }
-            if (SHUTDOWN_COMMAND != NO_COMMAND || (rv = executeUnit(unit, TIMER)) == EUIDOWN)
-                logWarning(SYSTEM, "Shutting down the unitd instance. Skipped '%s' execution.",
-                           unitName);
-            else {
-                *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
-                if ((rv = pthread_mutex_lock(unit->mutex)) != 0) {
-                    logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c",
-                             "startTimerUnitThread", rv, strerror(rv),
-                             "Unable to lock the mutex (restart timer before start)", unitName);
-                    kill(UNITD_PID, SIGTERM);
-                }
-                setNextTimeFromInterval(&unit);
-                assert(unit->nextTime && *leftTime != -1);
-                if ((rv = saveTime(unit, NULL, NULL, -1)) != 0)
-                    kill(UNITD_PID, SIGTERM);
-                armTimer(unit);
-                if ((rv = pthread_mutex_unlock(unit->mutex)) != 0) {
-                    logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c",
-                             "startTimerUnitThread", rv, strerror(rv),
-                             "Unable to unlock the mutex (restart timer after start)", unitName);
-                    kill(UNITD_PID, SIGTERM);
-                }
-            }
-        } else if (input == THREAD_EXIT)
-            goto out;
+            armTimer(unit);
+        }
     }
-
-out:
-    disarmTimer(unit);
-    if ((rv = pthread_mutex_unlock(unitPipe->mutex)) != 0) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnitThread", rv,
-                 strerror(rv), "Unable to unlock the pipe mutex for the %s unit", unitName);
+    publishUnitSnapshot(unit);
+    if ((rv = pthread_mutex_unlock(unit->mutex)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "rearmTimerUnit", rv,
+                 strerror(rv), "Unable to unlock the mutex for '%s'", unitName);
         kill(UNITD_PID, SIGTERM);
     }
-    pthread_exit(0);
+    if (expired)
+        expireTimerUnit(unit);
 }
 
 int startTimerUnit(Unit *unit)
 {
-    pthread_t thread;
-    pthread_attr_t attr;
-    const char *unitName = NULL;
     int rv = 0;
 
     assert(unit);
 
-    unitName = unit->name;
-    if ((rv = pthread_attr_init(&attr)) != 0) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnit", errno,
-                 strerror(errno), "pthread_attr_init returned bad exit code %d", rv);
-        kill(UNITD_PID, SIGTERM);
-    }
-    if ((rv = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED)) != 0) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnit", errno,
-                 strerror(errno), "pthread_attr_setdetachstate returned bad exit code %d", rv);
-        kill(UNITD_PID, SIGTERM);
-    }
+    /* The scheduler will compute the next time and arm the timer */
     *unit->processData->pStateData = PSTATE_DATA_ITEMS[RUNNING];
-    if ((rv = pthread_create(&thread, &attr, startTimerUnitThread, unit)) != 0) {
-        logError(CONSOLE | SYSTEM, "src/core/units/utimers/utimers.c", "startTimerUnit", rv,
-                 strerror(rv), "Unable to create the unit timer thread for '%s'", unitName);
-        kill(UNITD_PID, SIGTERM);
-    } else {
-        if (DEBUG)
-            logInfo(SYSTEM, "unit timer thread created successfully for '%s'\n", unitName);
-    }
+    if ((rv = addTimer(unit)) == 0 && DEBUG)
+        logInfo(SYSTEM, "'%s' timer added to the scheduler\n", unit->name);
 
-    pthread_attr_destroy(&attr);
     return rv;
 }
 
@@ -832,23 +780,5 @@ out:
 
 int resetNextTime(const char *timerName)
 {
-    int rv = 0;
-    char *pattern = NULL;
-    Array *envVars = NULL;
-
-    if (!USER_INSTANCE)
-        pattern = stringNew(UNITD_TIMER_DATA_PATH);
-    else
-        pattern = stringNew(UNITD_USER_TIMER_DATA_PATH);
-    stringAppendChr(&pattern, '/');
-    stringAppendStr(&pattern, timerName);
-    stringAppendStr(&pattern, "|next|*");
-    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-    addEnvVar(&envVars, "PATTERN", pattern);
-    arrayAdd(envVars, NULL);
-    rv = execUScript(&envVars, "remove");
-
-    arrayRelease(&envVars);
-    objectRelease(&pattern);
-    return rv;
+    return saveTimerRecord(timerName, TIMER_RESET_RECORD, -1, -1);
 }
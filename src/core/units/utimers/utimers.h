@@ -13,23 +13,22 @@ extern SectionData UTIMERS_SECTIONS_ITEMS[];
 extern int UTIMERS_PROPERTIES_ITEMS_LEN;
 extern PropertyData UTIMERS_PROPERTIES_ITEMS[];
 
-struct eventData {
-    const char *timerUnitName;
-};
-
 int parseTimerUnit(Array **, Unit **, bool);
 int checkInterval(Unit **unit);
 int startTimerUnit(Unit *);
-void *startTimerUnitThread(void *);
+void initTimerUnit(Unit *);
+void expireTimerUnit(Unit *);
+void catchUpTimerUnit(Unit *, long);
+void rearmTimerUnit(Unit *);
 int setNextTimeFromDisk(Unit **);
 int setNextTimeFromInterval(Unit **);
+int setNextTimeFromCalendar(Unit **);
+int setNextTime(Unit **);
 int saveTime(Unit *, const char *, Time *, int);
 int executeUnit(Unit *, PType);
+char *getLeftTimeDuration(Unit *);
 void setLeftTimeAndDuration(Unit **);
 void setNextTimeDate(Unit **);
 int resetNextTime(const char *);
-void expired(union sigval timerData);
 Timer *timerNew();
 void timerRelease(Timer **);
-void armTimer(Unit *);
-void disarmTimer(Unit *unit);
@@ -9,11 +9,6 @@ export PATH=$PATH
 OPERATION="$1"
 
 case $OPERATION in
-"virtualization")
-	# Detect LXC (and other) containers
-	[ -z "${container+x}" ] || exit 1
-	[ ! -e /.dockerenv ] || exit 1
-	;;
 "cat-unit")
 	cat $UNIT_PATH
 	;;
@@ -30,15 +25,4 @@ case $OPERATION in
 "send-wallmsg")
 	wall $MSG
 	;;
-"save-time")
-	rm -rf $PATTERN || true
-	touch $FILE_PATH
-	;;
-"remove")
-	rm -rf $PATTERN || true
-	;;
-"default-syml")
-	rm -rf $TO || true
-	ln -s $FROM $TO
-	;;
 esac
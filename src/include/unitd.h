@@ -128,6 +128,32 @@ int disableUnit(SockMessageOut **sockMessageOut, const char *unitName, bool run)
 int enableUnit(SockMessageOut **sockMessageOut, const char *unitName, bool force, bool run,
                bool reEnable, bool reset);
 
+/**
+ * Start/Restart, stop or enable/re-enable more units with a single request.<br>
+ * The available commands are:
+ * <ul>
+ *  <li>START_COMMAND</li>
+ *  <li>RESTART_COMMAND</li>
+ *  <li>STOP_COMMAND</li>
+ *  <li>ENABLE_COMMAND</li>
+ *  <li>RE_ENABLE_COMMAND</li>
+ * </ul>
+ * The units are started/stopped in parallel respecting the "requires" ordering.<br>
+ * The units are enabled in the given order thus the dependencies have to precede the units which require them.<br>
+ * The function will populate a sockMessageOut->unitsDisplay array which contains a result for each unit
+ * in the same order of unitNames.<br>
+ * SockMessageOut struct must be freed via the sockMessageOutRelease() function.
+ * @param sockMessageOut
+ * @param command
+ * @param unitNames
+ * @param force
+ * @param run
+ * @param reset
+ * @return integer
+ */
+int batchUnits(SockMessageOut **sockMessageOut, Command command, Array *unitNames, bool force,
+               bool run, bool reset);
+
 /**
  * Get the dependencies, conflicts or unit wanted states according the boolean parameters values.<br>
  * SockMessageOut struct must be freed via the sockMessageOutRelease() function.
@@ -158,4 +184,16 @@ int getDefaultState(SockMessageOut **sockMessageOut);
  */
 int setDefaultState(SockMessageOut **sockMessageOut, const char *state);
 
+/**
+ * Get the status of the units reading the status board.<br>
+ * The status board is a read only shared memory published by Unitd thus
+ * this function doesn't connect to the socket.<br>
+ * The function will populate the unitsBoard array with an UnitBoardEntry for each unit
+ * which has been started.<br>
+ * The array must be freed via the arrayRelease() function.
+ * @param unitsBoard
+ * @return integer
+ */
+int getUnitsBoard(Array **unitsBoard);
+
 #endif // UNITD_H
@@ -21,12 +21,20 @@
 #include <limits.h>
 #include <fcntl.h>
 #include <sys/select.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/reboot.h>
 #include <utmp.h>
 #include <sys/utsname.h>
 #include <pwd.h>
+#include <grp.h>
 #include <fnmatch.h>
 
 /**
@@ -181,39 +189,106 @@ typedef struct {
 /**
  * @struct Timer
  * @brief This structure contains the data to handle a timer.
- * @var Timer::timerId
- * Represents the timer id.
- * @var Timer::eventData
- * Represents the event data.
- * @var Timer::sev
- * Represents the signal event structure.
- * @var Timer::its
- * Represents the itimerspec structure.
+ * @var Timer::expiry
+ * Represents the absolute expiration time (CLOCK_BOOTTIME).
+ * It can be delayed up to the accuracy of the timer to be coalesced with the other timers.
+ * @var Timer::earliest
+ * Represents the earliest expiration time in seconds (CLOCK_BOOTTIME).
+ * @var Timer::catchUp
+ * Represents when an overdue timer has been queued for the catch-up (CLOCK_BOOTTIME seconds).
+ * It's -1 if the timer is not overdue.
+ * @var Timer::heapIdx
+ * Represents the position into the scheduler heap (-1 if the timer is not armed).
+ * @var Timer::active
+ * Represents if the timer is started.
+ * @var Timer::busy
+ * Represents if a scheduler worker is handling the timer.
  *
 */
 typedef struct {
-    timer_t *timerId;
-    struct eventData *eventData;
-    struct sigevent *sev;
-    struct itimerspec *its;
+    struct timespec *expiry;
+    long *earliest;
+    long *catchUp;
+    int *heapIdx;
+    bool *active;
+    bool *busy;
 } Timer;
 
+/**
+ * @struct Calendar
+ * @brief This structure contains a compiled calendar expression (OnCalendar).
+ * Each field is a bitmask of the allowed values.
+ * @var Calendar::seconds
+ * Represents the seconds (0-59).
+ * @var Calendar::minutes
+ * Represents the minutes (0-59).
+ * @var Calendar::hours
+ * Represents the hours (0-23).
+ * @var Calendar::days
+ * Represents the days of the month (1-31).
+ * @var Calendar::months
+ * Represents the months (0-11).
+ * @var Calendar::years
+ * Represents the years starting from 1970.
+ * @var Calendar::weekDays
+ * Represents the week days (Sunday = 0).
+ * @var Calendar::dayMasks
+ * Represents the days which match the week days for each week day of the first day of the month.
+ *
+*/
+typedef struct {
+    uint64_t seconds;
+    uint64_t minutes;
+    uint64_t hours;
+    uint64_t days;
+    uint64_t months;
+    uint64_t years[2];
+    uint64_t weekDays;
+    uint64_t dayMasks[7];
+} Calendar;
+
 /**
  * @struct Notifier
  * @brief This structure represents the Notifier.
+ * All the path units share the inotify instance of the unitd notifier.
  * @var Notifier::pipe
- * Represents the notifier's pipe.
+ * Represents the notifier's pipe (unitd notifier only).
  * @var Notifier::fd
- * Represents the file descriptor to monitor.
+ * Represents the inotify file descriptor (unitd notifier only).
  * @var Notifier::watchers
  * This structure contains all watchers.
+ * @var Notifier::busy
+ * Represents if the unit of a path unit is executing (path unit only).
+ * @var Notifier::pending
+ * Represents if the unit has been triggered again meanwhile (path unit only).
+ * @var Notifier::lastEvent
+ * Represents the monotonic time in milliseconds of the last trigger (path unit only).
+ * @var Notifier::limitStart
+ * Represents the monotonic time in milliseconds of the trigger limit interval start.
+ * @var Notifier::triggers
+ * Represents how many times the unit has been executed in the trigger limit interval.
  */
 typedef struct {
     Pipe *pipe;
     int *fd;
     Array *watchers;
+    bool *busy;
+    bool *pending;
+    long *lastEvent;
+    long *limitStart;
+    int *triggers;
 } Notifier;
 
+/**
+ * This is the opaque type of the status snapshot of an unit.<br>
+ */
+typedef struct UnitSnapshot UnitSnapshot;
+
+/**
+ * This is the opaque type of the arena which backs the allocations of a socket request.<br>
+ */
+typedef struct Arena Arena;
+
 /**
  * @struct Unit
  * @brief This structure represents the unit.
@@ -279,6 +354,8 @@ typedef struct {
  * Represents the timer of the unit.
  * @var Unit::wakeSystem
  * Set the wake mode for a timer.
+ * @var Unit::accuracySec
+ * Set the seconds which the timer expiration can be delayed to be coalesced (AccuracySec).
  * @var Unit::intSeconds
  * Set the elapsed time in seconds.
  * @var Unit::intMinutes
@@ -293,6 +370,8 @@ typedef struct {
  * Set the elapsed time in months.
  * @var Unit::intervalStr
  * Set the interval as string.
+ * @var Unit::calendar
+ * Represents the compiled calendar expression (OnCalendar).
  * @var Unit::leftTime
  * Represents the left time.
  * @var Unit::leftTimeDuration
@@ -301,6 +380,8 @@ typedef struct {
  * Represents the the next time.
  * @var Unit::nextTimeDate
  * Represents the next time as string.
+ * @var Unit::wakeupsSaved
+ * Represents how many times the timer expired together with other timers.
  * @var Unit::notifier
  * Represents the notifier struct.
  * @var Unit::pathExists
@@ -319,6 +400,16 @@ typedef struct {
  * Contains the folder path must be checked.
  * @var Unit::pathDirectoryNotEmptyMonitor
  * Contains the real folder defined in "pathDirectoryNotEmpty".
+ * @var Unit::triggerQuietSec
+ * Set the seconds without events which must elapse before executing the unit (TriggerQuietSec).
+ * @var Unit::triggerLimitIntervalSec
+ * Set the interval in seconds of the trigger limit (TriggerLimitIntervalSec).
+ * @var Unit::triggerLimitBurst
+ * Set how many times the unit can be executed in the interval (TriggerLimitBurst).
+ * @var Unit::snapshot
+ * Represents the last published status snapshot of the unit.
+ * @var Unit::isSnapshotStale
+ * Boolean value which allows the cleaner thread to publish the snapshot again.
  */
 typedef struct {
     char *desc;
@@ -353,6 +444,7 @@ typedef struct {
     // Timer
     Timer *timer;
     bool *wakeSystem;
+    int *accuracySec;
     int *intSeconds;
     int *intMinutes;
     int *intHours;
@@ -360,10 +452,12 @@ typedef struct {
     int *intWeeks;
     int *intMonths;
     char *intervalStr;
+    Calendar *calendar;
     long *leftTime;
     char *leftTimeDuration;
     Time *nextTime;
     char *nextTimeDate;
+    int *wakeupsSaved;
     // Path Unit
     Notifier *notifier;
     char *pathExists;
@@ -374,6 +468,12 @@ typedef struct {
     char *pathResourceChangedMonitor;
     char *pathDirectoryNotEmpty;
     char *pathDirectoryNotEmptyMonitor;
+    int *triggerQuietSec;
+    int *triggerLimitIntervalSec;
+    int *triggerLimitBurst;
+    // Status snapshot
+    UnitSnapshot *snapshot;
+    bool isSnapshotStale;
 } Unit;
 
 /**
@@ -488,9 +588,66 @@ typedef enum {
     LIST_TIMERS_COMMAND = 28,
     /** Show the path units.
     */
-    LIST_UPATH_COMMAND = 29
+    LIST_UPATH_COMMAND = 29,
+    /** Send the commands read from the standard input over a single connection.
+    */
+    SESSION_COMMAND = 30,
+    /** Show the units status reading the status board.
+    */
+    BOARD_COMMAND = 31
 } Command;
 
+/**
+ * The maximum length of the unit name in the status board.<br>
+ */
+#define UNIT_BOARD_NAME_LEN 128
+
+/**
+ * @struct UnitBoardEntry
+ * @brief This structure represents the status of an unit in the status board (shared memory).
+ * @var UnitBoardEntry::seq
+ * The sequence number of the seqlock (odd while unitd is writing the entry).
+ * @var UnitBoardEntry::type
+ * Represents the process type of the unit.
+ * @var UnitBoardEntry::pState
+ * Represents the process state.
+ * @var UnitBoardEntry::finalStatus
+ * Represents the final status.
+ * @var UnitBoardEntry::pid
+ * Represents the pid.
+ * @var UnitBoardEntry::exitCode
+ * Represents the exit code.
+ * @var UnitBoardEntry::signalNum
+ * Represents the signal number.
+ * @var UnitBoardEntry::restartNum
+ * Represents the restart number of the unit.
+ * @var UnitBoardEntry::enabled
+ * Boolean value (0 or 1) which is true if the unit is enabled.
+ * @var UnitBoardEntry::timeStart
+ * The last start time (seconds since the epoch).
+ * @var UnitBoardEntry::timeStop
+ * The last stop time (seconds since the epoch).
+ * @var UnitBoardEntry::timeChanged
+ * The time of the last change of the entry (seconds since the epoch).
+ * @var UnitBoardEntry::name
+ * Represents the unit name.
+ */
+typedef struct {
+    uint32_t seq;
+    int32_t type;
+    int32_t pState;
+    int32_t finalStatus;
+    int32_t pid;
+    int32_t exitCode;
+    int32_t signalNum;
+    int32_t restartNum;
+    int32_t enabled;
+    int64_t timeStart;
+    int64_t timeStop;
+    int64_t timeChanged;
+    char name[UNIT_BOARD_NAME_LEN];
+} UnitBoardEntry;
+
 /**
  *  @struct SockMessageOut
  *  @brief This structure the response message from unix socket.
@@ -500,11 +657,17 @@ typedef enum {
  *  This structure contains the received errors.
  *  @var SockMessageOut::messages
  *  This structure contains the messages errors.
+ *  @var SockMessageOut::id
+ *  The request id which the response refers to (session only).
+ *  @var SockMessageOut::arena
+ *  The arena of the request which backs the transient allocations (unitd only).
  */
 typedef struct {
     Array *unitsDisplay;
     Array *errors;
     Array *messages;
+    char *id;
+    Arena *arena;
 } SockMessageOut;
 
 /**
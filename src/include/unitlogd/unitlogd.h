@@ -23,11 +23,11 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
  * @var IndexEntry::start
  * Contains the start timestamp.
  * @var IndexEntry::startOffset
- * Contains the start offset.
+ * Contains the start offset into the boot log (segment or legacy log).
  * @var IndexEntry::stop
  * Contains the stop timestamp.
  * @var IndexEntry::stopOffset
- * Contains the stop offset.
+ * Contains the stop offset into the boot log (segment or legacy log).
  *
 */
 typedef struct {
@@ -49,7 +49,7 @@ typedef struct {
 int getBootsList(Array **bootsList);
 
 /**
- * Repair the index reading the entries from log.<br>
+ * Repair the index reading the entries from the legacy log and the segments.<br>
  * This function is useful in the corruption case of the index file.<br>
  * Return value:<br>
  * On success returns '0' otherwise an error has occurred.
@@ -59,8 +59,9 @@ int getBootsList(Array **bootsList);
 int indexRepair();
 
 /**
- * Reduces log disk space by removing the lines between<br>
+ * Reduces the legacy log disk space by removing the lines between<br>
  * the values of the 'startOffset' and 'stopOffset' arguments.<br>
+ * The boots logged into the segments are removed by unlinking their segment.<br>
  * Return value:<br>
  * On success returns '0' otherwise an error has occurred.
  * @param[in] startOffset
@@ -14,6 +14,7 @@ UlCommandData UL_COMMAND_DATA[] = {
     { SHOW_CURRENT, "show-current" }
 };
 int UL_COMMAND_DATA_LEN = 7;
+LogFilter LOG_FILTER = { .minPriority = LOG_EMERG, .maxPriority = LOG_DEBUG };
 
 UlCommand getUlCommand(const char *commandName)
 {
@@ -40,6 +41,207 @@ bool getSkipCheckAdmin(UlCommand ulCommand)
     }
 }
 
+/* The time can be 'now', relative to now (-30s, -10m, -2h, -1d) or a date and/or a time
+ * (dd-mm-yyyy [HH:MM[:SS]] or HH:MM[:SS] of today).
+*/
+int parseLogTime(const char *timeStr, time_t *logTime)
+{
+    static const char *TIME_FORMATS[] = { "%d-%m-%Y %H:%M:%S", "%d-%m-%Y %H:%M", "%d-%m-%Y",
+                                          "%H:%M:%S", "%H:%M", NULL };
+    time_t now = time(NULL);
+    struct tm tmTime = { 0 };
+    char *end = NULL;
+    long value = 0;
+
+    assert(timeStr);
+
+    if (stringEquals(timeStr, "now")) {
+        *logTime = now;
+        return 0;
+    }
+    if (timeStr[0] == '-' && isdigit(timeStr[1])) {
+        value = strtol(timeStr + 1, &end, 10);
+        switch (*end) {
+        case '\0':
+        case 's':
+            break;
+        case 'm':
+            value *= 60;
+            break;
+        case 'h':
+            value *= 3600;
+            break;
+        case 'd':
+            value *= 86400;
+            break;
+        default:
+            return 1;
+        }
+        if (*end != '\0' && *(end + 1) != '\0')
+            return 1;
+        *logTime = now - value;
+        return 0;
+    }
+    for (int i = 0; TIME_FORMATS[i]; i++) {
+        /* The time only formats refer to today */
+        localtime_r(&now, &tmTime);
+        tmTime.tm_hour = tmTime.tm_min = tmTime.tm_sec = 0;
+        if ((end = strptime(timeStr, TIME_FORMATS[i], &tmTime)) && *end == '\0') {
+            tmTime.tm_isdst = -1;
+            *logTime = mktime(&tmTime);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int setPriorityFilter(const char *value)
+{
+    int rv = 0, len = 0;
+    Array *values = NULL;
+
+    /* A priority means the priorities up to it (i.e. 'err' = emerg..err) */
+    if (!stringContainsStr(value, RANGE_TOKEN)) {
+        LOG_FILTER.minPriority = LOG_EMERG;
+        return (LOG_FILTER.maxPriority = getPriorityByName(value)) == -1 ? 1 : 0;
+    }
+    values = stringSplitOnce((char *)value, RANGE_TOKEN);
+    len = values ? values->size : 0;
+    if (len != 2 || (LOG_FILTER.minPriority = getPriorityByName(arrayGet(values, 0))) == -1 ||
+        (LOG_FILTER.maxPriority = getPriorityByName(arrayGet(values, 1))) == -1 ||
+        LOG_FILTER.minPriority > LOG_FILTER.maxPriority)
+        rv = 1;
+
+    arrayRelease(&values);
+    return rv;
+}
+
+static int setFacilityFilter(const char *value)
+{
+    int rv = 0, len = 0, facility = -1;
+    Array *values = stringSplit((char *)value, ",", true);
+
+    len = values ? values->size : 0;
+    for (int i = 0; i < len; i++) {
+        if ((facility = getFacilityByName(arrayGet(values, i))) == -1) {
+            rv = 1;
+            break;
+        }
+        LOG_FILTER.facilities |= 1U << facility;
+    }
+
+    arrayRelease(&values);
+    return len > 0 ? rv : 1;
+}
+
+/* Set the filter for an unitlogctl option.
+ * The values are not copied thus they must be valid until the show is done (i.e. argv).
+*/
+int setLogFilter(int option, const char *value)
+{
+    int rv = 0;
+    time_t logTime = 0;
+
+    assert(value);
+
+    switch (option) {
+    case 'S':
+    case 'U':
+        if ((rv = parseLogTime(value, &logTime)) != 0)
+            break;
+        if (option == 'S')
+            LOG_FILTER.since = logTime * NSEC_PER_SEC;
+        else
+            LOG_FILTER.until = logTime * NSEC_PER_SEC + NSEC_PER_SEC - 1;
+        break;
+    case 'P':
+        rv = setPriorityFilter(value);
+        break;
+    case 'F':
+        rv = setFacilityFilter(value);
+        break;
+    case 'I':
+        if ((LOG_FILTER.identLen = strlen(value)) == 0 ||
+            LOG_FILTER.identLen > JOURNAL_IDENT_MAX) {
+            rv = 1;
+            break;
+        }
+        LOG_FILTER.ident = value;
+        LOG_FILTER.identHash = getIdentHash(value, LOG_FILTER.identLen);
+        break;
+    case 'n':
+        if (!isValidNumber(value, true) || (LOG_FILTER.pid = atoi(value)) <= 0) {
+            rv = 1;
+            break;
+        }
+        LOG_FILTER.pidHash = getPidHash(LOG_FILTER.pid);
+        break;
+    default:
+        rv = 1;
+        break;
+    }
+    if (rv != 0)
+        logErrorStr(CONSOLE, "The value '%s' is not valid!\n", value);
+
+    return rv;
+}
+
+static bool hasTimeFilter()
+{
+    return LOG_FILTER.since > 0 || LOG_FILTER.until > 0;
+}
+
+/* The legacy log has not the fields */
+static bool hasFieldFilter()
+{
+    return LOG_FILTER.minPriority > LOG_EMERG || LOG_FILTER.maxPriority < LOG_DEBUG ||
+           LOG_FILTER.facilities || LOG_FILTER.ident || LOG_FILTER.pid > 0;
+}
+
+/* Returns false if the block cannot contain matching entries */
+static bool matchLogBlock(JournalBlock *block)
+{
+    return block->maxRealtime >= LOG_FILTER.since &&
+           (LOG_FILTER.until == 0 || block->minRealtime <= LOG_FILTER.until) &&
+           block->minPriority <= LOG_FILTER.maxPriority &&
+           block->maxPriority >= LOG_FILTER.minPriority &&
+           (!LOG_FILTER.facilities || (block->facilities & LOG_FILTER.facilities)) &&
+           (!LOG_FILTER.ident || testJournalBloom(block->idents, LOG_FILTER.identHash)) &&
+           (LOG_FILTER.pid == 0 || testJournalBloom(block->pids, LOG_FILTER.pidHash));
+}
+
+static bool matchLogEntry(JournalEntry *entry)
+{
+    return entry->type == JOURNAL_LOG && entry->realtime >= LOG_FILTER.since &&
+           (LOG_FILTER.until == 0 || entry->realtime <= LOG_FILTER.until) &&
+           entry->priority >= LOG_FILTER.minPriority &&
+           entry->priority <= LOG_FILTER.maxPriority &&
+           (!LOG_FILTER.facilities ||
+            (entry->facility < 32 && (LOG_FILTER.facilities & (1U << entry->facility)))) &&
+           (!LOG_FILTER.ident || (entry->identLen == LOG_FILTER.identLen &&
+                                  memcmp(entry->ident, LOG_FILTER.ident, entry->identLen) == 0)) &&
+           (LOG_FILTER.pid == 0 || entry->pid == LOG_FILTER.pid);
+}
+
+/* Returns the time of a legacy log line or 0 if it doesn't start with the time stamp */
+static uint64_t getLineTime(const char *line)
+{
+    struct tm tmTime = { 0 };
+    time_t lineTime = 0;
+
+    /* Skip the color */
+    if (*line == '\033' && (line = strchr(line, 'm')))
+        line++;
+    if (!line || !strptime(line, "%d %b %Y %H:%M:%S", &tmTime))
+        return 0;
+    tmTime.tm_isdst = -1;
+    if ((lineTime = mktime(&tmTime)) == -1)
+        return 0;
+
+    return lineTime * NSEC_PER_SEC;
+}
+
 int getBootsList(Array **bootsList)
 {
     int rv = 0;
@@ -105,50 +307,231 @@ out:
     return rv;
 }
 
-int showLogLines(off_t startOffset, off_t stopOffset)
+/* Show the matching entries from the reader offset to the end offset (-1 = segment end).
+ * Returns 1 to go on with the next range, 0 if the show is done or -1 if the segment is corrupt.
+*/
+static int showJournalRange(JournalReader *reader, off_t end, off_t startOffset, off_t stopOffset)
 {
-    int rv = 0;
-    char *line = NULL;
-    size_t len = 0;
-    off_t currentOffset = -1;
+    int next = 0;
+    JournalEntry entry = { 0 };
 
-    assert(startOffset >= 0);
+    while ((next = journalNext(reader, &entry)) == 1) {
+        if (end != -1 && reader->offset >= end)
+            return 1;
+        if (stopOffset != -1 && reader->offset > stopOffset)
+            return 0;
+        if (reader->offset >= startOffset && matchLogEntry(&entry))
+            journalRender(reader, &entry, stdout);
+    }
 
-    unitlogdOpenLog("r");
-    assert(UNITLOGD_LOG_FILE);
-    /* Set start offset */
-    if (fseeko(UNITLOGD_LOG_FILE, startOffset, SEEK_SET) == -1) {
-        logError(CONSOLE, "src/unitlogd/client/client.c", "showLogLines", errno, strerror(errno),
-                 "Fseeko func returned -1");
+    return next == 0 ? 1 : -1;
+}
+
+static int showJournalEntries(const char *segmentPath, off_t startOffset, off_t stopOffset)
+{
+    int rv = 0, next = 1, len = 0;
+    JournalReader *reader = NULL;
+    JournalBlock *blocks = NULL;
+    bool sorted = false;
+
+    if ((reader = journalOpen(segmentPath, 0)) == NULL)
+        return 1;
+    /* The blocks start with an host entry thus they can be read on their own.
+     * The blocks which cannot match the filter are skipped.
+    */
+    blocks = getJournalBlocks(segmentPath, LOG_FILTER.since, &len);
+    sorted = len > 0 && !(blocks[len - 1].flags & JOURNAL_BLOCK_UNSORTED);
+    for (int i = 0; i < len && next == 1; i++) {
+        /* The next blocks are later, the clock could only step back after the last block */
+        if (sorted && LOG_FILTER.until > 0 && blocks[i].minRealtime > LOG_FILTER.until)
+            break;
+        if (matchLogBlock(&blocks[i])) {
+            journalReaderSeek(reader, blocks[i].offset);
+            next = showJournalRange(reader, blocks[i].offset + blocks[i].size, startOffset,
+                                    stopOffset);
+        }
+    }
+    /* The entries after the last block (i.e. the current block or no seek file) */
+    if (next == 1) {
+        journalReaderSeek(reader, len > 0 ? blocks[len - 1].offset + blocks[len - 1].size : 0);
+        next = showJournalRange(reader, -1, startOffset, stopOffset);
+    }
+    if (next == -1) {
+        rv = 1;
+        logErrorStr(CONSOLE, "The '%s' segment is corrupt at %ld offset!\n", segmentPath,
+                    reader->bufferOffset + reader->pos);
+    }
+
+    objectRelease(&blocks);
+    journalReaderRelease(&reader);
+    return rv;
+}
+
+/* Complete the partial writes into the standard output (i.e. the pager pipe) */
+static int writeOutput(const char *buffer, size_t len)
+{
+    ssize_t written = 0;
+
+    while (len > 0) {
+        if ((written = write(STDOUT_FILENO, buffer, len)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE, "src/unitlogd/client/client.c", "writeOutput", errno,
+                     strerror(errno), "Unable to write the log lines");
+            return -1;
+        }
+        buffer += written;
+        len -= written;
+    }
+
+    return 0;
+}
+
+static bool lineStartsWith(const char *line, size_t len, const char *prefix)
+{
+    return len >= strlen(prefix) && memcmp(line, prefix, strlen(prefix)) == 0;
+}
+
+static bool isEntryLine(const char *line, size_t len)
+{
+    return lineStartsWith(line, len, ENTRY_STARTED) || lineStartsWith(line, len, ENTRY_FINISHED);
+}
+
+/* The line is not terminated */
+static uint64_t getLegacyLineTime(const char *line, size_t len)
+{
+    char timeStr[64] = { 0 };
+
+    if (len > sizeof(timeStr) - 1)
+        len = sizeof(timeStr) - 1;
+    memcpy(timeStr, line, len);
+
+    return getLineTime(timeStr);
+}
+
+/* The lines of the legacy log are in the mapped range, they end at the stop entry offset.
+ * The consecutive lines to show are written at once without copying them, thus a boot without
+ * filters is written by a single write().
+*/
+static int showLegacyLines(const char *logPath, off_t startOffset, off_t stopOffset)
+{
+    int rv = 0, fd = -1;
+    struct stat st = { 0 };
+    off_t mapOffset = 0;
+    size_t mapSize = 0, len = 0;
+    char *map = NULL, *end = NULL, *line = NULL, *next = NULL, *run = NULL;
+    uint64_t lineTime = 0;
+    bool skip = false, stop = false;
+
+    if ((fd = open(logPath, O_RDONLY | O_CLOEXEC)) == -1 || fstat(fd, &st) == -1) {
         rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "showLegacyLines", rv, strerror(rv),
+                 "Unable to open the '%s' file", logPath);
         goto out;
     }
-    while (getline(&line, &len, UNITLOGD_LOG_FILE) != -1) {
-        /* Check if we achieved the stop offset */
-        if (stopOffset != -1) {
-            if ((currentOffset = ftello(UNITLOGD_LOG_FILE)) == -1) {
-                logError(CONSOLE, "src/unitlogd/client/client.c", "showLogLines", errno,
-                         strerror(errno), "Ftello func returned -1");
-                rv = errno;
-                goto out;
-            }
-            currentOffset -= strlen(line);
-            if (currentOffset > stopOffset)
-                break;
-        }
+    if (stopOffset == -1 || stopOffset > st.st_size)
+        stopOffset = st.st_size;
+    if (startOffset >= stopOffset)
+        goto out;
+    /* The mapping offset must be a multiple of the page size */
+    mapOffset = startOffset - startOffset % sysconf(_SC_PAGESIZE);
+    mapSize = stopOffset - mapOffset;
+    if ((map = mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, mapOffset)) == MAP_FAILED) {
+        map = NULL;
+        rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "showLegacyLines", rv, strerror(rv),
+                 "Unable to map the '%s' file", logPath);
+        goto out;
+    }
+    madvise(map, mapSize, MADV_SEQUENTIAL);
+    end = map + mapSize;
+    /* The buffered output goes before the lines */
+    fflush(stdout);
+    for (line = run = map + (startOffset - mapOffset); line < end && !stop; line = next) {
+        next = memchr(line, '\n', end - line);
+        next = next ? next + 1 : end;
+        len = next - line;
         /* Discard index entries */
-        if (!stringStartsWithStr(line, ENTRY_STARTED) && !stringStartsWithStr(line, ENTRY_FINISHED))
-            printf("%s", line);
+        skip = isEntryLine(line, len);
+        /* The legacy log has not the seek points, thus we check the time of each line */
+        if (!skip && hasTimeFilter() && (lineTime = getLegacyLineTime(line, len)) > 0) {
+            skip = lineTime < LOG_FILTER.since;
+            stop = LOG_FILTER.until > 0 && lineTime > LOG_FILTER.until;
+        }
+        if (!skip && !stop)
+            continue;
+        if (line > run && writeOutput(run, line - run) != 0) {
+            rv = 1;
+            goto out;
+        }
+        run = next;
     }
+    if (!stop && end > run && writeOutput(run, end - run) != 0)
+        rv = 1;
 
 out:
-    objectRelease(&line);
-    unitlogdCloseLog();
-    assert(!UNITLOGD_LOG_FILE);
+    if (map)
+        munmap(map, mapSize);
+    if (fd != -1)
+        close(fd);
     return rv;
 }
 
-int sendToPager(int (*fn)(off_t, off_t), off_t startOffset, off_t stopOffset)
+int showLogLines(const char *logPath, off_t startOffset, off_t stopOffset)
+{
+    assert(startOffset >= 0);
+
+    if (isSegment(logPath))
+        return showJournalEntries(logPath, startOffset, stopOffset);
+
+    return showLegacyLines(logPath, startOffset, stopOffset);
+}
+
+/* Show the log lines of the boots between startIdx and stopIdx (-1 = the last boot).
+ * The boots can be in the legacy log or in their segments.
+*/
+int showBootLines(int startIdx, int stopIdx)
+{
+    int rv = 0;
+    Array *index = NULL;
+    IndexEntry *startEntry = NULL, *stopEntry = NULL;
+    off_t startOffset = 0, stopOffset = -1;
+    char *logPath = NULL;
+
+    if ((rv = getIndex(&index, true)) != 0) {
+        setIndexErr(true);
+        goto out;
+    }
+    if (stopIdx == -1)
+        stopIdx = getMaxIdx(&index);
+    for (int idx = startIdx; idx <= stopIdx && rv == 0; idx++) {
+        startEntry = arrayGet(index, idx * 2);
+        stopEntry = arrayGet(index, idx * 2 + 1);
+        /* Skip the boots out of the time range */
+        if ((LOG_FILTER.until > 0 && *startEntry->start->sec * NSEC_PER_SEC > LOG_FILTER.until) ||
+            (stopEntry && (*stopEntry->stop->sec + 1) * NSEC_PER_SEC <= LOG_FILTER.since))
+            continue;
+        startOffset = atol(startEntry->startOffset);
+        stopOffset = stopEntry ? atol(stopEntry->stopOffset) : -1;
+        logPath = getBootLogPath(startEntry);
+        /* The legacy boots have not the fields, thus they don't match the field filters */
+        if (hasFieldFilter() && !isSegment(logPath)) {
+            objectRelease(&logPath);
+            continue;
+        }
+        if (DEBUG)
+            logInfo(CONSOLE, "Boot id = (%d - %s), Log = %s, Offsets = (%lu - %ld)\n", idx,
+                    startEntry->bootId, logPath, startOffset, stopOffset);
+        rv = showLogLines(logPath, startOffset, stopOffset);
+        objectRelease(&logPath);
+    }
+
+out:
+    arrayRelease(&index);
+    return rv;
+}
+
+int sendToPager(int (*fn)(int, int), int startIdx, int stopIdx)
 {
     int rv = 0, pfds[2];
     pid_t pid;
@@ -158,6 +541,8 @@ int sendToPager(int (*fn)(off_t, off_t), off_t startOffset, off_t stopOffset)
                  strerror(errno), "Pipe function returned a bad exit code");
         goto out;
     }
+    /* The child must not inherit the buffered output */
+    fflush(stdout);
     pid = fork();
     if (pid < 0) {
         rv = errno;
@@ -168,7 +553,9 @@ int sendToPager(int (*fn)(off_t, off_t), off_t startOffset, off_t stopOffset)
         close(pfds[0]);
         dup2(pfds[1], STDOUT_FILENO);
         close(pfds[1]);
-        fn(startOffset, stopOffset);
+        /* The rendered entries are written to the pager in large chunks */
+        setvbuf(stdout, NULL, _IOFBF, PAGER_BUFFER_SIZE);
+        fn(startIdx, stopIdx);
     } else { /* parent */
         /* For the debug, we show the line number */
         char *args[] = { "less", DEBUG ? "-RSX#3NM~g" : "-RSX#3M~g", NULL };
@@ -186,20 +573,333 @@ out:
     return rv;
 }
 
-int followLog()
+/* FOLLOW
+
+The follow mode reads the log of the current boot by itself. The log file and the log directory
+are watched by inotify: the reader resumes from its offset when the file is modified and it
+switches to the segment of the new boot when a newer segment is created. The boot entries are
+shown as the boot boundaries.
+The vacuum replaces the legacy log, thus the legacy offset is kept relative to the boot start
+and the boot is looked up again when the file has been replaced or truncated. A segment is only
+truncated by the repair of its torn tail, so the reader drops the bytes beyond the end.
+The entries are filtered as the show mode does. They are counted first, so only the last
+FOLLOW_ENTRIES ones (or the ones since the since time) are shown before the new ones.
+
+*/
+
+static void showBootBoundary(bool isStart, const char *bootId, size_t len)
+{
+    printf("-- Boot %.*s %s --\n", (int)len, bootId, isStart ? "started" : "finished");
+}
+
+static int readFollowJournal(LogFollow *follow)
+{
+    JournalEntry entry = { 0 };
+    int next = 0;
+
+    while ((next = journalNext(follow->reader, &entry)) == 1) {
+        if (entry.type == JOURNAL_BOOT_START || entry.type == JOURNAL_BOOT_STOP) {
+            if (follow->count >= follow->skip)
+                showBootBoundary(entry.type == JOURNAL_BOOT_START, entry.data, entry.dataLen);
+        } else if (matchLogEntry(&entry) && ++follow->count > follow->skip)
+            journalRender(follow->reader, &entry, stdout);
+    }
+    if (next == -1) {
+        logErrorStr(CONSOLE, "The '%s' segment is corrupt at %ld offset!\n", follow->logPath,
+                    follow->reader->bufferOffset + follow->reader->pos);
+    }
+
+    return next;
+}
+
+static void showFollowLine(LogFollow *follow, const char *line, size_t len)
+{
+    const char *bootId = NULL, *end = NULL;
+    uint64_t lineTime = 0;
+
+    /* The index entries are 'Started | bootId | time' and 'Finished | bootId | time' */
+    if (isEntryLine(line, len)) {
+        if (follow->count >= follow->skip &&
+            (bootId = memmem(line, len, TOKEN_ENTRY, strlen(TOKEN_ENTRY)))) {
+            bootId += strlen(TOKEN_ENTRY);
+            end = memmem(bootId, line + len - bootId, TOKEN_ENTRY, strlen(TOKEN_ENTRY));
+            showBootBoundary(lineStartsWith(line, len, ENTRY_STARTED), bootId,
+                             end ? end - bootId : 0);
+        }
+        return;
+    }
+    /* The legacy lines have not the fields */
+    if (hasFieldFilter())
+        return;
+    if (LOG_FILTER.since > 0 && (lineTime = getLegacyLineTime(line, len)) > 0 &&
+        lineTime < LOG_FILTER.since)
+        return;
+    if (++follow->count > follow->skip)
+        fwrite(line, 1, len, stdout);
+}
+
+/* The incomplete line is read again with the next call */
+static int readFollowLines(LogFollow *follow)
+{
+    ssize_t bytes = 0;
+    size_t len = 0;
+    char *line = NULL, *next = NULL, *end = NULL;
+
+    while (true) {
+        if ((bytes = pread(follow->fd, follow->buffer + len, follow->size - len,
+                           follow->offset + len)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE, "src/unitlogd/client/client.c", "readFollowLines", errno,
+                     strerror(errno), "Unable to read the '%s' file", follow->logPath);
+            return -1;
+        }
+        if (bytes == 0)
+            return 0;
+        len += bytes;
+        end = follow->buffer + len;
+        for (line = follow->buffer; (next = memchr(line, '\n', end - line)); line = next + 1)
+            showFollowLine(follow, line, next + 1 - line);
+        follow->offset += line - follow->buffer;
+        len = end - line;
+        memmove(follow->buffer, line, len);
+        /* The buffer grows for a line longer than it */
+        if (len == follow->size) {
+            follow->size *= 2;
+            follow->buffer = realloc(follow->buffer, follow->size);
+            assert(follow->buffer);
+        }
+    }
+}
+
+static int readFollow(LogFollow *follow)
+{
+    return follow->reader ? readFollowJournal(follow) : readFollowLines(follow);
+}
+
+/* Returns the offset of the boot start entry into the legacy log or -1 */
+static off_t findBootStart(const char *logPath, const char *bootId)
+{
+    FILE *fp = NULL;
+    char *line = NULL;
+    size_t len = 0;
+    ssize_t lineLen = 0;
+    off_t offset = 0, startOffset = -1;
+
+    if ((fp = fopen(logPath, "r")) == NULL)
+        return -1;
+    while ((lineLen = getline(&line, &len, fp)) != -1) {
+        if (lineStartsWith(line, lineLen, ENTRY_STARTED) && stringContainsStr(line, bootId)) {
+            startOffset = offset;
+            break;
+        }
+        offset += lineLen;
+    }
+
+    objectRelease(&line);
+    fclose(fp);
+    return startOffset;
+}
+
+/* Open the log file and watch it */
+static int watchFollow(LogFollow *follow, int inotifyFd)
+{
+    int rv = 0;
+    struct stat st = { 0 };
+
+    if (isSegment(follow->logPath)) {
+        if ((follow->reader = journalOpen(follow->logPath, 0)) == NULL)
+            return 1;
+        follow->fd = follow->reader->fd;
+    } else if ((follow->fd = open(follow->logPath, O_RDONLY | O_CLOEXEC)) == -1 ||
+               fstat(follow->fd, &st) == -1) {
+        rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "watchFollow", rv, strerror(rv),
+                 "Unable to open the '%s' file", follow->logPath);
+        return rv;
+    }
+    follow->ino = st.st_ino;
+    if ((follow->wd = inotify_add_watch(inotifyFd, follow->logPath, IN_MODIFY)) == -1) {
+        rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "watchFollow", rv, strerror(rv),
+                 "Unable to watch the '%s' file", follow->logPath);
+    }
+
+    return rv;
+}
+
+static void unwatchFollow(LogFollow *follow, int inotifyFd)
+{
+    /* The watch is already removed if the file has been deleted */
+    if (follow->wd != -1)
+        inotify_rm_watch(inotifyFd, follow->wd);
+    if (follow->reader)
+        journalReaderRelease(&follow->reader);
+    else if (follow->fd != -1)
+        close(follow->fd);
+    follow->fd = follow->wd = -1;
+}
+
+/* The legacy log is read from the start entry of the current boot */
+static int openFollow(LogFollow *follow, const char *logPath, int inotifyFd)
+{
+    Array *index = NULL;
+    IndexEntry *startEntry = NULL;
+    int maxIdx = -1;
+
+    stringSet(&follow->logPath, logPath);
+    if (!isSegment(logPath)) {
+        if (getIndex(&index, true) != 0 || (maxIdx = getMaxIdx(&index)) == -1) {
+            setIndexErr(true);
+            arrayRelease(&index);
+            return 1;
+        }
+        startEntry = arrayGet(index, maxIdx * 2);
+        follow->offset = follow->startOffset = atol(startEntry->startOffset);
+        stringSet(&follow->bootId, startEntry->bootId);
+        arrayRelease(&index);
+        if (!follow->buffer) {
+            follow->size = FOLLOW_READ_SIZE;
+            follow->buffer = calloc(follow->size, sizeof(char));
+            assert(follow->buffer);
+        }
+    }
+
+    return watchFollow(follow, inotifyFd);
+}
+
+/* The segment of the new boot has been created (by a restart of unitlogd) */
+static int switchFollow(LogFollow *follow, int inotifyFd)
+{
+    int rv = 0;
+    Array *segments = getSegments();
+    const char *segmentPath = segments->size > 0 ? arrayGet(segments, segments->size - 1) : NULL;
+
+    if (segmentPath && !stringEquals(segmentPath, follow->logPath)) {
+        /* The rest of the previous boot (i.e. its stop entry) */
+        if ((rv = readFollow(follow)) == 0) {
+            unwatchFollow(follow, inotifyFd);
+            follow->count = follow->skip = 0;
+            rv = openFollow(follow, segmentPath, inotifyFd);
+        }
+    }
+
+    arrayRelease(&segments);
+    return rv;
+}
+
+static int checkFollow(LogFollow *follow, int inotifyFd)
 {
     int rv = 0;
+    struct stat st = { 0 };
+    JournalReader *reader = follow->reader;
+    off_t offset = 0;
+
+    if (reader) {
+        if (fstat(reader->fd, &st) == 0 && st.st_size < reader->bufferOffset + (off_t)reader->len) {
+            offset = reader->bufferOffset + reader->pos;
+            if (offset > st.st_size) {
+                /* Skip as many entries as have been shown */
+                offset = 0;
+                follow->skip = follow->count;
+                follow->count = 0;
+            }
+            journalReaderSeek(reader, offset);
+        }
+        return 0;
+    }
+    /* The legacy log is missing while it is being replaced */
+    if (stat(follow->logPath, &st) == -1 ||
+        (st.st_ino == follow->ino && st.st_size >= follow->offset))
+        return 0;
+    offset = follow->offset - follow->startOffset;
+    unwatchFollow(follow, inotifyFd);
+    if ((rv = watchFollow(follow, inotifyFd)) != 0)
+        return rv;
+    if ((follow->startOffset = findBootStart(follow->logPath, follow->bootId)) == -1) {
+        logErrorStr(CONSOLE, "The boot '%s' has not been found in the '%s' file!\n",
+                    follow->bootId, follow->logPath);
+        return 1;
+    }
+    follow->offset = follow->startOffset + offset;
+
+    return 0;
+}
+
+/* Returns 1 if the log directory has been changed, 0 if only the log file or -1 */
+static int waitFollow(int inotifyFd, int dirWd)
+{
+    char events[FOLLOW_EVENTS_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *event = NULL;
+    ssize_t len = 0;
+    int rv = 0;
+
+    while ((len = read(inotifyFd, events, sizeof(events))) == -1) {
+        if (errno != EINTR) {
+            logError(CONSOLE, "src/unitlogd/client/client.c", "waitFollow", errno,
+                     strerror(errno), "Unable to read the inotify events");
+            return -1;
+        }
+    }
+    for (char *ptr = events; ptr < events + len; ptr += sizeof(struct inotify_event) + event->len) {
+        event = (const struct inotify_event *)ptr;
+        if (event->wd == dirWd)
+            rv = 1;
+    }
+
+    return rv;
+}
+
+int followLog()
+{
+    int rv = 0, inotifyFd = -1, dirWd = -1, changed = 0;
+    LogFollow follow = { .fd = -1, .wd = -1 };
+    char *logPath = NULL;
 
     if (DEBUG)
         logInfo(CONSOLE, "\n\n-- Follow the log --\n\n");
-    Array *envVars = arrayNew(objectRelease);
-    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
-    addEnvVar(&envVars, "UNITLOGD_LOG_PATH", UNITLOGD_LOG_PATH);
-    arrayAdd(envVars, NULL);
-    rv = execUlScript(&envVars, "follow");
+    /* A new segment or the replaced legacy log are created into the log directory */
+    if ((inotifyFd = inotify_init1(IN_CLOEXEC)) == -1 ||
+        (dirWd = inotify_add_watch(inotifyFd, UNITLOGD_PATH, IN_CREATE | IN_MOVED_TO)) == -1) {
+        rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "followLog", rv, strerror(rv),
+                 "Unable to watch the '%s' directory", UNITLOGD_PATH);
+        goto out;
+    }
+    /* Follow the log of the current boot */
+    logPath = getCurrentLogPath();
+    if ((rv = openFollow(&follow, logPath, inotifyFd)) != 0)
+        goto out;
+    /* Count the entries to show the last ones */
+    follow.skip = INT_MAX;
+    if ((rv = readFollow(&follow)) != 0)
+        goto out;
+    follow.skip = LOG_FILTER.since > 0 ? 0 : follow.count - FOLLOW_ENTRIES;
+    follow.count = 0;
+    if (follow.reader)
+        journalReaderSeek(follow.reader, 0);
+    else
+        follow.offset = follow.startOffset;
+    while ((rv = readFollow(&follow)) == 0) {
+        fflush(stdout);
+        if ((changed = waitFollow(inotifyFd, dirWd)) == -1 ||
+            (changed == 1 && switchFollow(&follow, inotifyFd) != 0) ||
+            checkFollow(&follow, inotifyFd) != 0) {
+            rv = 1;
+            break;
+        }
+    }
 
-    arrayRelease(&envVars);
-    return rv;
+out:
+    if (inotifyFd != -1) {
+        unwatchFollow(&follow, inotifyFd);
+        close(inotifyFd);
+    }
+    objectRelease(&follow.logPath);
+    objectRelease(&follow.bootId);
+    objectRelease(&follow.buffer);
+    objectRelease(&logPath);
+    return rv != 0 ? 1 : 0;
 }
 
 int showLog(bool pager, bool follow)
@@ -211,9 +911,9 @@ int showLog(bool pager, bool follow)
         goto out;
     }
     if (pager)
-        rv = sendToPager(showLogLines, 0, -1);
+        rv = sendToPager(showBootLines, 0, -1);
     else
-        rv = showLogLines(0, -1);
+        rv = showBootLines(0, -1);
 
 out:
     return rv;
@@ -246,7 +946,6 @@ int showBoot(bool pager, bool follow, const char *bootIdx)
     int rv = 0, idx = -1, idxMax = -1, indexSize = 0;
     Array *index = NULL;
     bool error = false;
-    off_t startOffset = 0, stopOffset = -1;
 
     assert(bootIdx);
 
@@ -266,28 +965,6 @@ int showBoot(bool pager, bool follow, const char *bootIdx)
             idx = atol(bootIdx);
             if (idx > idxMax)
                 error = true;
-            else {
-                /* Get start and stop offset */
-                IndexEntry *startIndexEntry = NULL;
-                IndexEntry *stopIndexEntry = NULL;
-                if (idx == 0) {
-                    startIndexEntry = arrayGet(index, idx);
-                    stopIndexEntry = arrayGet(index, idx + 1);
-                } else {
-                    startIndexEntry = arrayGet(index, idx * 2);
-                    stopIndexEntry = arrayGet(index, idx * 2 + 1);
-                }
-                startOffset = atol(startIndexEntry->startOffset);
-                if (stopIndexEntry)
-                    stopOffset = atol(stopIndexEntry->stopOffset);
-                if (DEBUG) {
-                    logInfo(CONSOLE, "Start - Boot id = (%d - %s), Offset = %lu\n", idx,
-                            startIndexEntry->bootId, startOffset);
-                    if (stopIndexEntry)
-                        logInfo(CONSOLE, "Stop - Boot id = (%d - %s), Offset = %lu\n", idx,
-                                stopIndexEntry->bootId, stopOffset);
-                }
-            }
         } else
             error = true;
         if (error) {
@@ -297,9 +974,9 @@ int showBoot(bool pager, bool follow, const char *bootIdx)
             goto out;
         }
         if (pager)
-            rv = sendToPager(showLogLines, startOffset, stopOffset);
+            rv = sendToPager(showBootLines, idx, idx);
         else
-            rv = showLogLines(startOffset, stopOffset);
+            rv = showBootLines(idx, idx);
     } else
         logWarning(CONSOLE, "The '%s' index file is empty!\n", UNITLOGD_INDEX_PATH);
 
@@ -328,31 +1005,14 @@ int indexRepair()
 {
     int rv = 0, indexSize = 0;
     Array *index = NULL;
-    IndexEntry *indexEntry = NULL;
 
     if ((rv = getIndex(&index, false)) != 0) {
         setIndexErr(false);
         goto out;
     }
     indexSize = index ? index->size : 0;
-    if (indexSize > 0) {
-        if ((rv = createIndexFile()) != 0)
-            goto out;
-        if (unitlogdOpenIndex("a") != 0) {
-            rv = 1;
-            goto out;
-        }
-        assert(UNITLOGD_INDEX_FILE);
-        for (int i = 0; i < indexSize; i++) {
-            indexEntry = arrayGet(index, i);
-            if (i % 2 == 0)
-                rv = writeEntry(true, indexEntry, true);
-            else
-                rv = writeEntry(false, indexEntry, true);
-            if (rv != 0)
-                goto out;
-        }
-    }
+    if (indexSize > 0)
+        rv = writeIndex(index);
 
 out:
     arrayRelease(&index);
@@ -404,7 +1064,7 @@ int cutLog(off_t startOffset, off_t stopOffset)
                  "Unable to open '%s' in append mode!", tmpLogPath);
         goto out;
     }
-    unitlogdOpenLog("r");
+    unitlogdOpenLog(UNITLOGD_LOG_PATH, "r");
     assert(UNITLOGD_LOG_FILE);
     while (getline(&line, &len, UNITLOGD_LOG_FILE) != -1) {
         if ((currentOffset = ftello(UNITLOGD_LOG_FILE)) == -1) {
@@ -469,14 +1129,110 @@ void printLogSizeInfo(off_t prevLogSize, off_t freedLogSize, off_t currentLogSiz
     objectRelease(&freedLogSizeStr);
 }
 
+/* Ask unitlogd to suspend the log writing (see writer.c).
+ * The writing is resumed when the returned control fd is closed.
+ * If unitlogd is not running, there is nothing to suspend and the fd is -1.
+*/
+int requestMaintenance(int *ctlFd)
+{
+    int rv = 0;
+    char request = WRITER_SUSPEND;
+    struct sockaddr_un sa = { 0 };
+
+    sa.sun_family = AF_UNIX;
+    strncpy(sa.sun_path, UNITLOGD_CTL_NAME, sizeof(sa.sun_path) - 1);
+    if ((*ctlFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1) {
+        rv = errno;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "requestMaintenance", errno,
+                 strerror(errno), "Unable to create the control socket");
+        return rv;
+    }
+    if (connect(*ctlFd, (const struct sockaddr *)&sa, sizeof(struct sockaddr_un)) == -1) {
+        rv = errno;
+        close(*ctlFd);
+        *ctlFd = -1;
+        if (rv == ENOENT || rv == ECONNREFUSED)
+            return 0;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "requestMaintenance", rv, strerror(rv),
+                 "Unable to connect to '%s'", UNITLOGD_CTL_NAME);
+        return rv;
+    }
+    /* Wait for the acknowledgement */
+    errno = 0;
+    if (uWrite(*ctlFd, &request, 1) != 1 || uRead(*ctlFd, &request, 1) != 1 ||
+        request != WRITER_SUSPEND) {
+        rv = errno ? errno : EPROTO;
+        logError(CONSOLE, "src/unitlogd/client/client.c", "requestMaintenance", rv, strerror(rv),
+                 "Unable to suspend the unitlog daemon writer");
+        close(*ctlFd);
+        *ctlFd = -1;
+    }
+
+    return rv;
+}
+
+/* Remove the boots between startIdx and stopIdx from the logs and from the index array.
+ * The segments are unlinked while the legacy log has to be cut.
+ * Whatever error occurred, the index array matches the logs unless it is released.
+*/
+static int removeBoots(Array **index, int startIdx, int stopIdx)
+{
+    int rv = 0;
+    off_t startOffset = -1, stopOffset = -1;
+    IndexEntry *startEntry = NULL, *stopEntry = NULL;
+    char *logPath = NULL;
+    Array *segments = arrayNew(objectRelease);
+
+    for (int idx = startIdx; idx <= stopIdx; idx++) {
+        startEntry = arrayGet(*index, idx * 2);
+        stopEntry = arrayGet(*index, idx * 2 + 1);
+        assert(startEntry && stopEntry);
+        logPath = getBootLogPath(startEntry);
+        if (DEBUG)
+            logInfo(CONSOLE, "Boot id = %s, Log = %s, Offsets = (%s - %s)\n", startEntry->bootId,
+                    logPath, startEntry->startOffset, stopEntry->stopOffset);
+        if (isSegment(logPath))
+            arrayAdd(segments, logPath);
+        else {
+            /* The legacy boots are the oldest ones thus they are contiguous */
+            if (startOffset == -1)
+                startOffset = atol(startEntry->startOffset);
+            stopOffset = atol(stopEntry->stopOffset);
+            objectRelease(&logPath);
+        }
+    }
+    for (int i = 0; i < segments->size; i++) {
+        if (removeSegment(arrayGet(segments, i)) != 0)
+            rv = 1;
+    }
+    if (startOffset != -1 && rv == 0)
+        rv = cutLog(startOffset, stopOffset);
+    if (rv == 0) {
+        for (int i = stopIdx * 2 + 1; i >= startIdx * 2; i--)
+            arrayRemoveAt(*index, i);
+    }
+    /* The legacy offsets are changed or some segments could not be removed,
+     * thus we have to read the entries from the logs.
+    */
+    if (startOffset != -1 || rv != 0) {
+        arrayRelease(index);
+        if (getIndex(index, false) != 0) {
+            setIndexErr(false);
+            arrayRelease(index);
+            rv = 1;
+        }
+    }
+
+    arrayRelease(&segments);
+    return rv;
+}
+
 int vacuum(const char *bootIdx)
 {
     Array *index = NULL, *idxArr = NULL;
-    int rv = 0, startIdx = -1, stopIdx = -1, maxIdx = -1;
-    off_t startOffset = -1, stopOffset = -1, prevLogSize = -1, currentLogSize = -1,
-          freedLogSize = -1;
+    int rv = 0, startIdx = -1, stopIdx = -1, maxIdx = -1, ctlFd = -1;
+    off_t prevLogSize = -1, currentLogSize = -1, freedLogSize = -1;
     bool rangeErr = false;
-    IndexEntry *indexEntry = NULL;
 
     assert(bootIdx);
 
@@ -535,48 +1291,37 @@ int vacuum(const char *bootIdx)
         logInfo(CONSOLE, "Please, try again later.\n");
         goto out;
     }
-    /* Get 'start' offset according startIdx  */
-    if (startIdx == 0)
-        indexEntry = arrayGet(index, startIdx);
-    else
-        indexEntry = arrayGet(index, startIdx * 2);
-    assert(indexEntry);
-    startOffset = atol(indexEntry->startOffset);
-    if (DEBUG)
-        logInfo(CONSOLE, "Boot id = %s, startOffset  = %lu\n", indexEntry->bootId, startOffset);
-    /* Get 'stop' offset according stopIdx */
-    if (stopIdx != -1)
-        indexEntry = arrayGet(index, stopIdx * 2 + 1);
-    else
-        indexEntry = arrayGet(index, startIdx * 2 + 1);
-    assert(indexEntry);
-    stopOffset = atol(indexEntry->stopOffset);
-    if (DEBUG)
-        logInfo(CONSOLE, "Boot id = %s, stopOffset  = %lu\n", indexEntry->bootId, stopOffset);
+    if (stopIdx == -1)
+        stopIdx = startIdx;
     /* Lock
-     * We cannot cut the log if the unitlog daemon is writing it!
-     * See startUnixThread func in socket.c.
+     * The lock file serializes the maintenance operations.
+     * The unitlog daemon only writes the segment of the current boot, which can't be removed,
+     * but we suspend its writer anyway while the logs and the index are changing.
+     * See writer.c.
     */
     if ((rv = handleLockFile(true)) != 0)
         goto out;
     /* From this point, whatever error occurred, we don't exit because we must always unlock. */
-    if ((prevLogSize = getFileSize(UNITLOGD_LOG_PATH)) != -1) {
-        if ((rv = cutLog(startOffset, stopOffset)) == 0) {
-            if ((rv = indexRepair()) == 0) {
-                if ((currentLogSize = getFileSize(UNITLOGD_LOG_PATH)) != -1) {
-                    freedLogSize = prevLogSize - currentLogSize;
-                    if (DEBUG) {
-                        logInfo(CONSOLE, "Previous log size = %lu\n", prevLogSize);
-                        logInfo(CONSOLE, "Current log size  = %lu\n", currentLogSize);
-                        logInfo(CONSOLE, "Freed log size    = %lu\n", freedLogSize);
-                    }
-                    logSuccess(CONSOLE, "Vacuuming done successfully!\n\n");
-                    printLogSizeInfo(prevLogSize, freedLogSize, currentLogSize);
-                }
+    if ((rv = requestMaintenance(&ctlFd)) == 0 && (prevLogSize = getLogSize()) != -1) {
+        rv = removeBoots(&index, startIdx, stopIdx);
+        if (index && writeIndex(index) != 0)
+            rv = 1;
+        if (rv == 0 && (currentLogSize = getLogSize()) != -1) {
+            freedLogSize = prevLogSize - currentLogSize;
+            if (DEBUG) {
+                logInfo(CONSOLE, "Previous log size = %lu\n", prevLogSize);
+                logInfo(CONSOLE, "Current log size  = %lu\n", currentLogSize);
+                logInfo(CONSOLE, "Freed log size    = %lu\n", freedLogSize);
             }
+            logSuccess(CONSOLE, "Vacuuming done successfully!\n\n");
+            printLogSizeInfo(prevLogSize, freedLogSize, currentLogSize);
         }
     }
-    rv = handleLockFile(false);
+    /* Resume the unitlog daemon writer */
+    if (ctlFd != -1)
+        close(ctlFd);
+    if (handleLockFile(false) != 0)
+        rv = 1;
 
 out:
     arrayRelease(&idxArr);
@@ -17,6 +17,10 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #define WIDTH_DATE 19
 #define RANGE_TOKEN ".."
 #define TMP_SUFFIX ".tmp"
+#define FOLLOW_ENTRIES 10
+#define FOLLOW_READ_SIZE 65536
+#define FOLLOW_EVENTS_SIZE 4096
+#define PAGER_BUFFER_SIZE 262144
 
 typedef enum {
     NO_UL_COMMAND = -1,
@@ -33,16 +37,56 @@ typedef struct {
     const char *name;
 } UlCommandData;
 
+/* The filter of the shown entries (0 = not set). The times are in nanoseconds.
+ * The priority range is minPriority..maxPriority (emerg..debug by default).
+*/
+typedef struct {
+    uint64_t since;
+    uint64_t until;
+    int minPriority;
+    int maxPriority;
+    uint32_t facilities;
+    const char *ident;
+    size_t identLen;
+    uint32_t identHash;
+    pid_t pid;
+    uint32_t pidHash;
+} LogFilter;
+
+/* The state of the follow mode.
+ * A segment is read by the journal reader, the legacy log by lines from the offset.
+*/
+typedef struct {
+    char *logPath;
+    JournalReader *reader;
+    int fd;
+    int wd;
+    ino_t ino;
+    char *bootId;
+    off_t startOffset;
+    off_t offset;
+    char *buffer;
+    size_t size;
+    int count;
+    int skip;
+} LogFollow;
+
+extern LogFilter LOG_FILTER;
+
 UlCommand getUlCommand(const char *);
 bool getSkipCheckAdmin(UlCommand);
+int parseLogTime(const char *, time_t *);
+int setLogFilter(int, const char *);
 int showBootsList();
 int showLog(bool, bool);
-int showLogLines(off_t, off_t);
-int sendToPager(int (*fn)(off_t, off_t), off_t, off_t);
+int showLogLines(const char *, off_t, off_t);
+int showBootLines(int, int);
+int sendToPager(int (*fn)(int, int), int, int);
 int showBoot(bool, bool, const char *);
 int showCurrentBoot(bool, bool);
 int followLog();
 int createIndexFile();
+int requestMaintenance(int *);
 int vacuum(const char *);
 int runTmpLogOperation(const char *);
 void printLogSizeInfo(off_t, off_t, off_t);
@@ -0,0 +1,338 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitlogd_impl.h"
+
+/* COMPRESSOR
+
+The segments of the previous boots are closed, so the compressor thread compresses them in
+background when the daemon starts. The compressed file (boot-<start>-<bootId>.log.z) begins with
+the frame table (JournalFramesHeader and JournalFrame items) followed by the frames.
+A frame contains the entries of about JOURNAL_FRAME_SIZE bytes of the segment and it is
+compressed on its own by zlib, thus it can be decompressed without the previous ones.
+The offsets of the index and of the seek file still refer to the segment, so a reader finds the
+frame of an offset by a binary search of the frame table and only decompresses the frames which
+it reads (see journalRead()).
+The compressed file is written into a temporary file, then it replaces the segment holding the
+lock file, so the maintenance operations (vacuum) never see a boot without its log.
+The log directory is synced after the rename, so a crash never loses both files.
+A reader which has already opened the segment keeps reading it.
+
+*/
+
+static pthread_t COMPRESSOR_THREAD;
+static pthread_mutex_t COMPRESSOR_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static bool COMPRESSOR_STARTED;
+static bool COMPRESSOR_EXIT;
+
+static bool isCompressorExiting()
+{
+    bool exiting = false;
+
+    pthread_mutex_lock(&COMPRESSOR_MUTEX);
+    exiting = COMPRESSOR_EXIT;
+    pthread_mutex_unlock(&COMPRESSOR_MUTEX);
+
+    return exiting;
+}
+
+/* The lock file is handled by its own descriptor because handleLockFile() belongs to the
+ * writer thread.
+*/
+static int lockLogs(int *fd, bool lock)
+{
+    int rv = 0;
+    struct flock flock = { 0 };
+
+    flock.l_type = lock ? F_WRLCK : F_UNLCK;
+    flock.l_whence = SEEK_SET;
+    if (lock && (*fd = getLockFileFd()) == -1)
+        return 1;
+    if (fcntl(*fd, lock ? F_SETLKW : F_SETLK, &flock) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "lockLogs", rv,
+                 strerror(rv), "Fcntl func returned -1 exit code (%s)", lock ? "lock" : "unlock");
+    }
+    if (!lock || rv != 0) {
+        close(*fd);
+        *fd = -1;
+    }
+
+    return rv;
+}
+
+static void addFrame(JournalFrame **frames, int *numFrames, off_t offset, off_t end)
+{
+    *frames = realloc(*frames, (*numFrames + 1) * sizeof(JournalFrame));
+    assert(*frames);
+    memset(&(*frames)[*numFrames], 0, sizeof(JournalFrame));
+    (*frames)[*numFrames].offset = offset;
+    (*frames)[*numFrames].size = end - offset;
+    (*numFrames)++;
+}
+
+/* The frames end at an entry boundary */
+static int getFrames(JournalReader *reader, off_t size, JournalFrame **frames, int *numFrames)
+{
+    JournalEntry entry = { 0 };
+    off_t offset = 0, end = 0;
+    int next = 0;
+
+    while ((next = journalNext(reader, &entry)) == 1) {
+        if (reader->offset - offset >= JOURNAL_FRAME_SIZE) {
+            addFrame(frames, numFrames, offset, reader->offset);
+            offset = reader->offset;
+        }
+    }
+    end = reader->bufferOffset + reader->pos;
+    if (next == -1 || end != size)
+        return -1;
+    if (end > offset)
+        addFrame(frames, numFrames, offset, end);
+
+    return 0;
+}
+
+static int writeFrame(int fd, const void *buffer, size_t len, off_t offset, const char *path)
+{
+    ssize_t written = 0;
+
+    /* Complete the partial writes */
+    while (len > 0) {
+        if ((written = pwrite(fd, buffer, len, offset)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "writeFrame",
+                     errno, strerror(errno), "Unable to write into the '%s' file", path);
+            return -1;
+        }
+        buffer = (const char *)buffer + written;
+        len -= written;
+        offset += written;
+    }
+
+    return 0;
+}
+
+static int writeFrames(JournalReader *reader, JournalFrame *frames, int numFrames, int fd,
+                       const char *tmpPath)
+{
+    int rv = 0;
+    JournalFramesHeader header = { 0 };
+    off_t fileOffset = sizeof(JournalFramesHeader) + numFrames * sizeof(JournalFrame);
+    char *buffer = NULL, *compressed = NULL;
+    uLongf len = 0;
+
+    for (int i = 0; i < numFrames && rv == 0; i++) {
+        if (isCompressorExiting()) {
+            rv = 1;
+            break;
+        }
+        buffer = realloc(buffer, frames[i].size);
+        assert(buffer);
+        len = compressBound(frames[i].size);
+        compressed = realloc(compressed, len);
+        assert(compressed);
+        if (preadAll(reader->fd, buffer, frames[i].size, frames[i].offset) != 0) {
+            rv = errno;
+            logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "writeFrames",
+                     rv, strerror(rv), "Unable to read the frame at %lu offset",
+                     frames[i].offset);
+            break;
+        }
+        if ((rv = compress2((Bytef *)compressed, &len, (Bytef *)buffer, frames[i].size,
+                            COMPRESSOR_LEVEL)) != Z_OK) {
+            logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "writeFrames",
+                     rv, zError(rv), "Unable to compress the frame at %lu offset",
+                     frames[i].offset);
+            break;
+        }
+        frames[i].fileOffset = fileOffset;
+        frames[i].compressedSize = len;
+        if ((rv = writeFrame(fd, compressed, len, fileOffset, tmpPath)) == 0)
+            fileOffset += len;
+    }
+    /* The frame table is written after the frames */
+    if (rv == 0) {
+        header.magic = JOURNAL_FRAMES_MAGIC;
+        header.numFrames = numFrames;
+        if ((rv = writeFrame(fd, &header, sizeof(JournalFramesHeader), 0, tmpPath)) == 0)
+            rv = writeFrame(fd, frames, numFrames * sizeof(JournalFrame),
+                            sizeof(JournalFramesHeader), tmpPath);
+    }
+
+    objectRelease(&buffer);
+    objectRelease(&compressed);
+    return rv;
+}
+
+/* The renamed file is durable only when the directory is on disk */
+static int syncLogDir()
+{
+    int rv = 0, fd = -1;
+
+    if ((fd = open(UNITLOGD_PATH, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1 || fsync(fd) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "syncLogDir", rv,
+                 strerror(rv), "Unable to sync the '%s' directory", UNITLOGD_PATH);
+    }
+    if (fd != -1)
+        close(fd);
+
+    return rv;
+}
+
+/* Replace the segment by its compressed file */
+int compressSegment(const char *segmentPath)
+{
+    int rv = 0, fd = -1, lockFd = -1, numFrames = 0;
+    JournalReader *reader = NULL;
+    JournalFrame *frames = NULL;
+    char *compressedPath = NULL, *tmpPath = NULL;
+    struct stat st = { 0 };
+
+    assert(segmentPath);
+
+    /* The segment could have been compressed meanwhile */
+    if ((reader = journalOpen(segmentPath, 0)) == NULL || reader->frames) {
+        journalReaderRelease(&reader);
+        return 0;
+    }
+    if (fstat(reader->fd, &st) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "compressSegment", rv,
+                 strerror(rv), "Unable to stat the '%s' segment", segmentPath);
+        goto out;
+    }
+    if (getFrames(reader, st.st_size, &frames, &numFrames) != 0) {
+        rv = 1;
+        logWarning(CONSOLE | SYSTEM, "The '%s' segment is corrupt, it will not be compressed\n",
+                   segmentPath);
+        goto out;
+    }
+    compressedPath = getCompressedPath(segmentPath);
+    tmpPath = stringNew(compressedPath);
+    stringAppendStr(&tmpPath, COMPRESSOR_TMP_SUFFIX);
+    /* The compressed file has the segment permissions */
+    if ((fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777)) == -1 ||
+        fchown(fd, st.st_uid, st.st_gid) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "compressSegment", rv,
+                 strerror(rv), "Unable to create the '%s' file", tmpPath);
+        goto out;
+    }
+    if ((rv = writeFrames(reader, frames, numFrames, fd, tmpPath)) != 0)
+        goto out;
+    /* The compressed file must be on disk before it replaces the segment */
+    if (fdatasync(fd) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "compressSegment", rv,
+                 strerror(rv), "Unable to sync the '%s' file", tmpPath);
+        goto out;
+    }
+    if ((rv = lockLogs(&lockFd, true)) != 0)
+        goto out;
+    /* The boot could have been removed by vacuum meanwhile */
+    if (access(segmentPath, F_OK) == -1)
+        rv = 1;
+    else if (rename(tmpPath, compressedPath) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "compressSegment", rv,
+                 strerror(rv), "Unable to replace the '%s' segment", segmentPath);
+    }
+    /* The segment is removed only when the compressed file is in the directory on disk.
+     * Otherwise both are kept, the readers prefer the segment.
+    */
+    else if ((rv = syncLogDir()) == 0 && unlink(segmentPath) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "compressSegment", rv,
+                 strerror(rv), "Unable to remove the '%s' segment", segmentPath);
+    }
+    lockLogs(&lockFd, false);
+    if (rv == 0 && DEBUG)
+        logInfo(CONSOLE, "Compressed '%s' (%d frames, %ld -> %ld bytes)\n", segmentPath,
+                numFrames, st.st_size, getFileSize(compressedPath));
+
+out:
+    if (fd != -1) {
+        close(fd);
+        if (rv != 0)
+            unlink(tmpPath);
+    }
+    journalReaderRelease(&reader);
+    objectRelease(&frames);
+    objectRelease(&compressedPath);
+    objectRelease(&tmpPath);
+    return rv;
+}
+
+static void *startCompressorThread(void *arg UNUSED)
+{
+    int lockFd = -1, len = 0;
+    Array *index = NULL, *segments = arrayNew(objectRelease);
+    char *segmentPath = NULL;
+
+    /* The boots which have the stop entry, except the current one */
+    if (lockLogs(&lockFd, true) != 0)
+        goto out;
+    if (getIndex(&index, true) == 0) {
+        len = index->size - index->size % 2;
+        for (int i = 0; i < len; i += 2) {
+            segmentPath = getSegmentPath(arrayGet(index, i));
+            if (!stringEquals(segmentPath, SEGMENT_PATH) && access(segmentPath, F_OK) == 0)
+                arrayAdd(segments, segmentPath);
+            else
+                objectRelease(&segmentPath);
+        }
+    }
+    lockLogs(&lockFd, false);
+    for (int i = 0; i < segments->size && !isCompressorExiting(); i++)
+        compressSegment(arrayGet(segments, i));
+
+out:
+    arrayRelease(&index);
+    arrayRelease(&segments);
+    return NULL;
+}
+
+/* The index file must be closed */
+int startCompressor()
+{
+    int rv = 0;
+
+    assert(!UNITLOGD_INDEX_FILE);
+
+    COMPRESSOR_EXIT = false;
+    if ((rv = pthread_create(&COMPRESSOR_THREAD, NULL, startCompressorThread, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "startCompressor", rv,
+                 strerror(rv), "Unable to create the compressor thread");
+        return rv;
+    }
+    COMPRESSOR_STARTED = true;
+
+    return rv;
+}
+
+/* The segment being compressed is left as is */
+int stopCompressor()
+{
+    int rv = 0;
+
+    if (!COMPRESSOR_STARTED)
+        return rv;
+    pthread_mutex_lock(&COMPRESSOR_MUTEX);
+    COMPRESSOR_EXIT = true;
+    pthread_mutex_unlock(&COMPRESSOR_MUTEX);
+    if ((rv = pthread_join(COMPRESSOR_THREAD, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/compressor/compressor.c", "stopCompressor", rv,
+                 strerror(rv), "Unable to join the compressor thread");
+    }
+    COMPRESSOR_STARTED = false;
+
+    return rv;
+}
@@ -0,0 +1,19 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#define COMPRESSOR_LEVEL Z_BEST_SPEED
+#define COMPRESSOR_TMP_SUFFIX ".tmp"
+
+int compressSegment(const char *);
+int startCompressor();
+int stopCompressor();
+
+#endif // COMPRESSOR_H
@@ -25,9 +25,6 @@ case $OPERATION in
 	chmod -R 0650 "$UNITLOGD_PATH"
 	chown -R :users "$UNITLOGD_PATH"
 	;;
-"follow")
-	tail -f "$UNITLOGD_LOG_PATH"
-	;;
 "create-index")
 	rm -rf "$UNITLOGD_INDEX_PATH" || true
 	touch "$UNITLOGD_INDEX_PATH"
@@ -46,6 +43,14 @@ case $OPERATION in
 	rm -rf "$log"
 	mv "$tmp_log" "$log"
 	;;
+"create-segment")
+	touch "$UNITLOGD_SEGMENT_PATH"
+	chmod 0650 "$UNITLOGD_SEGMENT_PATH"
+	chown :users "$UNITLOGD_SEGMENT_PATH"
+	touch "$UNITLOGD_SEEK_PATH"
+	chmod 0650 "$UNITLOGD_SEEK_PATH"
+	chown :users "$UNITLOGD_SEEK_PATH"
+	;;
 "create-kmsg-log")
 	rm -rf "$UNITLOGD_KMSG_PATH" || true
 	touch "$UNITLOGD_KMSG_PATH"
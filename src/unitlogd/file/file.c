@@ -11,10 +11,11 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 static struct flock *FLOCK = NULL;
 static int FD_LOCK = -1;
 
-int unitlogdOpenLog(const char *mode)
+int unitlogdOpenLog(const char *logPath, const char *mode)
 {
+    assert(logPath);
+
     if (!UNITLOGD_LOG_FILE) {
-        const char *logPath = UNITLOGD_LOG_PATH;
         UNITLOGD_LOG_FILE = fopen(logPath, mode);
         if (!UNITLOGD_LOG_FILE) {
             logError(CONSOLE, "src/unitlogd/file/file.c", "unitlogdOpenLog", errno, strerror(errno),
@@ -31,10 +32,9 @@ int unitlogdCloseLog()
     int rv = 0;
 
     if (UNITLOGD_LOG_FILE) {
-        const char *logPath = UNITLOGD_LOG_PATH;
         if ((rv = fclose(UNITLOGD_LOG_FILE)) != 0) {
             logError(CONSOLE, "src/unitlogd/file/file.c", "unitlogdCloseLog", errno,
-                     strerror(errno), "Unable to close the file '%s'", logPath);
+                     strerror(errno), "Unable to close the log file");
         }
         UNITLOGD_LOG_FILE = NULL;
     }
@@ -113,14 +113,14 @@ void logEntry(FILE **file, const char *line)
     fflush(*file);
 }
 
-char *getLogOffset()
+char *getLogOffset(const char *logPath)
 {
     off_t offset = 0;
     char offsetStr[50] = { 0 }, *ret = NULL;
 
     assert(!UNITLOGD_LOG_FILE);
 
-    unitlogdOpenLog("r");
+    unitlogdOpenLog(logPath, "r");
     assert(UNITLOGD_LOG_FILE);
     if (fseeko(UNITLOGD_LOG_FILE, 0, SEEK_END) == -1) {
         logError(CONSOLE, "src/unitlogd/file/file.c", "getLogOffset", errno, strerror(errno),
@@ -262,6 +262,27 @@ out:
     return rv;
 }
 
+/* Complete the partial reads. The end of file is an error (EIO). */
+int preadAll(int fd, void *buffer, size_t size, off_t offset)
+{
+    ssize_t bytes = 0;
+
+    while (size > 0) {
+        if ((bytes = pread(fd, buffer, size, offset)) <= 0) {
+            if (bytes == -1 && errno == EINTR)
+                continue;
+            if (bytes == 0)
+                errno = EIO;
+            return -1;
+        }
+        buffer = (char *)buffer + bytes;
+        size -= bytes;
+        offset += bytes;
+    }
+
+    return 0;
+}
+
 off_t getFileSize(const char *path)
 {
     off_t ret = -1;
@@ -278,6 +299,204 @@ off_t getFileSize(const char *path)
     return ret;
 }
 
+/* LOG SEGMENTS
+
+Each boot writes its own segment file in UNITLOGD_PATH. The name contains the start time and the
+boot id (boot-<start>-<bootId>.log) so the segments are sorted by name.
+The index file is the manifest: for each boot, it contains the start and the stop offset into
+its segment. Removing a boot is unlinking its segment and rewriting the index.
+The boots which have been logged before the segments are still in UNITLOGD_LOG_PATH (legacy log)
+thus their index offsets refer to it. A boot without segment belongs to the legacy log.
+Each segment has its seek file (boot-<start>-<bootId>.seek), see journal.c.
+The segments of the closed boots are replaced by their compressed file
+(boot-<start>-<bootId>.log.z), see compressor.c. The segment path still identifies the boot.
+
+*/
+
+char *getSegmentPath(IndexEntry *startEntry)
+{
+    char *segmentPath = NULL, timeStr[50] = { 0 };
+
+    assert(startEntry);
+    assert(startEntry->start);
+
+    sprintf(timeStr, "%010lu-", *startEntry->start->sec);
+    segmentPath = stringNew(UNITLOGD_PATH);
+    stringAppendStr(&segmentPath, "/" SEGMENT_PREFIX);
+    stringAppendStr(&segmentPath, timeStr);
+    stringAppendStr(&segmentPath, startEntry->bootId);
+    stringAppendStr(&segmentPath, SEGMENT_SUFFIX);
+
+    return segmentPath;
+}
+
+/* Returns the segment path or the legacy log path if the segment doesn't exist */
+char *getBootLogPath(IndexEntry *startEntry)
+{
+    char *segmentPath = getSegmentPath(startEntry), *compressedPath = NULL;
+
+    if (access(segmentPath, F_OK) == -1) {
+        compressedPath = getCompressedPath(segmentPath);
+        if (access(compressedPath, F_OK) == -1)
+            stringSet(&segmentPath, UNITLOGD_LOG_PATH);
+        objectRelease(&compressedPath);
+    }
+
+    return segmentPath;
+}
+
+char *getCompressedPath(const char *segmentPath)
+{
+    char *compressedPath = NULL;
+
+    assert(segmentPath);
+
+    compressedPath = stringNew(segmentPath);
+    stringAppendStr(&compressedPath, COMPRESSED_SUFFIX);
+
+    return compressedPath;
+}
+
+char *getSeekPath(const char *segmentPath)
+{
+    char *seekPath = NULL;
+    size_t len = 0;
+
+    assert(segmentPath);
+    assert(stringEndsWithStr(segmentPath, SEGMENT_SUFFIX));
+
+    len = strlen(segmentPath) - strlen(SEGMENT_SUFFIX);
+    seekPath = calloc(len + strlen(SEEK_SUFFIX) + 1, sizeof(char));
+    assert(seekPath);
+    memcpy(seekPath, segmentPath, len);
+    strcpy(seekPath + len, SEEK_SUFFIX);
+
+    return seekPath;
+}
+
+bool isSegment(const char *logPath)
+{
+    return !stringEquals(logPath, UNITLOGD_LOG_PATH);
+}
+
+static int segmentFilter(const struct dirent *dirent)
+{
+    return stringStartsWithStr(dirent->d_name, SEGMENT_PREFIX) &&
+           (stringEndsWithStr(dirent->d_name, SEGMENT_SUFFIX) ||
+            stringEndsWithStr(dirent->d_name, SEGMENT_SUFFIX COMPRESSED_SUFFIX));
+}
+
+/* Returns the segment paths sorted by start time (the compressed ones included) */
+Array *getSegments()
+{
+    struct dirent **namelist = NULL;
+    int len = 0;
+    Array *segments = arrayNew(objectRelease);
+    char *segmentPath = NULL, *lastPath = NULL;
+
+    if ((len = scandir(UNITLOGD_PATH, &namelist, segmentFilter, alphasort)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/file/file.c", "getSegments", errno,
+                 strerror(errno), "Unable to scan the '%s' directory", UNITLOGD_PATH);
+        return segments;
+    }
+    for (int i = 0; i < len; i++) {
+        segmentPath = stringNew(UNITLOGD_PATH);
+        stringAppendChr(&segmentPath, '/');
+        stringAppendStr(&segmentPath, namelist[i]->d_name);
+        if (stringEndsWithStr(segmentPath, COMPRESSED_SUFFIX))
+            segmentPath[strlen(segmentPath) - strlen(COMPRESSED_SUFFIX)] = '\0';
+        /* The segment and its compressed file exist while it is being replaced */
+        if (lastPath && stringEquals(segmentPath, lastPath))
+            objectRelease(&segmentPath);
+        else
+            arrayAdd(segments, (lastPath = segmentPath));
+        objectRelease(&namelist[i]);
+    }
+    objectRelease(&namelist);
+
+    return segments;
+}
+
+/* Returns the size of the legacy log and the segments (seek files included) */
+off_t getLogSize()
+{
+    off_t size = 0, segmentSize = 0;
+    Array *segments = NULL;
+    int len = 0;
+    char *segmentPath = NULL, *compressedPath = NULL, *seekPath = NULL;
+
+    if ((size = getFileSize(UNITLOGD_LOG_PATH)) == -1)
+        return -1;
+    segments = getSegments();
+    len = segments->size;
+    for (int i = 0; i < len && size != -1; i++) {
+        segmentPath = arrayGet(segments, i);
+        compressedPath = getCompressedPath(segmentPath);
+        if ((segmentSize = getFileSize(access(segmentPath, F_OK) == 0 ? segmentPath :
+                                                                        compressedPath)) == -1)
+            size = -1;
+        else
+            size += segmentSize;
+        seekPath = getSeekPath(segmentPath);
+        if (size != -1 && access(seekPath, F_OK) == 0 &&
+            (segmentSize = getFileSize(seekPath)) != -1)
+            size += segmentSize;
+        objectRelease(&compressedPath);
+        objectRelease(&seekPath);
+    }
+
+    arrayRelease(&segments);
+    return size;
+}
+
+/* Unlink the segment or its compressed file and the seek file */
+int removeSegment(const char *segmentPath)
+{
+    int rv = 0;
+    char *compressedPath = getCompressedPath(segmentPath), *seekPath = getSeekPath(segmentPath);
+    bool removed = false;
+
+    if (unlink(segmentPath) == 0)
+        removed = true;
+    else if (errno != ENOENT)
+        rv = errno;
+    if (unlink(compressedPath) == 0)
+        removed = true;
+    else if (errno != ENOENT)
+        rv = errno;
+    if (rv == 0 && !removed)
+        rv = ENOENT;
+    if (rv != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/file/file.c", "removeSegment", rv, strerror(rv),
+                 "Unable to remove the '%s' segment", segmentPath);
+    }
+    if (unlink(seekPath) == -1 && errno != ENOENT) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/file/file.c", "removeSegment", errno,
+                 strerror(errno), "Unable to remove the '%s' seek file", seekPath);
+    }
+
+    objectRelease(&compressedPath);
+    objectRelease(&seekPath);
+    return rv;
+}
+
+/* Returns the log path of the last boot */
+char *getCurrentLogPath()
+{
+    Array *index = NULL;
+    int maxIdx = -1;
+    char *logPath = NULL;
+
+    if (getIndex(&index, true) == 0 && (maxIdx = getMaxIdx(&index)) != -1)
+        logPath = getBootLogPath(arrayGet(index, maxIdx * 2));
+    else
+        logPath = stringNew(UNITLOGD_LOG_PATH);
+
+    arrayRelease(&index);
+    return logPath;
+}
+
 void writeKmsg(char *line)
 {
     assert(line);
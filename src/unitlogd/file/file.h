@@ -9,19 +9,29 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #ifndef FILE_H
 #define FILE_H
 
-int unitlogdOpenLog(const char *);
+int unitlogdOpenLog(const char *, const char *);
 int unitlogdOpenIndex(const char *);
 int unitlogdOpenKmsg(const char *);
 int unitlogdCloseLog();
 int unitlogdCloseIndex();
 int unitlogdCloseKmsg();
 void logEntry(FILE **, const char *);
-char *getLogOffset();
+char *getLogOffset(const char *);
 bool matchLogLine(bool, IndexEntry *);
 int execUlScript(Array **, const char *);
 int handleLockFile(bool);
 int getLockFileFd();
+int preadAll(int, void *, size_t, off_t);
 off_t getFileSize(const char *);
 void writeKmsg(char *);
+char *getSegmentPath(IndexEntry *);
+char *getBootLogPath(IndexEntry *);
+char *getCompressedPath(const char *);
+char *getSeekPath(const char *);
+bool isSegment(const char *);
+Array *getSegments();
+off_t getLogSize();
+int removeSegment(const char *);
+char *getCurrentLogPath();
 
 #endif // FILE_H
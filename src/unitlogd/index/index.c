@@ -41,27 +41,16 @@ void indexEntryRelease(IndexEntry **indexEntry)
     }
 }
 
-int getIndex(Array **index, bool isIndex)
+static int parseEntries(FILE *fp, Array **index, bool isIndex)
 {
     char *line = NULL, *bootId = NULL;
-    FILE *fp = NULL;
     size_t len = 0;
     int rv = 0, numline = 0;
     Array *values = NULL;
     bool isStartEntry = false;
 
-    if (isIndex) {
-        unitlogdOpenIndex("r");
-        assert(UNITLOGD_INDEX_FILE);
-        fp = UNITLOGD_INDEX_FILE;
-    } else {
-        unitlogdOpenLog("r");
-        assert(UNITLOGD_LOG_FILE);
-        fp = UNITLOGD_LOG_FILE;
-    }
     assert(fp);
-    assert(!(*index));
-    *index = arrayNew(indexEntryRelease);
+
     while (getline(&line, &len, fp) != -1) {
         IndexEntry *indexEntry = NULL;
         off_t offset = 0;
@@ -184,13 +173,97 @@ out:
     arrayRelease(&values);
     objectRelease(&bootId);
     objectRelease(&line);
+    return rv;
+}
+
+/* The segments only contain the boot entries of their boot */
+static int parseJournalEntries(const char *segmentPath, Array **index)
+{
+    int rv = 0, next = 0;
+    JournalReader *reader = NULL;
+    JournalEntry entry = { 0 };
+    IndexEntry *indexEntry = NULL;
+    bool isStartEntry = false;
+    char offsetStr[50] = { 0 };
+
+    if ((reader = journalOpen(segmentPath, 0)) == NULL)
+        return 1;
+    while ((next = journalNext(reader, &entry)) == 1) {
+        if (entry.type != JOURNAL_BOOT_START && entry.type != JOURNAL_BOOT_STOP)
+            continue;
+        if ((entry.type == JOURNAL_BOOT_START) == isStartEntry ||
+            (entry.type == JOURNAL_BOOT_STOP &&
+             (entry.dataLen != strlen(indexEntry->bootId) ||
+              memcmp(entry.data, indexEntry->bootId, entry.dataLen) != 0))) {
+            rv = 1;
+            logError(CONSOLE | SYSTEM, "src/unitlogd/index/index.c", "getIndex", rv,
+                     strerror(rv), "An error has occurred at %ld offset (%s).", reader->offset,
+                     segmentPath);
+            goto out;
+        }
+        isStartEntry = entry.type == JOURNAL_BOOT_START;
+        indexEntry = indexEntryNew(isStartEntry, NULL);
+        indexEntry->bootId = calloc(entry.dataLen + 1, sizeof(char));
+        assert(indexEntry->bootId);
+        memcpy(indexEntry->bootId, entry.data, entry.dataLen);
+        *(isStartEntry ? indexEntry->start : indexEntry->stop)->sec =
+            entry.realtime / NSEC_PER_SEC;
+        sprintf(offsetStr, "%lu", reader->offset);
+        stringSet(isStartEntry ? &indexEntry->startOffset : &indexEntry->stopOffset, offsetStr);
+        arrayAdd(*index, indexEntry);
+    }
+    if (next == -1) {
+        rv = 1;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/index/index.c", "getIndex", rv, strerror(rv),
+                 "The '%s' segment is corrupt at %ld offset", segmentPath,
+                 reader->bufferOffset + reader->pos);
+    }
+
+out:
+    journalReaderRelease(&reader);
+    return rv;
+}
+
+static int parseLogEntries(const char *logPath, Array **index)
+{
+    int rv = 0;
+
+    if (isSegment(logPath))
+        return parseJournalEntries(logPath, index);
+    if (unitlogdOpenLog(logPath, "r") != 0)
+        return 1;
+    assert(UNITLOGD_LOG_FILE);
+    rv = parseEntries(UNITLOGD_LOG_FILE, index, false);
+    unitlogdCloseLog();
+    assert(!UNITLOGD_LOG_FILE);
+
+    return rv;
+}
+
+/* Get the entries from the index or from the log (legacy log and segments) */
+int getIndex(Array **index, bool isIndex)
+{
+    int rv = 0, len = 0;
+    Array *segments = NULL;
+
+    assert(!(*index));
+    *index = arrayNew(indexEntryRelease);
     if (isIndex) {
+        unitlogdOpenIndex("r");
+        assert(UNITLOGD_INDEX_FILE);
+        rv = parseEntries(UNITLOGD_INDEX_FILE, index, true);
         unitlogdCloseIndex();
         assert(!UNITLOGD_INDEX_FILE);
-    } else {
-        unitlogdCloseLog();
-        assert(!UNITLOGD_LOG_FILE);
+        return rv;
     }
+    /* The legacy log contains the oldest boots */
+    rv = parseLogEntries(UNITLOGD_LOG_PATH, index);
+    segments = getSegments();
+    len = segments->size;
+    for (int i = 0; i < len && rv == 0; i++)
+        rv = parseLogEntries(arrayGet(segments, i), index);
+
+    arrayRelease(&segments);
     return rv;
 }
 
@@ -241,20 +314,28 @@ int indexIntegrityCheck()
     Array *index = NULL;
     IndexEntry *indexEntry = NULL;
     bool isStart = false;
-    char *bootId = NULL;
+    char *bootId = NULL, *logPath = NULL;
 
     if ((rv = getIndex(&index, true)) != 0)
         goto out;
     /* For each index entry must be there a log entry according the offset value */
-    unitlogdOpenLog("r");
-    assert(UNITLOGD_LOG_FILE);
     len = index ? index->size : 0;
     for (int i = 0; i < len; i++) {
         isStart = false;
         indexEntry = arrayGet(index, i);
-        if ((i % 2) == 0)
+        if ((i % 2) == 0) {
             isStart = true;
-        if (!matchLogLine(isStart, indexEntry)) {
+            /* The start and the stop entries are in the same log */
+            unitlogdCloseLog();
+            objectRelease(&logPath);
+            logPath = getBootLogPath(indexEntry);
+            if (!isSegment(logPath) && unitlogdOpenLog(logPath, "r") != 0) {
+                rv = 1;
+                goto out;
+            }
+        }
+        if (isSegment(logPath) ? !matchJournalEntry(logPath, isStart, indexEntry) :
+                                 !matchLogLine(isStart, indexEntry)) {
             rv = 1;
             goto out;
         }
@@ -269,18 +350,25 @@ int indexIntegrityCheck()
         bootId = ((IndexEntry *)arrayGet(index, index->size - 1))->bootId;
         /* Populate a new index/log entry */
         indexEntry = indexEntryNew(false, bootId);
-        indexEntry->stopOffset = getLogOffset();
+        /* The daemon could have been killed while it was writing an entry */
+        if (isSegment(logPath) && repairJournal(logPath) != 0) {
+            rv = 1;
+            goto err;
+        }
+        indexEntry->stopOffset = getLogOffset(logPath);
         if (!indexEntry->stopOffset) {
             rv = 1;
             goto err;
         }
         /* Open log and index */
-        unitlogdOpenLog("a");
+        unitlogdOpenLog(logPath, "a");
         assert(UNITLOGD_LOG_FILE);
         unitlogdOpenIndex("a");
         assert(UNITLOGD_INDEX_FILE);
         /* Write the index entry */
-        if (writeEntry(false, indexEntry, true) != 0 || writeEntry(false, indexEntry, false) != 0) {
+        if (writeEntry(false, indexEntry, true) != 0 ||
+            (isSegment(logPath) ? writeJournalBoot(false, indexEntry) :
+                                  writeEntry(false, indexEntry, false)) != 0) {
             rv = 1;
             goto err;
         }
@@ -293,6 +381,7 @@ err:
 
 out:
     arrayRelease(&index);
+    objectRelease(&logPath);
     unitlogdCloseLog();
     assert(!UNITLOGD_LOG_FILE);
     unitlogdCloseIndex();
@@ -300,6 +389,24 @@ out:
     return rv;
 }
 
+/* Rewrite the index (manifest) */
+int writeIndex(Array *index)
+{
+    int rv = 0, len = index ? index->size : 0;
+
+    if ((rv = createIndexFile()) != 0)
+        return rv;
+    if (unitlogdOpenIndex("a") != 0)
+        return 1;
+    assert(UNITLOGD_INDEX_FILE);
+    for (int i = 0; i < len && rv == 0; i++)
+        rv = writeEntry(i % 2 == 0, arrayGet(index, i), true);
+    unitlogdCloseIndex();
+    assert(!UNITLOGD_INDEX_FILE);
+
+    return rv;
+}
+
 int getMaxIdx(Array **index)
 {
     int max = -1;
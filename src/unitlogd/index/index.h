@@ -21,6 +21,7 @@ void indexEntryRelease(IndexEntry **);
 int writeEntry(bool, IndexEntry *, bool);
 int indexIntegrityCheck();
 int getIndex(Array **, bool);
+int writeIndex(Array *);
 int getMaxIdx(Array **);
 void setIndexErr(bool);
 
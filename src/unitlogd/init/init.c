@@ -9,6 +9,7 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #include "../unitlogd_impl.h"
 
 char *BOOT_ID_STR;
+char *SEGMENT_PATH;
 FILE *UNITLOGD_KMSG_FILE;
 
 char *getBootIdStr()
@@ -41,17 +42,36 @@ int createKmsgLog()
     return rv;
 }
 
+int createSegment(const char *segmentPath)
+{
+    int rv = 0;
+    char *seekPath = getSeekPath(segmentPath);
+
+    Array *envVars = arrayNew(objectRelease);
+    addEnvVar(&envVars, "PATH", PATH_ENV_VAR);
+    addEnvVar(&envVars, "UNITLOGD_SEGMENT_PATH", segmentPath);
+    addEnvVar(&envVars, "UNITLOGD_SEEK_PATH", seekPath);
+    arrayAdd(envVars, NULL);
+    rv = execUlScript(&envVars, "create-segment");
+
+    arrayRelease(&envVars);
+    objectRelease(&seekPath);
+    return rv;
+}
+
 void appendKmsg()
 {
     char *line = NULL;
     size_t len = 0;
+    LogLine *logLine = logLineNew();
 
     unitlogdOpenKmsg("r");
     assert(UNITLOGD_KMSG_FILE);
     while (getline(&line, &len, UNITLOGD_KMSG_FILE) != -1)
-        processLine(line);
+        processLine(logLine, line);
 
     objectRelease(&line);
+    logLineRelease(&logLine);
     unitlogdCloseKmsg();
     assert(!UNITLOGD_KMSG_FILE);
 }
@@ -70,7 +90,6 @@ int unitlogdInit()
 {
     int rv = 0;
     IndexEntry *indexStartEntry = NULL;
-    char *logOffset = NULL;
 
     /**
      * Index integrity check. If it fails then exit.
@@ -83,15 +102,13 @@ int unitlogdInit()
         goto out;
     }
     BOOT_ID_STR = getBootIdStr();
-    logOffset = getLogOffset();
-    if (!logOffset) {
-        rv = 1;
-        goto out;
-    }
-    /* Creating the index start entry */
+    /* Creating the index start entry and the boot segment */
     indexStartEntry = indexEntryNew(true, BOOT_ID_STR);
-    indexStartEntry->startOffset = logOffset;
-    if (unitlogdOpenLog("a") != 0 || unitlogdOpenIndex("a") != 0) {
+    indexStartEntry->startOffset = stringNew("0");
+    SEGMENT_PATH = getSegmentPath(indexStartEntry);
+    if ((rv = createSegment(SEGMENT_PATH)) != 0)
+        goto out;
+    if (unitlogdOpenLog(SEGMENT_PATH, "a") != 0 || unitlogdOpenIndex("a") != 0) {
         rv = 1;
         goto out;
     }
@@ -99,10 +116,12 @@ int unitlogdInit()
     assert(UNITLOGD_INDEX_FILE);
     /* Write the "start" index entry */
     if (writeEntry(true, indexStartEntry, true) != 0 ||
-        writeEntry(true, indexStartEntry, false) != 0) {
+        writeJournalBoot(true, indexStartEntry) != 0) {
         rv = 1;
         goto out;
     }
+    /* From now on, the log lines are written by the writer thread */
+    rv = startWriter();
 
 out:
     unitlogdCloseLog();
@@ -110,6 +129,9 @@ out:
     assert(!UNITLOGD_LOG_FILE);
     assert(!UNITLOGD_INDEX_FILE);
     indexEntryRelease(&indexStartEntry);
+    /* The previous boots are compressed in background */
+    if (rv == 0)
+        rv = startCompressor();
     return rv;
 }
 
@@ -121,7 +143,10 @@ int unitlogdShutdown()
 
     assert(!UNITLOGD_LOG_FILE);
     assert(!UNITLOGD_INDEX_FILE);
-    logOffset = getLogOffset();
+    stopCompressor();
+    /* Write the queued lines before the stop entry */
+    stopWriter();
+    logOffset = getLogOffset(SEGMENT_PATH);
     if (!logOffset) {
         rv = 1;
         goto out;
@@ -129,7 +154,7 @@ int unitlogdShutdown()
     /* Creating the index stop entry */
     indexStopEntry = indexEntryNew(false, BOOT_ID_STR);
     indexStopEntry->stopOffset = logOffset;
-    if (unitlogdOpenLog("a") != 0 || unitlogdOpenIndex("a") != 0) {
+    if (unitlogdOpenLog(SEGMENT_PATH, "a") != 0 || unitlogdOpenIndex("a") != 0) {
         rv = 1;
         goto out;
     }
@@ -137,7 +162,7 @@ int unitlogdShutdown()
     assert(UNITLOGD_INDEX_FILE);
     /* Write the "stop" index entry */
     rv = writeEntry(false, indexStopEntry, true);
-    rv = writeEntry(false, indexStopEntry, false);
+    rv = writeJournalBoot(false, indexStopEntry);
 
 out:
     unitlogdCloseLog();
@@ -23,6 +23,7 @@ void assertMacros();
 int unitlogdInit();
 int unitlogdShutdown();
 int createKmsgLog();
+int createSegment(const char *);
 void appendKmsg();
 
 #endif // INIT_H
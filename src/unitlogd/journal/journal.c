@@ -0,0 +1,724 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitlogd_impl.h"
+
+/* JOURNAL
+
+The segments contain binary entries. Each entry starts with a fixed header (JournalHeader) which
+contains the entry size, a crc32 checksum of the rest of the entry, the type, the priority, the
+facility, the pid, the realtime and monotonic timestamps in nanoseconds and the host name id.
+The header is followed by the ident and the data.
+The log entries contain the message, the boot entries (start/stop) contain the boot id and the
+host entries contain the host name. A host entry is written before the first log entry of an host
+name id in a segment, so the log entries only contain the id.
+The segment is the log of a boot thus the boot id is only written into the boot entries.
+The readers stop at the first incomplete or corrupt entry.
+The entries are rendered as text (with colors) only by unitlogctl.
+
+The entries written by the writer are grouped in blocks of JOURNAL_BLOCK_ENTRIES entries or
+JOURNAL_BLOCK_BYTES bytes. A block starts with an host entry, so a reader can start from it
+knowing the host name. When a block is closed, its summary (JournalBlock) is appended to the seek
+file of the segment: the realtime range of its entries, the offset and the size, the priority
+range, the facilities bitset and the bloom filters of the idents and the pids.
+The realtime clock can step backwards (e.g. a time synchronization), so the writer flags the
+blocks from the first entry older than a previous one (JOURNAL_BLOCK_UNSORTED). If the last block
+is not flagged, the blocks are sorted by time and a time is found by a binary search of the seek
+file, otherwise all the blocks are scanned. The blocks which cannot match the time range or the
+filters are skipped without reading them.
+The readers read the compressed segments as the plain ones (see compressor.c).
+
+*/
+
+static uint32_t CRC_TABLE[256];
+static pthread_once_t CRC_ONCE = PTHREAD_ONCE_INIT;
+
+static void initCrcTable()
+{
+    uint32_t crc = 0;
+
+    for (uint32_t i = 0; i < 256; i++) {
+        crc = i;
+        for (int k = 0; k < 8; k++)
+            crc = crc & 1 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+        CRC_TABLE[i] = crc;
+    }
+}
+
+uint32_t journalCrc(uint32_t crc, const void *data, size_t len)
+{
+    const unsigned char *bytes = data;
+
+    pthread_once(&CRC_ONCE, initCrcTable);
+    crc = ~crc;
+    while (len--)
+        crc = CRC_TABLE[(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+uint32_t getHostId(const char *hostName)
+{
+    assert(hostName);
+
+    return journalCrc(0, hostName, strlen(hostName));
+}
+
+size_t getJournalEntrySize(JournalEntry *entry)
+{
+    return sizeof(JournalHeader) + entry->identLen + entry->dataLen;
+}
+
+/* The buffer must contain at least getJournalEntrySize() bytes */
+size_t journalEncode(char *buffer, JournalEntry *entry)
+{
+    JournalHeader header = { 0 };
+    size_t size = getJournalEntrySize(entry);
+
+    assert(buffer);
+    assert(entry->identLen <= JOURNAL_IDENT_MAX);
+    assert(size <= JOURNAL_ENTRY_MAX);
+
+    header.size = size;
+    header.type = entry->type;
+    header.priority = entry->priority;
+    header.facility = entry->facility;
+    header.identLen = entry->identLen;
+    header.pid = entry->pid;
+    header.realtime = entry->realtime;
+    header.monotonic = entry->monotonic;
+    header.hostId = entry->hostId;
+    header.dataLen = entry->dataLen;
+    memcpy(buffer, &header, sizeof(JournalHeader));
+    if (entry->identLen > 0)
+        memcpy(buffer + sizeof(JournalHeader), entry->ident, entry->identLen);
+    if (entry->dataLen > 0)
+        memcpy(buffer + sizeof(JournalHeader) + entry->identLen, entry->data, entry->dataLen);
+    /* The checksum covers the entry from the type field */
+    header.crc = journalCrc(0, buffer + offsetof(JournalHeader, type),
+                            size - offsetof(JournalHeader, type));
+    memcpy(buffer + offsetof(JournalHeader, crc), &header.crc, sizeof(uint32_t));
+
+    return size;
+}
+
+/* Returns the entry size, 0 if the buffer doesn't contain the whole entry or -1 if it is corrupt.
+ * The entry ident and data point into the buffer.
+*/
+int journalDecode(const char *buffer, size_t len, JournalEntry *entry)
+{
+    JournalHeader header = { 0 };
+
+    if (len < sizeof(JournalHeader))
+        return 0;
+    memcpy(&header, buffer, sizeof(JournalHeader));
+    if (header.size < sizeof(JournalHeader) || header.size > JOURNAL_ENTRY_MAX ||
+        header.size != sizeof(JournalHeader) + header.identLen + header.dataLen ||
+        header.type > JOURNAL_HOST)
+        return -1;
+    if (len < header.size)
+        return 0;
+    if (journalCrc(0, buffer + offsetof(JournalHeader, type),
+                   header.size - offsetof(JournalHeader, type)) != header.crc)
+        return -1;
+    entry->type = header.type;
+    entry->priority = header.priority;
+    entry->facility = header.facility;
+    entry->pid = header.pid;
+    entry->realtime = header.realtime;
+    entry->monotonic = header.monotonic;
+    entry->hostId = header.hostId;
+    entry->identLen = header.identLen;
+    entry->ident = buffer + sizeof(JournalHeader);
+    entry->dataLen = header.dataLen;
+    entry->data = entry->ident + header.identLen;
+
+    return header.size;
+}
+
+static void journalHostRelease(JournalHost **journalHost)
+{
+    if (*journalHost) {
+        objectRelease(&(*journalHost)->name);
+        objectRelease(journalHost);
+    }
+}
+
+static JournalReader *journalReaderNew(int fd, off_t offset)
+{
+    JournalReader *reader = calloc(1, sizeof(JournalReader));
+    assert(reader);
+    reader->fd = fd;
+    reader->size = JOURNAL_READ_SIZE;
+    reader->buffer = calloc(reader->size, sizeof(char));
+    assert(reader->buffer);
+    reader->bufferOffset = reader->offset = offset;
+    reader->hosts = arrayNew(journalHostRelease);
+    reader->second = -1;
+    reader->frameIdx = -1;
+
+    return reader;
+}
+
+void journalReaderRelease(JournalReader **reader)
+{
+    if (*reader) {
+        close((*reader)->fd);
+        objectRelease(&(*reader)->buffer);
+        arrayRelease(&(*reader)->hosts);
+        objectRelease(&(*reader)->frames);
+        objectRelease(&(*reader)->frame);
+        objectRelease(&(*reader)->compressed);
+        objectRelease(reader);
+    }
+}
+
+/* The frames must be contiguous from the segment beginning */
+static int readJournalFrames(JournalReader *reader, const char *compressedPath)
+{
+    JournalFramesHeader header = { 0 };
+    JournalFrame *frame = NULL;
+    uint64_t offset = 0;
+
+    if (preadAll(reader->fd, &header, sizeof(JournalFramesHeader), 0) != 0 ||
+        header.magic != JOURNAL_FRAMES_MAGIC)
+        goto err;
+    reader->frames = calloc(header.numFrames + 1, sizeof(JournalFrame));
+    assert(reader->frames);
+    reader->numFrames = header.numFrames;
+    if (preadAll(reader->fd, reader->frames, header.numFrames * sizeof(JournalFrame),
+                 sizeof(JournalFramesHeader)) != 0)
+        goto err;
+    for (int i = 0; i < reader->numFrames; i++) {
+        frame = &reader->frames[i];
+        if (frame->offset != offset || frame->size == 0 ||
+            frame->size > JOURNAL_FRAME_SIZE + JOURNAL_ENTRY_MAX ||
+            frame->compressedSize > compressBound(frame->size))
+            goto err;
+        offset += frame->size;
+    }
+
+    return 0;
+
+err:
+    logErrorStr(CONSOLE, "The '%s' compressed segment is corrupt!\n", compressedPath);
+    return -1;
+}
+
+/* Open the segment or, if it has been compressed, its compressed file */
+JournalReader *journalOpen(const char *segmentPath, off_t offset)
+{
+    int fd = -1;
+    char *compressedPath = NULL;
+    JournalReader *reader = NULL;
+
+    assert(segmentPath);
+
+    if ((fd = open(segmentPath, O_RDONLY | O_CLOEXEC)) != -1)
+        return journalReaderNew(fd, offset);
+    compressedPath = getCompressedPath(segmentPath);
+    if ((fd = open(compressedPath, O_RDONLY | O_CLOEXEC)) == -1) {
+        logError(CONSOLE, "src/unitlogd/journal/journal.c", "journalOpen", errno,
+                 strerror(errno), "Unable to open the '%s' segment", segmentPath);
+        goto out;
+    }
+    reader = journalReaderNew(fd, offset);
+    if (readJournalFrames(reader, compressedPath) != 0)
+        journalReaderRelease(&reader);
+
+out:
+    objectRelease(&compressedPath);
+    return reader;
+}
+
+static int loadJournalFrame(JournalReader *reader, int idx)
+{
+    JournalFrame *frame = &reader->frames[idx];
+    uLongf len = frame->size;
+
+    if (reader->frameIdx == idx)
+        return 0;
+    if (frame->size > reader->frameSize) {
+        reader->frameSize = frame->size;
+        reader->frame = realloc(reader->frame, reader->frameSize);
+        assert(reader->frame);
+    }
+    if (frame->compressedSize > reader->compressedSize) {
+        reader->compressedSize = frame->compressedSize;
+        reader->compressed = realloc(reader->compressed, reader->compressedSize);
+        assert(reader->compressed);
+    }
+    reader->frameIdx = -1;
+    if (preadAll(reader->fd, reader->compressed, frame->compressedSize, frame->fileOffset) != 0)
+        return -1;
+    if (uncompress((Bytef *)reader->frame, &len, (Bytef *)reader->compressed,
+                   frame->compressedSize) != Z_OK ||
+        len != frame->size) {
+        errno = EIO;
+        return -1;
+    }
+    reader->frameIdx = idx;
+
+    return 0;
+}
+
+/* Read the segment bytes from the offset like pread().
+ * A compressed segment is read from the frame which contains the offset, so only the frames
+ * which are read are decompressed.
+*/
+static ssize_t journalRead(JournalReader *reader, char *buffer, size_t size, off_t offset)
+{
+    int low = 0, high = reader->numFrames, mid = 0;
+    JournalFrame *frame = NULL;
+
+    if (!reader->frames)
+        return pread(reader->fd, buffer, size, offset);
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if ((off_t)reader->frames[mid].offset <= offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return 0;
+    frame = &reader->frames[low - 1];
+    if (offset >= (off_t)(frame->offset + frame->size))
+        return 0;
+    if (loadJournalFrame(reader, low - 1) != 0)
+        return -1;
+    if (size > frame->offset + frame->size - offset)
+        size = frame->offset + frame->size - offset;
+    memcpy(buffer, reader->frame + (offset - frame->offset), size);
+
+    return size;
+}
+
+static void addJournalHost(JournalReader *reader, JournalEntry *entry)
+{
+    JournalHost *journalHost = NULL;
+    int len = reader->hosts->size;
+
+    for (int i = 0; i < len; i++) {
+        journalHost = arrayGet(reader->hosts, i);
+        if (journalHost->id == entry->hostId)
+            return;
+    }
+    journalHost = calloc(1, sizeof(JournalHost));
+    assert(journalHost);
+    journalHost->id = entry->hostId;
+    journalHost->name = calloc(entry->dataLen + 1, sizeof(char));
+    assert(journalHost->name);
+    memcpy(journalHost->name, entry->data, entry->dataLen);
+    arrayAdd(reader->hosts, journalHost);
+}
+
+const char *getJournalHost(JournalReader *reader, uint32_t hostId)
+{
+    JournalHost *journalHost = NULL;
+    int len = reader->hosts->size;
+
+    for (int i = 0; i < len; i++) {
+        journalHost = arrayGet(reader->hosts, i);
+        if (journalHost->id == hostId)
+            return journalHost->name;
+    }
+
+    return NULL;
+}
+
+/* Returns 1 if an entry has been read, 0 at the end of the journal (the last entry could be
+ * still being written) or -1 if the entry is corrupt.
+ * The entry offset is in reader->offset. The entry is valid until the next call.
+*/
+int journalNext(JournalReader *reader, JournalEntry *entry)
+{
+    JournalHeader header = { 0 };
+    size_t remaining = 0;
+    ssize_t bytes = 0;
+    int size = 0;
+
+    while ((size = journalDecode(reader->buffer + reader->pos, reader->len - reader->pos,
+                                 entry)) == 0) {
+        /* Move the incomplete entry at the beginning of the buffer and read the next bytes */
+        remaining = reader->len - reader->pos;
+        memmove(reader->buffer, reader->buffer + reader->pos, remaining);
+        reader->bufferOffset += reader->pos;
+        reader->pos = 0;
+        reader->len = remaining;
+        if (remaining >= sizeof(JournalHeader)) {
+            memcpy(&header, reader->buffer, sizeof(JournalHeader));
+            if (header.size > reader->size) {
+                reader->size = header.size;
+                reader->buffer = realloc(reader->buffer, reader->size);
+                assert(reader->buffer);
+            }
+        }
+        if ((bytes = journalRead(reader, reader->buffer + reader->len, reader->size - reader->len,
+                                 reader->bufferOffset + reader->len)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE, "src/unitlogd/journal/journal.c", "journalNext", errno,
+                     strerror(errno), "Unable to read the journal");
+            return -1;
+        }
+        if (bytes == 0)
+            return 0;
+        reader->len += bytes;
+    }
+    if (size == -1) {
+        if (DEBUG)
+            logWarning(CONSOLE, "Corrupt journal entry at %ld offset\n",
+                       reader->bufferOffset + reader->pos);
+        return -1;
+    }
+    reader->offset = reader->bufferOffset + reader->pos;
+    reader->pos += size;
+    if (entry->type == JOURNAL_HOST)
+        addJournalHost(reader, entry);
+
+    return 1;
+}
+
+void journalRender(JournalReader *reader, JournalEntry *entry, FILE *out)
+{
+    const char *color = NULL, *hostName = NULL;
+    time_t second = entry->realtime / NSEC_PER_SEC;
+    struct tm tmTime = { 0 };
+
+    if (entry->type != JOURNAL_LOG)
+        return;
+    /* The time stamp only changes once per second */
+    if (second != reader->second) {
+        localtime_r(&second, &tmTime);
+        strftime(reader->timeStamp, sizeof(reader->timeStamp), "%d %b %Y %H:%M:%S", &tmTime);
+        reader->second = second;
+    }
+    if (entry->priority == LOG_ERR)
+        color = RED_COLOR;
+    else if (entry->priority <= LOG_WARNING)
+        color = YELLOW_COLOR;
+    hostName = getJournalHost(reader, entry->hostId);
+    fprintf(out, "%s%s %s", color ? color : "", reader->timeStamp, hostName ? hostName : "-");
+    if (entry->identLen > 0) {
+        fprintf(out, " %.*s", (int)entry->identLen, entry->ident);
+        if (entry->pid > 0)
+            fprintf(out, "[%d]", entry->pid);
+        fputc(':', out);
+    }
+    fprintf(out, " %.*s%s\n", (int)entry->dataLen, entry->data, color ? DEFAULT_COLOR : "");
+}
+
+/* Write the boot start or stop entry into the segment (UNITLOGD_LOG_FILE) */
+int writeJournalBoot(bool isStarting, IndexEntry *indexEntry)
+{
+    int rv = 0;
+    JournalEntry entry = { 0 };
+    struct timespec now = { 0 };
+    char *buffer = NULL;
+    size_t size = 0;
+
+    assert(UNITLOGD_LOG_FILE);
+    assert(indexEntry);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    entry.type = isStarting ? JOURNAL_BOOT_START : JOURNAL_BOOT_STOP;
+    entry.priority = LOG_INFO;
+    entry.realtime = *(isStarting ? indexEntry->start : indexEntry->stop)->sec * NSEC_PER_SEC;
+    entry.monotonic = now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+    entry.data = indexEntry->bootId;
+    entry.dataLen = strlen(indexEntry->bootId);
+    buffer = calloc(getJournalEntrySize(&entry), sizeof(char));
+    assert(buffer);
+    size = journalEncode(buffer, &entry);
+    if (fwrite(buffer, 1, size, UNITLOGD_LOG_FILE) != size || fflush(UNITLOGD_LOG_FILE) != 0) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/journal/journal.c", "writeJournalBoot", errno,
+                 strerror(errno), "Unable to write the boot entry");
+    }
+
+    objectRelease(&buffer);
+    return rv;
+}
+
+bool matchJournalEntry(const char *segmentPath, bool isStart, IndexEntry *indexEntry)
+{
+    bool match = false;
+    JournalReader *reader = NULL;
+    JournalEntry entry = { 0 };
+    char *offsetStr = NULL;
+
+    assert(segmentPath);
+    assert(indexEntry);
+
+    offsetStr = isStart ? indexEntry->startOffset : indexEntry->stopOffset;
+    assert(offsetStr);
+    if ((reader = journalOpen(segmentPath, atol(offsetStr))) == NULL)
+        return false;
+    if (journalNext(reader, &entry) == 1 &&
+        entry.type == (isStart ? JOURNAL_BOOT_START : JOURNAL_BOOT_STOP) &&
+        entry.dataLen == strlen(indexEntry->bootId) &&
+        memcmp(entry.data, indexEntry->bootId, entry.dataLen) == 0)
+        match = true;
+    else {
+        logError(CONSOLE, "src/unitlogd/journal/journal.c", "matchJournalEntry", 1, strerror(1),
+                 "The index row with %s offset doesn't match any entry of the '%s' segment",
+                 offsetStr, segmentPath);
+    }
+
+    journalReaderRelease(&reader);
+    return match;
+}
+
+static int readBlocks(int fd, off_t idx, JournalBlock *blocks, int len)
+{
+    if (preadAll(fd, blocks, len * sizeof(JournalBlock), idx * sizeof(JournalBlock)) != 0) {
+        logError(CONSOLE, "src/unitlogd/journal/journal.c", "readBlocks", errno, strerror(errno),
+                 "Unable to read the block %ld", idx);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Remove the blocks beyond the segment end */
+static int repairSeeks(const char *segmentPath, off_t end)
+{
+    int rv = 0, fd = -1;
+    char *seekPath = getSeekPath(segmentPath);
+    struct stat st = { 0 };
+    off_t len = 0;
+    JournalBlock block = { 0 };
+
+    if ((fd = open(seekPath, O_RDWR | O_CLOEXEC)) == -1 || fstat(fd, &st) == -1)
+        goto out;
+    len = st.st_size / sizeof(JournalBlock);
+    while (len > 0 && readBlocks(fd, len - 1, &block, 1) == 0 &&
+           (off_t)(block.offset + block.size) > end)
+        len--;
+    if (len * (off_t)sizeof(JournalBlock) < st.st_size &&
+        ftruncate(fd, len * sizeof(JournalBlock)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/journal/journal.c", "repairSeeks", rv,
+                 strerror(rv), "Unable to truncate the '%s' seek file", seekPath);
+    }
+
+out:
+    if (fd != -1)
+        close(fd);
+    objectRelease(&seekPath);
+    return rv;
+}
+
+/* Truncate the segment after the last valid entry (i.e. an entry partially written) */
+int repairJournal(const char *segmentPath)
+{
+    int rv = 0, fd = -1;
+    JournalReader *reader = NULL;
+    JournalEntry entry = { 0 };
+    off_t end = 0, size = 0;
+
+    assert(segmentPath);
+
+    if ((fd = open(segmentPath, O_RDWR | O_CLOEXEC)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/journal/journal.c", "repairJournal", rv,
+                 strerror(rv), "Unable to open the '%s' segment", segmentPath);
+        return rv;
+    }
+    reader = journalReaderNew(fd, 0);
+    while (journalNext(reader, &entry) == 1)
+        ;
+    end = reader->bufferOffset + reader->pos;
+    if ((size = lseek(fd, 0, SEEK_END)) > end) {
+        logWarning(CONSOLE | SYSTEM, "Truncating the '%s' segment from %ld to %ld bytes\n",
+                   segmentPath, size, end);
+        if (ftruncate(fd, end) == -1) {
+            rv = errno;
+            logError(CONSOLE | SYSTEM, "src/unitlogd/journal/journal.c", "repairJournal", rv,
+                     strerror(rv), "Unable to truncate the '%s' segment", segmentPath);
+        }
+    }
+    if (rv == 0)
+        rv = repairSeeks(segmentPath, end);
+
+    journalReaderRelease(&reader);
+    return rv;
+}
+
+void journalReaderSeek(JournalReader *reader, off_t offset)
+{
+    reader->bufferOffset = reader->offset = offset;
+    reader->len = reader->pos = 0;
+}
+
+void journalBlockInit(JournalBlock *block, uint64_t realtime, off_t offset)
+{
+    memset(block, 0, sizeof(JournalBlock));
+    block->minRealtime = block->maxRealtime = realtime;
+    block->offset = offset;
+    block->minPriority = LOG_DEBUG;
+    block->maxPriority = LOG_EMERG;
+}
+
+uint32_t getIdentHash(const char *ident, size_t len)
+{
+    return journalCrc(0, ident, len);
+}
+
+uint32_t getPidHash(pid_t pid)
+{
+    return journalCrc(0, &pid, sizeof(pid_t));
+}
+
+/* Two bits for each hash */
+static void setJournalBloom(uint64_t *bloom, uint32_t hash)
+{
+    for (int i = 0; i < 2; i++, hash >>= 16)
+        bloom[(hash % JOURNAL_BLOOM_BITS) / 64] |= 1ULL << (hash % 64);
+}
+
+bool testJournalBloom(const uint64_t *bloom, uint32_t hash)
+{
+    for (int i = 0; i < 2; i++, hash >>= 16) {
+        if (!(bloom[(hash % JOURNAL_BLOOM_BITS) / 64] & (1ULL << (hash % 64))))
+            return false;
+    }
+
+    return true;
+}
+
+void journalBlockAdd(JournalBlock *block, JournalEntry *entry)
+{
+    if (entry->realtime < block->minRealtime)
+        block->minRealtime = entry->realtime;
+    if (entry->realtime > block->maxRealtime)
+        block->maxRealtime = entry->realtime;
+    if (entry->priority < block->minPriority)
+        block->minPriority = entry->priority;
+    if (entry->priority > block->maxPriority)
+        block->maxPriority = entry->priority;
+    if (entry->facility < 32)
+        block->facilities |= 1U << entry->facility;
+    if (entry->identLen > 0)
+        setJournalBloom(block->idents, getIdentHash(entry->ident, entry->identLen));
+    if (entry->pid > 0)
+        setJournalBloom(block->pids, getPidHash(entry->pid));
+}
+
+/* Returns 0 and the last block of the segment or -1 if it has not blocks */
+int getLastJournalBlock(const char *segmentPath, JournalBlock *block)
+{
+    int rv = -1, fd = -1;
+    char *seekPath = getSeekPath(segmentPath);
+    struct stat st = { 0 };
+    off_t len = 0;
+
+    if ((fd = open(seekPath, O_RDONLY | O_CLOEXEC)) == -1 || fstat(fd, &st) == -1)
+        goto out;
+    if ((len = st.st_size / sizeof(JournalBlock)) > 0)
+        rv = readBlocks(fd, len - 1, block, 1);
+
+out:
+    if (fd != -1)
+        close(fd);
+    objectRelease(&seekPath);
+    return rv;
+}
+
+/* Returns the blocks from the last one which starts before the realtime (0 = all the blocks)
+ * or NULL if the segment has not the seek file.
+ * If the segment is not in time order, all the blocks are returned.
+*/
+JournalBlock *getJournalBlocks(const char *segmentPath, uint64_t realtime, int *len)
+{
+    int fd = -1;
+    char *seekPath = NULL;
+    struct stat st = { 0 };
+    off_t low = 0, high = 0, mid = 0;
+    JournalBlock *blocks = NULL, block = { 0 };
+
+    assert(segmentPath);
+
+    *len = 0;
+    seekPath = getSeekPath(segmentPath);
+    if ((fd = open(seekPath, O_RDONLY | O_CLOEXEC)) == -1 || fstat(fd, &st) == -1)
+        goto out;
+    high = st.st_size / sizeof(JournalBlock);
+    /* The flag of the last block covers the whole segment */
+    if (realtime > 0 && high > 0) {
+        if (readBlocks(fd, high - 1, &block, 1) != 0)
+            goto out;
+        if (block.flags & JOURNAL_BLOCK_UNSORTED)
+            realtime = 0;
+    }
+    /* Find the first block after the realtime */
+    while (realtime > 0 && low < high) {
+        mid = low + (high - low) / 2;
+        if (readBlocks(fd, mid, &block, 1) != 0)
+            goto out;
+        if (block.minRealtime <= realtime)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low > 0)
+        low--;
+    high = st.st_size / sizeof(JournalBlock);
+    blocks = calloc(high - low + 1, sizeof(JournalBlock));
+    assert(blocks);
+    if (readBlocks(fd, low, blocks, high - low) != 0) {
+        objectRelease(&blocks);
+        goto out;
+    }
+    *len = high - low;
+    if (DEBUG)
+        logInfo(CONSOLE, "Seek file = %s, First block = %ld, Blocks = %d\n", seekPath, low, *len);
+
+out:
+    if (fd != -1)
+        close(fd);
+    objectRelease(&seekPath);
+    return blocks;
+}
+
+static const char *PRIORITY_NAMES[] = { "emerg", "alert",  "crit", "err",
+                                        "warn",  "notice", "info", "debug" };
+
+static const char *FACILITY_NAMES[] = {
+    "kern",   "user",   "mail",     "daemon", "auth",   "syslog", "lpr",    "news",
+    "uucp",   "cron",   "authpriv", "ftp",    NULL,     NULL,     NULL,     NULL,
+    "local0", "local1", "local2",   "local3", "local4", "local5", "local6", "local7",
+};
+
+/* The name or the value */
+int getPriorityByName(const char *name)
+{
+    int len = sizeof(PRIORITY_NAMES) / sizeof(PRIORITY_NAMES[0]);
+
+    if (isValidNumber(name, true))
+        return atoi(name) < len ? atoi(name) : -1;
+    for (int i = 0; i < len; i++) {
+        if (stringEquals(name, PRIORITY_NAMES[i]))
+            return i;
+    }
+
+    return -1;
+}
+
+int getFacilityByName(const char *name)
+{
+    int len = sizeof(FACILITY_NAMES) / sizeof(FACILITY_NAMES[0]);
+
+    for (int i = 0; i < len; i++) {
+        if (FACILITY_NAMES[i] && stringEquals(name, FACILITY_NAMES[i]))
+            return i;
+    }
+
+    return -1;
+}
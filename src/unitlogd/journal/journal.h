@@ -0,0 +1,146 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#define JOURNAL_ENTRY_MAX 1048576
+#define JOURNAL_READ_SIZE 65536
+#define JOURNAL_IDENT_MAX 255
+#define JOURNAL_BLOCK_ENTRIES 1024
+#define JOURNAL_BLOCK_BYTES 65536
+#define JOURNAL_BLOOM_WORDS 4
+#define JOURNAL_BLOOM_BITS (JOURNAL_BLOOM_WORDS * 64)
+#define JOURNAL_FRAME_SIZE 262144
+#define JOURNAL_FRAMES_MAGIC 0x315A4A55
+#define NSEC_PER_SEC 1000000000ULL
+/* The segment is not in time order up to the block (i.e. the clock stepped backwards) */
+#define JOURNAL_BLOCK_UNSORTED 0x01
+
+typedef enum {
+    JOURNAL_LOG = 0,
+    JOURNAL_BOOT_START = 1,
+    JOURNAL_BOOT_STOP = 2,
+    JOURNAL_HOST = 3
+} JournalType;
+
+/* The entry header on disk (host byte order).
+ * It is followed by the ident and by the data (message, boot id or host name).
+*/
+typedef struct __attribute__((packed)) {
+    uint32_t size;
+    uint32_t crc;
+    uint8_t type;
+    uint8_t priority;
+    uint8_t facility;
+    uint8_t identLen;
+    uint32_t pid;
+    uint64_t realtime;
+    uint64_t monotonic;
+    uint32_t hostId;
+    uint32_t dataLen;
+} JournalHeader;
+
+typedef struct {
+    JournalType type;
+    int priority;
+    int facility;
+    pid_t pid;
+    uint64_t realtime;
+    uint64_t monotonic;
+    uint32_t hostId;
+    const char *ident;
+    size_t identLen;
+    const char *data;
+    size_t dataLen;
+} JournalEntry;
+
+/* The block summary on disk (see the seek file).
+ * The realtime range is the one of the block entries.
+ * The idents and the pids are bloom filters of their hashes.
+ * The fields are aligned, so the struct has not padding.
+*/
+typedef struct {
+    uint64_t minRealtime;
+    uint64_t maxRealtime;
+    uint64_t offset;
+    uint64_t idents[JOURNAL_BLOOM_WORDS];
+    uint64_t pids[JOURNAL_BLOOM_WORDS];
+    uint32_t size;
+    uint32_t facilities;
+    uint8_t minPriority;
+    uint8_t maxPriority;
+    uint8_t flags;
+    uint8_t reserved[5];
+} JournalBlock;
+
+/* The frame table of a compressed segment on disk (see compressor.c).
+ * The offset and the size refer to the segment, the file offset to the compressed file.
+*/
+typedef struct {
+    uint32_t magic;
+    uint32_t numFrames;
+} JournalFramesHeader;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t fileOffset;
+    uint32_t size;
+    uint32_t compressedSize;
+} JournalFrame;
+
+typedef struct {
+    uint32_t id;
+    char *name;
+} JournalHost;
+
+typedef struct {
+    int fd;
+    char *buffer;
+    size_t size;
+    size_t len;
+    size_t pos;
+    off_t bufferOffset;
+    off_t offset;
+    Array *hosts;
+    time_t second;
+    char timeStamp[32];
+    JournalFrame *frames;
+    int numFrames;
+    int frameIdx;
+    char *frame;
+    size_t frameSize;
+    char *compressed;
+    size_t compressedSize;
+} JournalReader;
+
+uint32_t journalCrc(uint32_t, const void *, size_t);
+uint32_t getHostId(const char *);
+size_t getJournalEntrySize(JournalEntry *);
+size_t journalEncode(char *, JournalEntry *);
+int journalDecode(const char *, size_t, JournalEntry *);
+JournalReader *journalOpen(const char *, off_t);
+void journalReaderRelease(JournalReader **);
+int journalNext(JournalReader *, JournalEntry *);
+const char *getJournalHost(JournalReader *, uint32_t);
+void journalRender(JournalReader *, JournalEntry *, FILE *);
+int writeJournalBoot(bool, IndexEntry *);
+bool matchJournalEntry(const char *, bool, IndexEntry *);
+int repairJournal(const char *);
+void journalReaderSeek(JournalReader *, off_t);
+void journalBlockInit(JournalBlock *, uint64_t, off_t);
+void journalBlockAdd(JournalBlock *, JournalEntry *);
+uint32_t getIdentHash(const char *, size_t);
+uint32_t getPidHash(pid_t);
+bool testJournalBloom(const uint64_t *, uint32_t);
+int getLastJournalBlock(const char *, JournalBlock *);
+JournalBlock *getJournalBlocks(const char *, uint64_t, int *);
+int getPriorityByName(const char *);
+int getFacilityByName(const char *);
+
+#endif // JOURNAL_H
@@ -8,35 +8,24 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 
 #include "../unitlogd_impl.h"
 
-static Code PRIORITYNAMES[] = {
-    { "alert", LOG_ALERT },     { "crit", LOG_CRIT },
-    { "debug", LOG_DEBUG },     { "emerg", LOG_EMERG },
-    { "err", LOG_ERR },         { "error", LOG_ERR }, /* DEPRECATED */
-    { "info", LOG_INFO },       { "none", INTERNAL_NOPRI }, /* INTERNAL */
-    { "notice", LOG_NOTICE },   { "panic", LOG_EMERG }, /* DEPRECATED */
-    { "warn", LOG_WARNING }, /* DEPRECATED */
-    { "warning", LOG_WARNING }, { NULL, -1 }
-};
-
-static Code FACILITYNAMES[] = {
-    { "auth", LOG_AUTH },      { "authpriv", LOG_AUTHPRIV },
-    { "cron", LOG_CRON },      { "daemon", LOG_DAEMON },
-    { "ftp", LOG_FTP },        { "kern", LOG_KERN },
-    { "lpr", LOG_LPR },        { "mail", LOG_MAIL },
-    { "mark", INTERNAL_MARK }, /* INTERNAL */
-    { "news", LOG_NEWS },      { "security", LOG_AUTH }, /* DEPRECATED */
-    { "syslog", LOG_SYSLOG },  { "user", LOG_USER },
-    { "uucp", LOG_UUCP },      { "local0", LOG_LOCAL0 },
-    { "local1", LOG_LOCAL1 },  { "local2", LOG_LOCAL2 },
-    { "local3", LOG_LOCAL3 },  { "local4", LOG_LOCAL4 },
-    { "local5", LOG_LOCAL5 },  { "local6", LOG_LOCAL6 },
-    { "local7", LOG_LOCAL7 },  { NULL, -1 }
-};
+/* LOG LINE
+
+A log line is parsed into a journal entry (see journal.c): the priority and the facility, the
+ident and the pid (ident[pid]:) and the message. The syslog time stamp is skipped because the
+entry has its own realtime and monotonic timestamps. The kernel lines have "kernel" as ident.
+Each thread owns a LogLine which caches the host name for the current second, so processing a
+log line doesn't allocate. The entry is encoded into the writer buffer (see writer.c).
+
+*/
 
 LogLine *logLineNew()
 {
     LogLine *logLine = calloc(1, sizeof(LogLine));
     assert(logLine);
+    logLine->second = -1;
+    logLine->lineSize = LOG_LINE_SIZE;
+    logLine->line = calloc(logLine->lineSize, sizeof(char));
+    assert(logLine->line);
 
     return logLine;
 }
@@ -44,133 +33,193 @@ LogLine *logLineNew()
 void logLineRelease(LogLine **logLine)
 {
     if (*logLine) {
-        objectRelease(&(*logLine)->pri);
-        objectRelease(&(*logLine)->fac);
-        objectRelease(&(*logLine)->hostName);
-        objectRelease(&(*logLine)->timeStamp);
+        objectRelease(&(*logLine)->line);
         objectRelease(logLine);
     }
 }
 
-static int setFacAndPri(char *buffer, LogLine **logLine)
+/* The host name is only checked once per second */
+static void setHostName(LogLine *logLine, time_t now)
 {
-    int rv = 0, startIdx, endIdx, value = 0;
-    char *valueStr = NULL;
-    Code *fac, *pri;
-
-    assert(*logLine);
-
-    startIdx = stringIndexOfChr(buffer, '<');
-    endIdx = stringIndexOfChr(buffer, '>');
-    if (startIdx != -1 && endIdx != -1) {
-        valueStr = stringSub(buffer, startIdx + 1, endIdx - 1);
-        value = atoi(valueStr);
-        for (fac = FACILITYNAMES; fac->name && !(fac->val == LOG_FAC(value) << 3); fac++)
-            ;
-        for (pri = PRIORITYNAMES; pri->name && !(pri->val == LOG_PRI(value)); pri++)
-            ;
-        if (fac && fac->name)
-            (*logLine)->fac = stringNew(fac->name);
-        if (pri && pri->name)
-            (*logLine)->pri = stringNew(pri->name);
-    }
+    char hostName[HOST_NAME_MAX + 1] = { 0 };
 
-    objectRelease(&valueStr);
-    return rv;
+    if (now == logLine->second)
+        return;
+    logLine->second = now;
+    gethostname(hostName, HOST_NAME_MAX);
+    assert(strlen(hostName) > 0);
+    if (!stringEquals(hostName, logLine->hostName)) {
+        strcpy(logLine->hostName, hostName);
+        logLine->hostId = getHostId(hostName);
+    }
 }
 
-static void setHostName(LogLine **logLine)
+static bool isTimeStamp(const char *str)
 {
-    char hostName[1000] = { 0 };
+    /* Mmm dd hh:mm:ss */
+    return strlen(str) >= 15 && str[3] == ' ' && str[6] == ' ' && str[9] == ':' &&
+           str[12] == ':';
+}
 
-    assert(*logLine);
+static void parseLogLine(char *buffer, LogLine *logLine)
+{
+    JournalEntry *entry = &logLine->entry;
+    char *ptr = buffer, *end = NULL;
+    int value = 0;
+    long pid = 0;
+    size_t maxLen = 0;
+
+    entry->type = JOURNAL_LOG;
+    entry->priority = LOG_INFO;
+    entry->facility = LOG_FAC(LOG_USER);
+    entry->pid = 0;
+    entry->ident = NULL;
+    entry->identLen = 0;
+    /* Priority and facility */
+    if (*ptr == '<' && (end = strchr(ptr, '>'))) {
+        value = atoi(ptr + 1);
+        entry->priority = LOG_PRI(value);
+        entry->facility = LOG_FAC(value);
+        ptr = end + 1;
+    }
+    if (entry->facility == LOG_FAC(LOG_KERN)) {
+        /* Skip the kernel time stamp ([    0.000000]) */
+        if ((end = strchr(ptr, ']')))
+            ptr = end + 1;
+        entry->ident = "kernel";
+        entry->identLen = strlen(entry->ident);
+    } else {
+        if (isTimeStamp(ptr))
+            ptr += 15;
+        while (isspace(*ptr))
+            ptr++;
+        /* Ident and pid */
+        end = ptr + strcspn(ptr, "[: ");
+        if (end > ptr && end - ptr <= JOURNAL_IDENT_MAX && (*end == '[' || *end == ':')) {
+            entry->ident = ptr;
+            entry->identLen = end - ptr;
+            if (*end == '[') {
+                pid = strtol(end + 1, &end, 10);
+                if (*end == ']')
+                    end++;
+            }
+            if (*end == ':') {
+                entry->pid = pid > 0 && pid <= INT_MAX ? pid : 0;
+                ptr = end + 1;
+            } else {
+                /* Not a tag */
+                entry->ident = NULL;
+                entry->identLen = 0;
+            }
+        }
+    }
+    while (isspace(*ptr))
+        ptr++;
+    entry->data = ptr;
+    entry->dataLen = strlen(ptr);
+    maxLen = JOURNAL_ENTRY_MAX - sizeof(JournalHeader) - entry->identLen;
+    if (entry->dataLen > maxLen)
+        entry->dataLen = maxLen;
+}
 
-    gethostname(hostName, 1000);
-    assert(strlen(hostName) > 0);
-    (*logLine)->hostName = stringNew(hostName);
+static void setLineSize(LogLine *logLine, size_t size)
+{
+    if (size > logLine->lineSize) {
+        logLine->lineSize = size;
+        logLine->line = realloc(logLine->line, size);
+        assert(logLine->line);
+    }
 }
 
-static void writeLogLine(char *buffer, LogLine **logLine)
+/* The writer is not running (kernel forwarder only) thus we append the entry to the log of the
+ * current boot by ourselves.
+*/
+static void appendEntry(LogLine *logLine)
 {
-    char *line = NULL, *other = NULL;
-    bool error = false, warn = false;
-    int idx = 19;
-
-    assert(*logLine);
-
-    /* Evaluating the priority */
-    if (stringStartsWithStr((*logLine)->pri, "err"))
-        error = true;
-    else if (stringStartsWithStr((*logLine)->pri, "warn") ||
-             stringStartsWithStr((*logLine)->pri, "crit") ||
-             stringStartsWithStr((*logLine)->pri, "alert") ||
-             stringStartsWithStr((*logLine)->pri, "emerg"))
-        warn = true;
-    /* Building the log line */
-    if (error)
-        line = stringNew(RED_COLOR);
-    else if (warn)
-        line = stringNew(YELLOW_COLOR);
-    if (!line)
-        line = stringNew((*logLine)->timeStamp);
-    else
-        stringAppendStr(&line, (*logLine)->timeStamp);
-    stringAppendStr(&line, " ");
-    stringAppendStr(&line, (*logLine)->hostName);
-    /* Evaluating Kernel facility */
-    if (stringStartsWithStr((*logLine)->fac, "kern")) {
-        stringAppendStr(&line, " kernel:");
-        idx = stringIndexOfChr(buffer, ']') + 1;
+    static char *logPath = NULL;
+    static uint32_t appendedHostId = 0;
+    static bool hostAppended = false;
+    JournalEntry *entry = &logLine->entry, hostEntry = { 0 };
+    time_t second = entry->realtime / NSEC_PER_SEC;
+    struct tm tmTime = { 0 };
+    size_t len = 0;
+
+    if (!logPath)
+        logPath = SEGMENT_PATH ? stringNew(SEGMENT_PATH) : getCurrentLogPath();
+    if (isSegment(logPath)) {
+        setLineSize(logLine, 2 * sizeof(JournalHeader) + strlen(logLine->hostName) +
+                                 entry->identLen + entry->dataLen);
+        if (!hostAppended || appendedHostId != entry->hostId) {
+            hostEntry.type = JOURNAL_HOST;
+            hostEntry.realtime = entry->realtime;
+            hostEntry.monotonic = entry->monotonic;
+            hostEntry.hostId = entry->hostId;
+            hostEntry.data = logLine->hostName;
+            hostEntry.dataLen = strlen(logLine->hostName);
+            len = journalEncode(logLine->line, &hostEntry);
+            appendedHostId = entry->hostId;
+            hostAppended = true;
+        }
+        len += journalEncode(logLine->line + len, entry);
+    } else {
+        /* The legacy log is a text file */
+        setLineSize(logLine, 64 + strlen(logLine->hostName) + entry->identLen + entry->dataLen);
+        localtime_r(&second, &tmTime);
+        len = strftime(logLine->line, logLine->lineSize, "%d %b %Y %H:%M:%S", &tmTime);
+        len += sprintf(logLine->line + len, " %s", logLine->hostName);
+        if (entry->identLen > 0) {
+            len += sprintf(logLine->line + len, " %.*s", (int)entry->identLen, entry->ident);
+            if (entry->pid > 0)
+                len += sprintf(logLine->line + len, "[%d]", entry->pid);
+            logLine->line[len++] = ':';
+        }
+        len += sprintf(logLine->line + len, " %.*s\n", (int)entry->dataLen, entry->data);
     }
-    /* Buffer remaining */
-    other = stringSub(buffer, idx, strlen(buffer) - 1);
-    assert(other);
-    stringLtrim(other, NULL);
-    stringAppendStr(&line, " ");
-    stringAppendStr(&line, other);
-    /* Reset color */
-    if (error || warn)
-        stringAppendStr(&line, DEFAULT_COLOR);
-    /* Adding new line */
-    if (!stringEndsWithStr(line, NEW_LINE))
-        stringAppendStr(&line, NEW_LINE);
-    if (DEBUG)
-        logInfo(CONSOLE, "Log line: \n%s\n", line);
-    /* Open file and write the log line */
-    unitlogdOpenLog("a");
+    unitlogdOpenLog(logPath, "a");
     assert(UNITLOGD_LOG_FILE);
-    logEntry(&UNITLOGD_LOG_FILE, line);
-
+    if (fwrite(logLine->line, 1, len, UNITLOGD_LOG_FILE) != len) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/logline/logline.c", "appendEntry", errno,
+                 strerror(errno), "Unable to write into the '%s' file", logPath);
+    }
     unitlogdCloseLog();
     assert(!UNITLOGD_LOG_FILE);
-    objectRelease(&other);
-    objectRelease(&line);
 }
 
-int processLine(char *buffer)
+int processLine(LogLine *logLine, char *buffer)
 {
     int rv = 0;
-    LogLine *logLine = logLineNew();
+    size_t len = 0;
+    struct timespec now = { 0 };
+    JournalEntry *entry = NULL;
 
+    assert(logLine);
     assert(buffer);
 
-    /* When we call this function from appendKmsg() func, the buffer already contains new line char at the end.
-     * In warning or error case, we'll have a double new line char which is bad.
-     * For this reason, we always remove this char making easier its management in writeLogLine func.
+    entry = &logLine->entry;
+    /* When we call this function from appendKmsg() func, the buffer contains new line char at
+     * the end. The entries don't contain it.
     */
-    if (stringEndsWithStr(buffer, NEW_LINE))
-        buffer[strlen(buffer) - 1] = '\0';
-    setFacAndPri(buffer, &logLine);
-    setHostName(&logLine);
-    logLine->timeStamp = stringGetTimeStamp(NULL, false, "%d %b %Y %H:%M:%S");
+    if ((len = strlen(buffer)) > 0 && buffer[len - 1] == '\n')
+        buffer[len - 1] = '\0';
+    parseLogLine(buffer, logLine);
+    clock_gettime(CLOCK_REALTIME, &now);
+    entry->realtime = now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+    setHostName(logLine, now.tv_sec);
+    entry->hostId = logLine->hostId;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    entry->monotonic = now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
     if (DEBUG) {
-        logInfo(CONSOLE, "\nFacility = %s\n", logLine->fac);
-        logInfo(CONSOLE, "Priority = %s\n", logLine->pri);
-        logInfo(CONSOLE, "hostName = %s\n", logLine->hostName);
-        logInfo(CONSOLE, "Time stamp = %s\n", logLine->timeStamp);
+        logInfo(CONSOLE, "\nFacility = %d\n", entry->facility);
+        logInfo(CONSOLE, "Priority = %d\n", entry->priority);
+        logInfo(CONSOLE, "Ident = %.*s\n", (int)entry->identLen, entry->ident ? entry->ident : "");
+        logInfo(CONSOLE, "Pid = %d\n", entry->pid);
+        logInfo(CONSOLE, "Message = %.*s\n", (int)entry->dataLen, entry->data);
     }
-    writeLogLine(buffer, &logLine);
+    /* Hand the entry over to the writer thread or, if it is not running, write it
+     * into the log of the current boot.
+    */
+    if (!queueJournalEntry(entry, logLine->hostName))
+        appendEntry(logLine);
 
-    logLineRelease(&logLine);
     return rv;
 }
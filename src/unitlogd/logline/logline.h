@@ -9,23 +9,23 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #ifndef LOGLINE_H
 #define LOGLINE_H
 
-#define INTERNAL_NOPRI 0x10 /* the "no priority" priority */
-#define INTERNAL_MARK LOG_MAKEPRI(LOG_NFACILITIES, 0) /* mark "facility" */
-
-typedef struct {
-    char *name;
-    int val;
-} Code;
+#define LOG_LINE_SIZE 20480
 
+/* The log line context of a thread.
+ * It contains the journal entry of the current line, the host name (checked once per second)
+ * and the buffer where the entries are encoded when the writer is not running.
+*/
 typedef struct {
-    char *pri;
-    char *fac;
-    char *hostName;
-    char *timeStamp;
+    JournalEntry entry;
+    time_t second;
+    char hostName[HOST_NAME_MAX + 1];
+    uint32_t hostId;
+    char *line;
+    size_t lineSize;
 } LogLine;
 
 LogLine *logLineNew();
 void logLineRelease(LogLine **);
-int processLine(char *);
+int processLine(LogLine *, char *);
 
 #endif // LOGLINE_H
@@ -179,19 +179,36 @@ out:
     pthread_exit(0);
 }
 
+/* The datagrams are received in batches into preallocated slots by recvmmsg().
+ * The slots and the log line context are reused for the thread lifetime.
+*/
 void *startUnixThread(void *arg)
 {
-    int rv = 0, socketFd = -1, maxFd = -1, pipeFd = -1, input, length = 0, bufferSize;
+    int rv = 0, socketFd = -1, maxFd = -1, pipeFd = -1, input, length = 0, received = 0;
     SocketThread *socketThread = (SocketThread *)arg;
     Pipe *socketPipe = NULL;
     pthread_mutex_t *mutexPipe = NULL;
     const char *devName = NULL;
     fd_set fds;
-    char *buffer = NULL;
+    char *buffers = NULL, *buffer = NULL;
     struct sockaddr_un sa = { 0 };
+    struct mmsghdr msgs[RECV_BATCH_SIZE];
+    struct iovec iovs[RECV_BATCH_SIZE];
+    LogLine *logLine = logLineNew();
 
     assert(socketThread);
 
+    /* Prepare the slots */
+    buffers = calloc(RECV_BATCH_SIZE, BUFFER_SIZE + 1);
+    assert(buffers);
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < RECV_BATCH_SIZE; i++) {
+        iovs[i].iov_base = buffers + i * (BUFFER_SIZE + 1);
+        iovs[i].iov_len = BUFFER_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
     socketPipe = socketThread->pipe;
     mutexPipe = socketPipe->mutex;
     devName = socketThread->devName;
@@ -236,36 +253,29 @@ void *startUnixThread(void *arg)
             if (input == THREAD_EXIT)
                 goto out;
         } else if (FD_ISSET(socketFd, &fds)) {
-            /* Prepare the buffer */
-            bufferSize = BUFFER_SIZE;
-            buffer = calloc(bufferSize, sizeof(char));
-            assert(buffer);
-            if ((rv = uRecv(socketFd, buffer, bufferSize, 0)) == -1) {
+            if ((received = recvmmsg(socketFd, msgs, RECV_BATCH_SIZE, MSG_DONTWAIT, NULL)) ==
+                -1) {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
                 logError(CONSOLE, "src/unitlogd/socket/socket.c", "startUnixThread", errno,
                          strerror(errno), "Unable to read from socket for the dev (%s)!", devName);
                 kill(UNITLOGD_PID, SIGTERM);
                 goto out;
             }
-            /* Lock
-             * We cannot write into log if the unitlogctl is cutting it!
-             * See vacuum func.
+            /* Process the buffers.
+             * The writer thread writes the lines (see writer.c).
             */
-            if ((rv = handleLockFile(true)) != 0) {
-                kill(UNITLOGD_PID, SIGTERM);
-                goto out;
-            }
-            /* Process buffer and release */
-            processLine(buffer);
-            objectRelease(&buffer);
-            /* UnLock */
-            if ((rv = handleLockFile(false)) != 0) {
-                kill(UNITLOGD_PID, SIGTERM);
-                goto out;
+            for (int i = 0; i < received; i++) {
+                buffer = iovs[i].iov_base;
+                buffer[msgs[i].msg_len] = '\0';
+                processLine(logLine, buffer);
             }
         }
     }
 
 out:
+    objectRelease(&buffers);
+    logLineRelease(&logLine);
     close(socketFd);
     unlink(devName);
     if ((rv = pthread_mutex_unlock(mutexPipe)) != 0) {
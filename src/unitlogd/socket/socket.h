@@ -7,6 +7,7 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 */
 
 #define BUFFER_SIZE 16384
+#define RECV_BATCH_SIZE 32
 
 SocketThread *socketThreadNew();
 void socketThreadRelease(SocketThread **);
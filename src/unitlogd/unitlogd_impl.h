@@ -10,12 +10,16 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #define UNITLOGD_IMPL_H
 
 #include "../core/unitd_impl.h"
+#include <zlib.h>
 #include "init/init.h"
 #include "signals/signals.h"
 #include "socket/socket.h"
 #include "index/index.h"
 #include "file/file.h"
+#include "journal/journal.h"
 #include "logline/logline.h"
+#include "writer/writer.h"
+#include "compressor/compressor.h"
 #include "client/client.h"
 
 #define BOOT_ID_SIZE 20
@@ -24,6 +28,10 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #define ENTRY_FINISHED "Finished"
 #define TOKEN_ENTRY " | "
 #define NEW_LINE "\n"
+#define SEGMENT_PREFIX "boot-"
+#define SEGMENT_SUFFIX ".log"
+#define SEEK_SUFFIX ".seek"
+#define COMPRESSED_SUFFIX ".z"
 
 extern bool DEBUG;
 extern int SELF_PIPE[2];
@@ -32,6 +40,7 @@ extern FILE *UNITLOGD_INDEX_FILE;
 extern FILE *UNITLOGD_LOG_FILE;
 extern FILE *UNITLOGD_KMSG_FILE;
 extern char *BOOT_ID_STR;
+extern char *SEGMENT_PATH;
 extern bool UNITLOGD_EXIT;
 
 #endif // UNITLOGD_IMPL_H
@@ -0,0 +1,542 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../unitlogd_impl.h"
+
+/* WRITER
+
+The descriptor of the boot log segment is opened once and kept open for the daemon lifetime.
+The socket thread only encodes the journal entries into the writer buffer.
+The writer thread swaps the writer buffer with its own one and writes all the entries at once
+(group commit). The buffers are reused thus they only grow when a batch exceeds their size.
+Before writing, the writer waits WRITER_FLUSH_INTERVAL milliseconds to collect more lines unless
+the buffer is full.
+
+The daemon owns the log, so the write path doesn't lock anything.
+The maintenance operations (vacuum) are coordinated by the control socket (UNITLOGD_CTL_NAME).
+unitlogctl takes the lock file, connects and sends WRITER_SUSPEND. The control thread waits for
+the running write, suspends the writer and acknowledges. The log lines are buffered meanwhile.
+When unitlogctl closes the connection (even if it crashes), the writer reopens the log file,
+which could have been replaced, and resumes. If the daemon is exiting while the writer is
+suspended, the writer waits for the maintenance end by the lock file before writing.
+According to the sync policy, fsync() is never called, always called or only called when a line
+with error (or a more severe) priority has been written.
+The queue tracks the segment offset of the entries and the summary of the current block
+(see journal.c). The closed blocks are appended to the seek file after their entries.
+From the first entry older than a previous one, the blocks are flagged as unsorted.
+
+*/
+
+int WRITER_FLUSH_INTERVAL = 0;
+WriterSync WRITER_SYNC = SYNC_ERROR;
+/* The benchmark (tests/bench_logline.c) uses its own control socket */
+const char *WRITER_CTL_PATH = UNITLOGD_CTL_NAME;
+static const char *WRITER_SYNC_NAMES[] = { "never", "error", "always", NULL };
+static char *WRITER_BUFFER, *FLUSH_BUFFER;
+static size_t WRITER_BUFFER_LEN, WRITER_BUFFER_SIZE, FLUSH_BUFFER_SIZE;
+static bool WRITER_SYNC_PENDING;
+static bool WRITER_STARTED;
+static bool WRITER_EXIT;
+static bool WRITER_SUSPENDED;
+static bool WRITER_BUSY;
+static bool WRITER_REOPEN;
+static bool WRITER_HOST_WRITTEN;
+static uint32_t WRITER_HOST_ID;
+static off_t WRITER_OFFSET;
+static JournalBlock WRITER_BLOCK;
+static int WRITER_BLOCK_ENTRIES;
+static uint64_t WRITER_MAX_REALTIME;
+static bool WRITER_UNSORTED;
+static JournalBlock *WRITER_BLOCKS, *FLUSH_BLOCKS;
+static size_t WRITER_BLOCKS_LEN, WRITER_BLOCKS_SIZE, FLUSH_BLOCKS_SIZE;
+static char *SEEK_PATH;
+static int LOG_FD = -1;
+static int SEEK_FD = -1;
+static int CTL_FD = -1;
+static int CTL_PIPE[2] = { -1, -1 };
+static pthread_t WRITER_THREAD;
+static pthread_t CTL_THREAD;
+static pthread_mutex_t WRITER_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t WRITER_CV = PTHREAD_COND_INITIALIZER;
+
+int getWriterSync(const char *name)
+{
+    for (int i = 0; WRITER_SYNC_NAMES[i]; i++) {
+        if (stringEquals(name, WRITER_SYNC_NAMES[i]))
+            return i;
+    }
+
+    return -1;
+}
+
+static int openLogFd()
+{
+    if ((LOG_FD = open(SEGMENT_PATH, O_WRONLY | O_APPEND | O_CLOEXEC)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "openLogFd", errno,
+                 strerror(errno), "Unable to open the '%s' file", SEGMENT_PATH);
+        return -1;
+    }
+    if ((SEEK_FD = open(SEEK_PATH, O_WRONLY | O_APPEND | O_CLOEXEC)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "openLogFd", errno,
+                 strerror(errno), "Unable to open the '%s' file", SEEK_PATH);
+        close(LOG_FD);
+        LOG_FD = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void closeLogFd()
+{
+    close(LOG_FD);
+    close(SEEK_FD);
+    LOG_FD = SEEK_FD = -1;
+}
+
+/* The maintenance could have replaced the log file thus we have to reopen it */
+static int reopenLogFd()
+{
+    if (DEBUG)
+        logInfo(SYSTEM, "Maintenance done, reopening the log file ...");
+    closeLogFd();
+
+    return openLogFd();
+}
+
+static int writeAll(int fd, const char *buffer, size_t len, const char *path)
+{
+    ssize_t written = 0;
+
+    /* Complete the partial writes */
+    while (len > 0) {
+        if ((written = write(fd, buffer, len)) == -1) {
+            if (errno == EINTR)
+                continue;
+            logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "writeAll", errno,
+                     strerror(errno), "Unable to write into the '%s' file", path);
+            return -1;
+        }
+        buffer += written;
+        len -= written;
+    }
+
+    return 0;
+}
+
+static int writeLines(const char *buffer, size_t len, bool sync)
+{
+    if (writeAll(LOG_FD, buffer, len, SEGMENT_PATH) != 0)
+        return -1;
+    if (sync && fsync(LOG_FD) == -1) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "writeLines", errno,
+                 strerror(errno), "Unable to sync the '%s' file", SEGMENT_PATH);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Wait for the flush interval unless the queue is full or we are exiting.
+ * The caller must own the writer mutex.
+*/
+static void waitFlushInterval()
+{
+    struct timespec timeout = { 0 };
+
+    clock_gettime(CLOCK_REALTIME, &timeout);
+    timeout.tv_sec += WRITER_FLUSH_INTERVAL / 1000;
+    timeout.tv_nsec += (long)(WRITER_FLUSH_INTERVAL % 1000) * 1000000;
+    if (timeout.tv_nsec >= 1000000000) {
+        timeout.tv_sec++;
+        timeout.tv_nsec -= 1000000000;
+    }
+    while (!WRITER_EXIT && WRITER_BUFFER_LEN < WRITER_BUFFER_MAX) {
+        if (pthread_cond_timedwait(&WRITER_CV, &WRITER_MUTEX, &timeout) == ETIMEDOUT)
+            break;
+    }
+}
+
+static void *startWriterThread(void *arg UNUSED)
+{
+    char *buffer = NULL;
+    JournalBlock *blocks = NULL;
+    size_t len = 0, size = 0, blocksLen = 0;
+    bool sync = false, reopen = false, maintenance = false;
+    int rv = 0;
+
+    pthread_mutex_lock(&WRITER_MUTEX);
+    while (true) {
+        while ((WRITER_BUFFER_LEN == 0 || WRITER_SUSPENDED) && !WRITER_EXIT)
+            pthread_cond_wait(&WRITER_CV, &WRITER_MUTEX);
+        if (WRITER_BUFFER_LEN == 0 && WRITER_BLOCKS_LEN == 0)
+            break;
+        if (WRITER_FLUSH_INTERVAL > 0 && !WRITER_EXIT) {
+            waitFlushInterval();
+            /* The writer could have been suspended meanwhile */
+            if (WRITER_SUSPENDED && !WRITER_EXIT)
+                continue;
+        }
+        /* Take all the queued lines swapping the buffers */
+        buffer = WRITER_BUFFER;
+        len = WRITER_BUFFER_LEN;
+        size = WRITER_BUFFER_SIZE;
+        WRITER_BUFFER = FLUSH_BUFFER;
+        WRITER_BUFFER_SIZE = FLUSH_BUFFER_SIZE;
+        WRITER_BUFFER_LEN = 0;
+        FLUSH_BUFFER = buffer;
+        FLUSH_BUFFER_SIZE = size;
+        blocks = WRITER_BLOCKS;
+        blocksLen = WRITER_BLOCKS_LEN;
+        size = WRITER_BLOCKS_SIZE;
+        WRITER_BLOCKS = FLUSH_BLOCKS;
+        WRITER_BLOCKS_SIZE = FLUSH_BLOCKS_SIZE;
+        WRITER_BLOCKS_LEN = 0;
+        FLUSH_BLOCKS = blocks;
+        FLUSH_BLOCKS_SIZE = size;
+        sync = WRITER_SYNC == SYNC_ALWAYS || WRITER_SYNC_PENDING;
+        WRITER_SYNC_PENDING = false;
+        maintenance = WRITER_SUSPENDED;
+        reopen = WRITER_REOPEN || maintenance;
+        WRITER_REOPEN = false;
+        WRITER_BUSY = true;
+        pthread_mutex_unlock(&WRITER_MUTEX);
+        /* Lock
+         * We are exiting while the unitlogctl is cutting the log, so wait for it.
+         * See vacuum func.
+        */
+        if (maintenance && (rv = handleLockFile(true)) != 0)
+            maintenance = false;
+        if (rv == 0 && (!reopen || (rv = reopenLogFd()) == 0))
+            rv = writeLines(buffer, len, sync);
+        /* The blocks never refer to entries which have not been written */
+        if (rv == 0 && blocksLen > 0) {
+            rv = writeAll(SEEK_FD, (const char *)blocks, blocksLen * sizeof(JournalBlock),
+                          SEEK_PATH);
+        }
+        if (maintenance && handleLockFile(false) != 0)
+            rv = 1;
+        if (rv != 0 && !UNITLOGD_EXIT)
+            kill(UNITLOGD_PID, SIGTERM);
+        pthread_mutex_lock(&WRITER_MUTEX);
+        WRITER_BUSY = false;
+        pthread_cond_broadcast(&WRITER_CV);
+    }
+    pthread_mutex_unlock(&WRITER_MUTEX);
+
+    pthread_exit(0);
+}
+
+static void suspendWriter(bool suspend)
+{
+    pthread_mutex_lock(&WRITER_MUTEX);
+    WRITER_SUSPENDED = suspend;
+    if (suspend) {
+        /* Wait for the running write */
+        while (WRITER_BUSY)
+            pthread_cond_wait(&WRITER_CV, &WRITER_MUTEX);
+    } else {
+        WRITER_REOPEN = true;
+        pthread_cond_broadcast(&WRITER_CV);
+    }
+    pthread_mutex_unlock(&WRITER_MUTEX);
+}
+
+/* Returns true if the control pipe or the fd is ready to read */
+static bool waitControlFd(int fd, bool *exit)
+{
+    fd_set fds;
+    int maxFd = (fd > CTL_PIPE[0] ? fd : CTL_PIPE[0]) + 1;
+
+    while (true) {
+        FD_ZERO(&fds);
+        FD_SET(CTL_PIPE[0], &fds);
+        FD_SET(fd, &fds);
+        if (select(maxFd, &fds, NULL, NULL, NULL) == -1) {
+            if (errno == EINTR)
+                continue;
+            *exit = true;
+            return false;
+        }
+        if (FD_ISSET(CTL_PIPE[0], &fds)) {
+            *exit = true;
+            return false;
+        }
+        return true;
+    }
+}
+
+static void *startControlThread(void *arg UNUSED)
+{
+    int clientFd = -1;
+    char request = 0;
+    bool exit = false;
+    struct ucred ucred = { 0 };
+    socklen_t len = sizeof(struct ucred);
+
+    while (!exit && waitControlFd(CTL_FD, &exit)) {
+        if ((clientFd = accept4(CTL_FD, NULL, NULL, SOCK_CLOEXEC)) == -1)
+            continue;
+        /* Only the administrator can suspend the writer */
+        len = sizeof(struct ucred);
+        if (getsockopt(clientFd, SOL_SOCKET, SO_PEERCRED, &ucred, &len) == -1 ||
+            ucred.uid != 0) {
+            logWarning(SYSTEM, "Unitlogd control request denied (uid = %d)", ucred.uid);
+            close(clientFd);
+            continue;
+        }
+        if (waitControlFd(clientFd, &exit) && uRead(clientFd, &request, 1) == 1 &&
+            request == WRITER_SUSPEND) {
+            suspendWriter(true);
+            if (DEBUG)
+                logInfo(SYSTEM, "Writer suspended for maintenance");
+            if (uWrite(clientFd, &request, 1) == 1) {
+                /* The maintenance ends when the client closes the connection */
+                while (waitControlFd(clientFd, &exit) && uRead(clientFd, &request, 1) > 0)
+                    ;
+            }
+            /* If we are exiting, the writer waits for the maintenance end (lock file) */
+            if (!exit)
+                suspendWriter(false);
+        }
+        close(clientFd);
+    }
+
+    pthread_exit(0);
+}
+
+static int startControl()
+{
+    int rv = 0;
+    struct sockaddr_un sa = { 0 };
+
+    if (pipe2(CTL_PIPE, O_CLOEXEC) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "startControl", rv,
+                 strerror(rv), "Unable to create the control pipe");
+        return rv;
+    }
+    sa.sun_family = AF_UNIX;
+    strncpy(sa.sun_path, WRITER_CTL_PATH, sizeof(sa.sun_path) - 1);
+    unlink(WRITER_CTL_PATH);
+    if ((CTL_FD = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1 ||
+        bind(CTL_FD, (const struct sockaddr *)&sa, sizeof(struct sockaddr_un)) == -1 ||
+        chmod(WRITER_CTL_PATH, S_IRUSR | S_IWUSR) == -1 || listen(CTL_FD, 1) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "startControl", rv,
+                 strerror(rv), "Unable to create the '%s' control socket", WRITER_CTL_PATH);
+        return rv;
+    }
+    if ((rv = pthread_create(&CTL_THREAD, NULL, startControlThread, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "startControl", rv,
+                 strerror(rv), "Unable to create the control thread");
+    }
+
+    return rv;
+}
+
+static void releaseControl()
+{
+    close(CTL_FD);
+    close(CTL_PIPE[0]);
+    close(CTL_PIPE[1]);
+    CTL_FD = CTL_PIPE[0] = CTL_PIPE[1] = -1;
+    unlink(WRITER_CTL_PATH);
+}
+
+static void stopControl()
+{
+    int rv = 0, output = THREAD_EXIT;
+
+    if (uWrite(CTL_PIPE[1], &output, sizeof(int)) == -1) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "stopControl", errno,
+                 strerror(errno), "Unable to write into the control pipe");
+    } else if ((rv = pthread_join(CTL_THREAD, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "stopControl", rv,
+                 strerror(rv), "Unable to join the control thread");
+    }
+    releaseControl();
+}
+
+static void releaseBuffers()
+{
+    objectRelease(&WRITER_BUFFER);
+    objectRelease(&FLUSH_BUFFER);
+    WRITER_BUFFER_LEN = WRITER_BUFFER_SIZE = FLUSH_BUFFER_SIZE = 0;
+    objectRelease(&WRITER_BLOCKS);
+    objectRelease(&FLUSH_BLOCKS);
+    WRITER_BLOCKS_LEN = WRITER_BLOCKS_SIZE = FLUSH_BLOCKS_SIZE = 0;
+    objectRelease(&SEEK_PATH);
+}
+
+/* Adds the current block to the writer blocks.
+ * The caller must own the writer mutex.
+*/
+static void closeBlock()
+{
+    if (WRITER_BLOCKS_LEN == WRITER_BLOCKS_SIZE) {
+        WRITER_BLOCKS_SIZE *= 2;
+        WRITER_BLOCKS = realloc(WRITER_BLOCKS, WRITER_BLOCKS_SIZE * sizeof(JournalBlock));
+        assert(WRITER_BLOCKS);
+    }
+    WRITER_BLOCK.size = WRITER_OFFSET - WRITER_BLOCK.offset;
+    WRITER_BLOCKS[WRITER_BLOCKS_LEN++] = WRITER_BLOCK;
+    WRITER_BLOCK_ENTRIES = 0;
+}
+
+int startWriter()
+{
+    int rv = 0;
+    JournalBlock block = { 0 };
+
+    SEEK_PATH = getSeekPath(SEGMENT_PATH);
+    if ((rv = openLogFd()) != 0) {
+        objectRelease(&SEEK_PATH);
+        return rv;
+    }
+    /* The queued entries are appended from here */
+    if ((WRITER_OFFSET = lseek(LOG_FD, 0, SEEK_END)) == -1) {
+        rv = errno;
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "startWriter", rv,
+                 strerror(rv), "Unable to get the '%s' file offset", SEGMENT_PATH);
+        closeLogFd();
+        objectRelease(&SEEK_PATH);
+        return rv;
+    }
+    WRITER_BLOCK_ENTRIES = 0;
+    /* The time order goes on from the last block of the segment */
+    WRITER_MAX_REALTIME = 0;
+    WRITER_UNSORTED = false;
+    if (getLastJournalBlock(SEGMENT_PATH, &block) == 0) {
+        WRITER_MAX_REALTIME = block.maxRealtime;
+        WRITER_UNSORTED = block.flags & JOURNAL_BLOCK_UNSORTED;
+    }
+    WRITER_BUFFER_SIZE = FLUSH_BUFFER_SIZE = WRITER_BUFFER_MAX;
+    WRITER_BUFFER = calloc(WRITER_BUFFER_SIZE, sizeof(char));
+    assert(WRITER_BUFFER);
+    FLUSH_BUFFER = calloc(FLUSH_BUFFER_SIZE, sizeof(char));
+    assert(FLUSH_BUFFER);
+    WRITER_BLOCKS_SIZE = FLUSH_BLOCKS_SIZE = WRITER_BLOCKS_MAX;
+    WRITER_BLOCKS = calloc(WRITER_BLOCKS_SIZE, sizeof(JournalBlock));
+    assert(WRITER_BLOCKS);
+    FLUSH_BLOCKS = calloc(FLUSH_BLOCKS_SIZE, sizeof(JournalBlock));
+    assert(FLUSH_BLOCKS);
+    WRITER_EXIT = WRITER_SUSPENDED = WRITER_BUSY = WRITER_REOPEN = WRITER_HOST_WRITTEN = false;
+    if ((rv = startControl()) != 0) {
+        releaseControl();
+        releaseBuffers();
+        closeLogFd();
+        return rv;
+    }
+    if ((rv = pthread_create(&WRITER_THREAD, NULL, startWriterThread, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "startWriter", rv,
+                 strerror(rv), "Unable to create the writer thread");
+        stopControl();
+        releaseBuffers();
+        closeLogFd();
+        return rv;
+    }
+    WRITER_STARTED = true;
+    if (DEBUG)
+        logInfo(CONSOLE, "Writer started (flush interval = %d ms, sync = %s)\n",
+                WRITER_FLUSH_INTERVAL, WRITER_SYNC_NAMES[WRITER_SYNC]);
+
+    return rv;
+}
+
+/* Write the remaining lines and close the log file */
+int stopWriter()
+{
+    int rv = 0;
+
+    if (!WRITER_STARTED)
+        return rv;
+    stopControl();
+    pthread_mutex_lock(&WRITER_MUTEX);
+    /* The last block is written with the remaining entries */
+    if (WRITER_BLOCK_ENTRIES > 0)
+        closeBlock();
+    WRITER_EXIT = true;
+    WRITER_STARTED = false;
+    pthread_cond_broadcast(&WRITER_CV);
+    pthread_mutex_unlock(&WRITER_MUTEX);
+    if ((rv = pthread_join(WRITER_THREAD, NULL)) != 0) {
+        logError(CONSOLE | SYSTEM, "src/unitlogd/writer/writer.c", "stopWriter", rv,
+                 strerror(rv), "Unable to join the writer thread");
+    }
+    releaseBuffers();
+    closeLogFd();
+
+    return rv;
+}
+
+/* Encodes the entry into the writer buffer.
+ * A host entry is encoded before it when the host name changes or a block starts.
+ * Returns false if the writer is not running (i.e. kernel forwarder only).
+*/
+bool queueJournalEntry(JournalEntry *entry, const char *hostName)
+{
+    bool queued = false;
+    JournalEntry hostEntry = { 0 };
+    size_t size = 0;
+
+    assert(entry);
+    assert(hostName);
+
+    pthread_mutex_lock(&WRITER_MUTEX);
+    if (WRITER_STARTED) {
+        size = getJournalEntrySize(entry);
+        if (WRITER_BLOCK_ENTRIES >= JOURNAL_BLOCK_ENTRIES ||
+            WRITER_OFFSET - (off_t)WRITER_BLOCK.offset >= JOURNAL_BLOCK_BYTES)
+            closeBlock();
+        /* The block starts with the host entry */
+        if (WRITER_BLOCK_ENTRIES == 0) {
+            journalBlockInit(&WRITER_BLOCK, entry->realtime, WRITER_OFFSET);
+            WRITER_HOST_WRITTEN = false;
+        }
+        /* The clock stepped backwards */
+        if (entry->realtime < WRITER_MAX_REALTIME)
+            WRITER_UNSORTED = true;
+        else
+            WRITER_MAX_REALTIME = entry->realtime;
+        if (WRITER_UNSORTED)
+            WRITER_BLOCK.flags |= JOURNAL_BLOCK_UNSORTED;
+        if (!WRITER_HOST_WRITTEN || entry->hostId != WRITER_HOST_ID) {
+            hostEntry.type = JOURNAL_HOST;
+            hostEntry.realtime = entry->realtime;
+            hostEntry.monotonic = entry->monotonic;
+            hostEntry.hostId = entry->hostId;
+            hostEntry.data = hostName;
+            hostEntry.dataLen = strlen(hostName);
+            size += getJournalEntrySize(&hostEntry);
+        }
+        if (WRITER_BUFFER_LEN + size > WRITER_BUFFER_SIZE) {
+            WRITER_BUFFER_SIZE = (WRITER_BUFFER_LEN + size) * 2;
+            WRITER_BUFFER = realloc(WRITER_BUFFER, WRITER_BUFFER_SIZE);
+            assert(WRITER_BUFFER);
+        }
+        if (hostEntry.type == JOURNAL_HOST) {
+            WRITER_BUFFER_LEN += journalEncode(WRITER_BUFFER + WRITER_BUFFER_LEN, &hostEntry);
+            WRITER_HOST_ID = entry->hostId;
+            WRITER_HOST_WRITTEN = true;
+        }
+        WRITER_BUFFER_LEN += journalEncode(WRITER_BUFFER + WRITER_BUFFER_LEN, entry);
+        WRITER_OFFSET += size;
+        journalBlockAdd(&WRITER_BLOCK, entry);
+        WRITER_BLOCK_ENTRIES++;
+        if (WRITER_SYNC == SYNC_ERROR && entry->priority <= LOG_ERR)
+            WRITER_SYNC_PENDING = true;
+        /* Wake up the writer when it waits for the first entry or the buffer is full */
+        if (WRITER_BUFFER_LEN == size || WRITER_BUFFER_LEN >= WRITER_BUFFER_MAX)
+            pthread_cond_broadcast(&WRITER_CV);
+        queued = true;
+    }
+    pthread_mutex_unlock(&WRITER_MUTEX);
+
+    return queued;
+}
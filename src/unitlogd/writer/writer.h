@@ -0,0 +1,28 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#define WRITER_BUFFER_MAX 262144
+#define WRITER_BLOCKS_MAX 64
+#define WRITER_SUSPEND 'S'
+#define UNITLOGD_CTL_NAME "/run/unitlogd.sock"
+
+typedef enum { SYNC_NEVER = 0, SYNC_ERROR = 1, SYNC_ALWAYS = 2 } WriterSync;
+
+extern int WRITER_FLUSH_INTERVAL;
+extern WriterSync WRITER_SYNC;
+extern const char *WRITER_CTL_PATH;
+
+int getWriterSync(const char *);
+int startWriter();
+int stopWriter();
+bool queueJournalEntry(JournalEntry *, const char *);
+
+#endif // WRITER_H
@@ -0,0 +1,96 @@
+/*
+(C) 2022 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../src/unitlogd/unitlogd_impl.h"
+
+/* LOG LINE BENCHMARK
+
+It feeds processLine() with the datagrams of the log socket and the writer thread writes the
+entries into a temporary segment. It prints the lines per second and, with
+LD_PRELOAD=libmalloc_counter.so (see tests/malloc_counter.c), the allocations per line of the
+socket thread (the writer thread is not counted).
+Usage: bench_logline [lines]
+
+*/
+
+#define BENCH_LINES 1000000
+#define BENCH_DATAGRAM "<38>Oct 19 12:00:00 sshd[1234]: Accepted publickey for user from " \
+                       "192.168.1.10 port 52314 ssh2: ED25519 SHA256:bench"
+
+unsigned long mallocCount() __attribute__((weak));
+
+static int createBenchFile(const char *path)
+{
+    int fd = -1;
+
+    if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)) == -1) {
+        fprintf(stderr, "Unable to create '%s': %s\n", path, strerror(errno));
+        return errno;
+    }
+    close(fd);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int rv = 0;
+    long lines = argc > 1 ? atol(argv[1]) : BENCH_LINES;
+    char tmpDir[] = "/tmp/unitlogd-bench-XXXXXX", datagram[] = BENCH_DATAGRAM,
+         buffer[sizeof(datagram)];
+    char *seekPath = NULL, *ctlPath = NULL;
+    unsigned long mallocs = 0;
+    struct timespec start = { 0 }, stop = { 0 };
+    double seconds = 0;
+    LogLine *logLine = NULL;
+
+    if (lines <= 0 || !mkdtemp(tmpDir)) {
+        fprintf(stderr, "Usage: bench_logline [lines]\n");
+        return EXIT_FAILURE;
+    }
+    SEGMENT_PATH = stringNew(tmpDir);
+    stringAppendStr(&SEGMENT_PATH, "/" SEGMENT_PREFIX "0000000000-bench" SEGMENT_SUFFIX);
+    seekPath = getSeekPath(SEGMENT_PATH);
+    ctlPath = stringNew(tmpDir);
+    stringAppendStr(&ctlPath, "/ctl.sock");
+    WRITER_CTL_PATH = ctlPath;
+    WRITER_SYNC = SYNC_NEVER;
+    if ((rv = createBenchFile(SEGMENT_PATH)) != 0 || (rv = createBenchFile(seekPath)) != 0 ||
+        (rv = startWriter()) != 0)
+        goto out;
+    logLine = logLineNew();
+    if (mallocCount)
+        mallocs = mallocCount();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < lines; i++) {
+        /* processLine() parses the datagram in place */
+        memcpy(buffer, datagram, sizeof(datagram));
+        processLine(logLine, buffer);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    if (mallocCount)
+        mallocs = mallocCount() - mallocs;
+    rv = stopWriter();
+    seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%ld lines in %.3f s, %.0f lines/s, %ld bytes written\n", lines, seconds,
+           lines / seconds, getFileSize(SEGMENT_PATH));
+    if (mallocCount)
+        printf("%lu mallocs, %.4f mallocs/line\n", mallocs, (double)mallocs / lines);
+    else
+        printf("mallocs/line: run with LD_PRELOAD=libmalloc_counter.so\n");
+
+out:
+    logLineRelease(&logLine);
+    unlink(SEGMENT_PATH);
+    unlink(seekPath);
+    rmdir(tmpDir);
+    objectRelease(&SEGMENT_PATH);
+    objectRelease(&seekPath);
+    objectRelease(&ctlPath);
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
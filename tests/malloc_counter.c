@@ -0,0 +1,46 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+/* MALLOC COUNTER
+
+It counts the malloc, calloc and realloc calls of each thread.
+Unitd in debug mode (unitd_debug=true) logs the calls of each socket request when it runs with
+LD_PRELOAD=libmalloc_counter.so (see socketDispatchRequest()).
+
+*/
+
+#include <stddef.h>
+
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+
+static __thread unsigned long MALLOC_COUNT __attribute__((tls_model("initial-exec")));
+
+void *malloc(size_t size)
+{
+    MALLOC_COUNT++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    MALLOC_COUNT++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    MALLOC_COUNT++;
+    return __libc_realloc(ptr, size);
+}
+
+unsigned long mallocCount()
+{
+    return MALLOC_COUNT;
+}
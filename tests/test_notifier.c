@@ -0,0 +1,155 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../src/core/unitd_impl.h"
+
+#define TEST_EVENT_BUF_LEN (64 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+#define TEST_ENTRIES 1000
+
+/* A file is moved over an existing entry of a PathDirectoryNotEmpty folder and then it is
+ * removed. The folder is empty thus the unit must not be triggered by the removal.
+*/
+static int testRenameOverEntry(const char *tmpDir)
+{
+    int rv = 0, fd = -1, wd = -1;
+    ssize_t len = 0;
+    char buffer[TEST_EVENT_BUF_LEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+    char *watchedPath = NULL, *entryPath = NULL, *outsidePath = NULL;
+    struct inotify_event *event = NULL;
+    Notifier *notifier = notifierNew();
+    Watcher *watcher = NULL;
+    Unit unit = { 0 };
+    bool triggered = false;
+
+    watchedPath = stringNew(tmpDir);
+    stringAppendStr(&watchedPath, "/watched");
+    entryPath = stringNew(watchedPath);
+    stringAppendStr(&entryPath, "/entry");
+    outsidePath = stringNew(tmpDir);
+    stringAppendStr(&outsidePath, "/entry");
+    unit.name = "test.upath";
+    watcher = watcherNew(notifier, watchedPath, PATH_DIRECTORY_NOT_EMPTY_WATCHER);
+    watcher->unit = &unit;
+    if (mkdir(watchedPath, 0700) == -1 || (fd = inotify_init1(IN_CLOEXEC)) == -1 ||
+        (wd = inotify_add_watch(fd, watchedPath, watcher->watcherData.mask)) == -1) {
+        rv = errno;
+        fprintf(stderr, "Unable to watch '%s': %s\n", watchedPath, strerror(rv));
+        goto out;
+    }
+    if (close(open(entryPath, O_WRONLY | O_CREAT, 0600)) == -1 ||
+        close(open(outsidePath, O_WRONLY | O_CREAT, 0600)) == -1 ||
+        rename(outsidePath, entryPath) == -1 || unlink(entryPath) == -1) {
+        rv = errno;
+        fprintf(stderr, "Unable to handle '%s': %s\n", entryPath, strerror(rv));
+        goto out;
+    }
+    if ((len = read(fd, buffer, TEST_EVENT_BUF_LEN)) <= 0) {
+        rv = errno;
+        fprintf(stderr, "Unable to read the inotify events: %s\n", strerror(rv));
+        goto out;
+    }
+    for (char *ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + event->len) {
+        event = (struct inotify_event *)ptr;
+        if (!(event->mask & watcher->watcherData.mask))
+            continue;
+        updateWatcherEntries(watcher, event);
+        if (event->len)
+            triggered = isUnitTriggered(watcher, event);
+    }
+    if (watcher->entries->count != 0 || triggered) {
+        rv = 1;
+        fprintf(stderr, "testRenameOverEntry: %d entries found, triggered = %d\n",
+                watcher->entries->count, triggered);
+    }
+
+out:
+    if (fd != -1)
+        close(fd);
+    rmdir(watchedPath);
+    watcherRelease(&watcher);
+    notifierRelease(&notifier);
+    objectRelease(&watchedPath);
+    objectRelease(&entryPath);
+    objectRelease(&outsidePath);
+    return rv;
+}
+
+/* The entries are counted across the resizes of the set */
+static int testManyEntries(const char *tmpDir)
+{
+    int rv = 0, fd = -1, wd = -1, numEntries = TEST_ENTRIES;
+    ssize_t len = 0;
+    char buffer[TEST_EVENT_BUF_LEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+    char *watchedPath = NULL, entryPath[PATH_MAX] = { 0 };
+    struct inotify_event *event = NULL;
+    Notifier *notifier = notifierNew();
+    Watcher *watcher = NULL;
+    Unit unit = { 0 };
+
+    watchedPath = stringNew(tmpDir);
+    stringAppendStr(&watchedPath, "/many");
+    unit.name = "test.upath";
+    watcher = watcherNew(notifier, watchedPath, PATH_DIRECTORY_NOT_EMPTY_WATCHER);
+    watcher->unit = &unit;
+    if (mkdir(watchedPath, 0700) == -1 || (fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) == -1 ||
+        (wd = inotify_add_watch(fd, watchedPath, watcher->watcherData.mask)) == -1) {
+        rv = errno;
+        fprintf(stderr, "Unable to watch '%s': %s\n", watchedPath, strerror(rv));
+        goto out;
+    }
+    for (int i = 0; i < TEST_ENTRIES && rv == 0; i++) {
+        snprintf(entryPath, PATH_MAX, "%s/entry-%d", watchedPath, i);
+        if (close(open(entryPath, O_WRONLY | O_CREAT, 0600)) == -1 ||
+            (i % 2 == 0 && unlink(entryPath) == -1))
+            rv = errno;
+        else if (i % 2 == 0)
+            numEntries--;
+    }
+    while (rv == 0 && (len = read(fd, buffer, TEST_EVENT_BUF_LEN)) > 0) {
+        for (char *ptr = buffer; ptr < buffer + len;
+             ptr += sizeof(struct inotify_event) + event->len) {
+            event = (struct inotify_event *)ptr;
+            if (event->mask & watcher->watcherData.mask)
+                updateWatcherEntries(watcher, event);
+        }
+    }
+    if (rv == 0 && watcher->entries->count != numEntries) {
+        rv = 1;
+        fprintf(stderr, "testManyEntries: %d entries found, %d expected\n",
+                watcher->entries->count, numEntries);
+    }
+
+out:
+    if (fd != -1)
+        close(fd);
+    for (int i = 1; i < TEST_ENTRIES; i += 2) {
+        snprintf(entryPath, PATH_MAX, "%s/entry-%d", watchedPath, i);
+        unlink(entryPath);
+    }
+    rmdir(watchedPath);
+    watcherRelease(&watcher);
+    notifierRelease(&notifier);
+    objectRelease(&watchedPath);
+    return rv;
+}
+
+int main()
+{
+    int rv = 0;
+    char tmpDir[] = "/tmp/unitd-test-XXXXXX";
+
+    if (!mkdtemp(tmpDir)) {
+        fprintf(stderr, "Unable to create the temporary folder: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if ((rv = testRenameOverEntry(tmpDir)) == 0)
+        rv = testManyEntries(tmpDir);
+    rmdir(tmpDir);
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}